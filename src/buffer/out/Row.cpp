@@ -68,31 +68,57 @@ constexpr OutIt copy_n_small(InIt first, Diff count, OutIt dest)
 // Routine Description:
 // - constructor
 // Arguments:
+// - charsBuffer - the backing buffer for _charsBuffer
+// - charOffsetsBuffer - the zero-initialized backing buffer for _charOffsets
 // - rowWidth - the width of the row, cell elements
 // - fillAttribute - the default text attribute
+// - attrTable - the table of the owning TextBuffer, which interns our attributes
+// - charsPool - the pool of the owning TextBuffer, which serves our overflow characters
 // Return Value:
 // - constructed object
-ROW::ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, const TextAttribute& fillAttribute) :
+ROW::ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, const TextAttribute& fillAttribute, TextAttributeTable* attrTable, RowCharsPool* charsPool) :
     _charsBuffer{ charsBuffer },
+    _charsPool{ charsPool },
     _chars{ charsBuffer, rowWidth },
     _charOffsets{ charOffsetsBuffer, ::base::strict_cast<size_t>(rowWidth) + 1u },
-    _attr{ rowWidth, fillAttribute },
+    _attr{ rowWidth, attrTable->Acquire(fillAttribute, rowWidth) },
+    _attrTable{ attrTable },
     _columnCount{ rowWidth }
 {
-    if (_chars.data())
-    {
-        _init();
-    }
+    // The row starts out cleared (see _init()), which only requires _charOffsets[0] to be 0.
+    // TextBuffer gives us zeroed memory, so we don't write it here. This way the memory
+    // of rows that are never written to is never touched and never backed by physical memory.
+}
+
+ROW::~ROW()
+{
+    _releaseChars();
+    _releaseAttributes(0, _attr.size());
+}
+
+// Moving is implemented by swapping, so that the attribute references and the chars
+// of the row that's being overwritten are released by the moved-from row.
+ROW::ROW(ROW&& other) noexcept
+{
+    swap(*this, other);
+}
+
+ROW& ROW::operator=(ROW&& other) noexcept
+{
+    swap(*this, other);
+    return *this;
 }
 
 void swap(ROW& lhs, ROW& rhs) noexcept
 {
     std::swap(lhs._charsBuffer, rhs._charsBuffer);
-    std::swap(lhs._charsHeap, rhs._charsHeap);
+    std::swap(lhs._charsPool, rhs._charsPool);
     std::swap(lhs._chars, rhs._chars);
     std::swap(lhs._charOffsets, rhs._charOffsets);
     std::swap(lhs._attr, rhs._attr);
+    std::swap(lhs._attrTable, rhs._attrTable);
     std::swap(lhs._columnCount, rhs._columnCount);
+    std::swap(lhs._initializedEnd, rhs._initializedEnd);
     std::swap(lhs._lineRendition, rhs._lineRendition);
     std::swap(lhs._wrapForced, rhs._wrapForced);
     std::swap(lhs._doubleBytePadded, rhs._doubleBytePadded);
@@ -136,19 +162,85 @@ LineRendition ROW::GetLineRendition() const noexcept
 // - <none>
 void ROW::Reset(const TextAttribute& attr)
 {
-    _charsHeap.reset();
+    _releaseChars();
     _chars = { _charsBuffer, _columnCount };
-    _attr = { _columnCount, attr };
+    const auto index = _attrTable->Acquire(attr, _columnCount);
+    _releaseAttributes(0, _attr.size());
+    _attr = { _columnCount, index };
     _lineRendition = LineRendition::SingleWidth;
     _wrapForced = false;
     _doubleBytePadded = false;
     _init();
 }
 
+// Clears the row lazily: All columns are now logically whitespace,
+// but they'll only be written out once _initializeColumns() gets called.
 void ROW::_init() noexcept
 {
-    std::fill_n(_chars.begin(), _columnCount, UNICODE_SPACE);
-    std::iota(_charOffsets.begin(), _charOffsets.end(), uint16_t{ 0 });
+    til::at(_charOffsets, 0) = 0;
+    _initializedEnd = 0;
+}
+
+// Writes out the whitespace of all columns in [_initializedEnd, colEnd)
+// and makes _charOffsets valid up to and including colEnd.
+// Safety: colEnd must be [0, _columnCount].
+void ROW::_initializeColumns(const uint16_t colEnd) const noexcept
+{
+    if (colEnd <= _initializedEnd)
+    {
+        return;
+    }
+
+    // Since all columns past _initializedEnd are narrow whitespace, _charOffsets[_initializedEnd]
+    // is where the first of them starts and the remaining ones follow 1 character apart.
+    const uint16_t count = colEnd - _initializedEnd;
+    const auto chPos = _uncheckedCharOffset(_initializedEnd);
+    std::fill_n(_chars.begin() + chPos, count, UNICODE_SPACE);
+    iota_n(_charOffsets.begin() + _initializedEnd + 1, count, gsl::narrow_cast<uint16_t>(chPos + 1));
+    _initializedEnd = colEnd;
+}
+
+// Routine Description:
+// - Replaces the attributes of the columns [colBeg, colEnd) and updates
+//   the reference counts of the attribute table accordingly.
+void ROW::_replaceAttributes(const uint16_t colBeg, uint16_t colEnd, const TextAttribute& attr)
+{
+    // Validate the range like _attr.replace() does, before any counts are modified.
+    colEnd = std::min(colEnd, _attr.size());
+    THROW_HR_IF(E_INVALIDARG, colBeg > colEnd);
+    if (colBeg == colEnd)
+    {
+        return;
+    }
+
+    // Acquiring the new attributes before releasing the old ones avoids
+    // recycling the table entry in the common case that they're the same.
+    const auto index = _attrTable->Acquire(attr, gsl::narrow_cast<uint32_t>(colEnd - colBeg));
+    _releaseAttributes(colBeg, colEnd);
+    _attr.replace(colBeg, colEnd, index);
+}
+
+// Routine Description:
+// - Removes the references of the columns [colBeg, colEnd) from the attribute table.
+//   Must be called before the attributes of these columns are replaced.
+void ROW::_releaseAttributes(const uint16_t colBeg, const uint16_t colEnd) noexcept
+{
+    uint16_t runBeg = 0;
+    for (const auto& run : _attr.runs())
+    {
+        if (runBeg >= colEnd)
+        {
+            break;
+        }
+
+        const auto runEnd = gsl::narrow_cast<uint16_t>(runBeg + run.length);
+        if (runEnd > colBeg)
+        {
+            _attrTable->Release(run.value, gsl::narrow_cast<uint32_t>(std::min(runEnd, colEnd) - std::max(runBeg, colBeg)));
+        }
+
+        runBeg = runEnd;
+    }
 }
 
 // Routine Description:
@@ -164,69 +256,88 @@ void ROW::Resize(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t row
     // It can be detected by the lack of a _charsBuffer (among others).
     //
     // Otherwise, this block figures out how much we can copy into the new `rowWidth`.
+    // Only the columns [0, _initializedEnd) hold anything but whitespace, so the
+    // remaining ones don't need to be written out just to be copied over.
     uint16_t colsToCopy = 0;
     uint16_t charsToCopy = 0;
     if (_charsBuffer)
     {
-        colsToCopy = std::min(rowWidth, _columnCount);
-        // Safety: colsToCopy is [0, _columnCount].
+        colsToCopy = std::min(rowWidth, _initializedEnd);
+        // Safety: colsToCopy is [0, _initializedEnd].
         charsToCopy = _uncheckedCharOffset(colsToCopy);
-        // Safety: colsToCopy is [0, _columnCount] due to colsToCopy != 0.
+        // Safety: colsToCopy is [0, _initializedEnd] due to colsToCopy != 0.
         for (; colsToCopy != 0 && _uncheckedIsTrailer(colsToCopy); --colsToCopy)
         {
         }
     }
 
-    // If we grow the row width, we have to append a bunch of whitespace.
-    // `trailingWhitespace` stores that amount.
+    // Everything past colsToCopy is whitespace, which is written out lazily like after Reset(),
+    // but the new `_chars` array still needs to be large enough to hold it later on.
     // Safety: The preceding block left colsToCopy in the range [0, rowWidth].
     const uint16_t trailingWhitespace = rowWidth - colsToCopy;
 
     // Allocate memory for the new `_chars` array.
-    // Use the provided charsBuffer if possible, otherwise allocate a `_charsHeap`.
-    std::unique_ptr<wchar_t[]> charsHeap;
+    // Use the provided charsBuffer if possible, otherwise get one from the `_charsPool`.
     std::span chars{ charsBuffer, rowWidth };
     const std::span charOffsets{ charOffsetsBuffer, ::base::strict_cast<size_t>(rowWidth) + 1u };
     if (const uint16_t charsCapacity = charsToCopy + trailingWhitespace; charsCapacity > rowWidth)
     {
-        charsHeap = std::make_unique_for_overwrite<wchar_t[]>(charsCapacity);
-        chars = { charsHeap.get(), charsCapacity };
+        chars = _charsPool->Allocate(charsCapacity);
     }
 
-    // Copy chars and charOffsets over.
-    {
-        const auto it = std::copy_n(_chars.begin(), charsToCopy, chars.begin());
-        std::fill_n(it, trailingWhitespace, L' ');
-    }
-    {
-        const auto it = std::copy_n(_charOffsets.begin(), colsToCopy, charOffsets.begin());
-        // The _charOffsets array is 1 wider than newWidth indicates.
-        // This is because the extra column contains the past-the-end index into _chars.
-        iota_n(it, trailingWhitespace + 1u, charsToCopy);
-    }
+    // Copy chars and charOffsets over. _charOffsets[colsToCopy] is the past-the-end index
+    // of the copied chars and the position at which _initializeColumns() continues later.
+    std::copy_n(_chars.begin(), charsToCopy, chars.begin());
+    std::copy_n(_charOffsets.begin(), colsToCopy, charOffsets.begin());
+    til::at(charOffsets, colsToCopy) = charsToCopy;
 
+    _releaseChars();
     _charsBuffer = charsBuffer;
-    _charsHeap = std::move(charsHeap);
     _chars = chars;
     _charOffsets = charOffsets;
     _columnCount = rowWidth;
+    _initializedEnd = colsToCopy;
 
     // .resize_trailing_extent() doesn't work if the vector is empty,
     // since there's no trailing item that could be extended.
     if (_attr.empty())
     {
-        _attr = { rowWidth, fillAttribute };
+        _attr = { rowWidth, _attrTable->Acquire(fillAttribute, rowWidth) };
     }
     else
     {
+        // Only the columns that are cut off or added change their references.
+        if (const auto oldWidth = _attr.size(); rowWidth < oldWidth)
+        {
+            _releaseAttributes(rowWidth, oldWidth);
+        }
+        else
+        {
+            _attrTable->Retain(_attr.runs().back().value, gsl::narrow_cast<uint32_t>(rowWidth - oldWidth));
+        }
         _attr.resize_trailing_extent(rowWidth);
     }
 }
 
-void ROW::TransferAttributes(const til::small_rle<TextAttribute, uint16_t, 1>& attr, til::CoordType newWidth)
+// Routine Description:
+// - Copies the attributes of another row, which may belong to a different TextBuffer.
+// Arguments:
+// - source - the row to copy the attributes of
+// - newWidth - the width of this row; the attributes are cut off or their last run extended to fit
+void ROW::TransferAttributes(const ROW& source, til::CoordType newWidth)
 {
-    _attr = attr;
-    _attr.resize_trailing_extent(gsl::narrow<uint16_t>(newWidth));
+    auto attr = source._attr;
+    attr.resize_trailing_extent(gsl::narrow<uint16_t>(newWidth));
+
+    // The indices of the source refer to its own table. Translate them into ours.
+    decltype(attr)::container runs;
+    for (const auto& run : attr.runs())
+    {
+        runs.emplace_back(_attrTable->Acquire(source._attrTable->at(run.value), run.length), run.length);
+    }
+
+    _releaseAttributes(0, _attr.size());
+    _attr = decltype(_attr)(std::move(runs));
 }
 
 // Routine Description:
@@ -278,7 +389,7 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
             {
                 // Otherwise, commit this color into the run and save off the new one.
                 // Now commit the new color runs into the attr row.
-                _attr.replace(colorStarts, currentIndex, currentColor);
+                _replaceAttributes(colorStarts, currentIndex, currentColor);
                 currentColor = it->TextAttr();
                 colorUses = 1;
                 colorStarts = currentIndex;
@@ -354,7 +465,7 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
     // Now commit the final color into the attr row
     if (colorUses)
     {
-        _attr.replace(colorStarts, currentIndex, currentColor);
+        _replaceAttributes(colorStarts, currentIndex, currentColor);
     }
 
     return it;
@@ -362,13 +473,13 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
 
 bool ROW::SetAttrToEnd(const til::CoordType columnBegin, const TextAttribute attr)
 {
-    _attr.replace(_clampedColumnInclusive(columnBegin), _attr.size(), attr);
+    _replaceAttributes(_clampedColumnInclusive(columnBegin), _attr.size(), attr);
     return true;
 }
 
 void ROW::ReplaceAttributes(const til::CoordType beginIndex, const til::CoordType endIndex, const TextAttribute& newAttr)
 {
-    _attr.replace(_clampedColumnInclusive(beginIndex), _clampedColumnInclusive(endIndex), newAttr);
+    _replaceAttributes(_clampedColumnInclusive(beginIndex), _clampedColumnInclusive(endIndex), newAttr);
 }
 
 void ROW::ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, const std::wstring_view& chars)
@@ -381,6 +492,8 @@ void ROW::ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, co
         return;
     }
 
+    _initializeColumns(colEnd);
+
     // Safety:
     // * colBeg is now [0, _columnCount)
     // * colEnd is now (colBeg, _columnCount]
@@ -458,12 +571,181 @@ void ROW::ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, co
     }
 }
 
+// Routine Description:
+// - Writes a run of CHAR_INFOs into this row, starting at columnBegin.
+// - This is the bulk equivalent of WriteCells() for CHAR_INFOs that have neither
+//   COMMON_LVB_LEADING_BYTE nor COMMON_LVB_TRAILING_BYTE set, which is what almost
+//   every WriteConsoleOutput call consists of. Each CHAR_INFO becomes a narrow glyph
+//   and the attributes are committed one run at a time instead of one cell at a time.
+// Arguments:
+// - columnBegin - The first column to write to.
+// - charInfos - The cells to write. Anything past the end of the row is ignored.
+// Return Value:
+// - <none>
+void ROW::WriteNarrowCharInfos(const til::CoordType columnBegin, const std::span<const CHAR_INFO> charInfos)
+{
+    const auto colBeg = _clampedColumnInclusive(columnBegin);
+    const auto colEnd = _clampedColumnInclusive(static_cast<size_t>(colBeg) + charInfos.size());
+
+    if (colBeg >= colEnd)
+    {
+        return;
+    }
+
+    auto it = _replaceWithNarrowChars(colBeg, colEnd).begin();
+    for (const auto& charInfo : charInfos.first(colEnd - colBeg))
+    {
+        *it++ = charInfo.Char.UnicodeChar;
+    }
+
+    auto runBeg = colBeg;
+    auto runAttributes = charInfos.front().Attributes;
+    for (uint16_t col = colBeg + 1; col < colEnd; ++col)
+    {
+        const auto attributes = til::at(charInfos, col - colBeg).Attributes;
+        if (attributes != runAttributes)
+        {
+            _replaceAttributes(runBeg, col, TextAttribute{ runAttributes });
+            runBeg = col;
+            runAttributes = attributes;
+        }
+    }
+    _replaceAttributes(runBeg, colEnd, TextAttribute{ runAttributes });
+}
+
+// Routine Description:
+// - Fills the columns [columnBegin, columnEnd) with copies of a narrow character.
+// - This is the bulk equivalent of calling WriteCells() with a fill iterator for a character
+//   that isn't full width. Unlike WriteCells() it leaves the attributes untouched.
+// Arguments:
+// - columnBegin - The first column to fill.
+// - columnEnd - The column past the last one to fill. It's clamped to the width of the row.
+// - ch - The character to fill with.
+// Return Value:
+// - <none>
+void ROW::FillNarrowCharacters(const til::CoordType columnBegin, const til::CoordType columnEnd, const wchar_t ch)
+{
+    const auto colBeg = _clampedColumnInclusive(columnBegin);
+    const auto colEnd = _clampedColumnInclusive(columnEnd);
+
+    if (colBeg >= colEnd)
+    {
+        return;
+    }
+
+    const auto chars = _replaceWithNarrowChars(colBeg, colEnd);
+    std::fill(chars.begin(), chars.end(), ch);
+}
+
+// Routine Description:
+// - Converts the cells of this row starting at columnBegin into CHAR_INFOs.
+// - The result is identical to calling CONSOLE_INFORMATION::AsCharInfo() for each cell, but
+//   narrow glyphs are copied straight out of _chars and the legacy attributes are only
+//   computed once per attribute run.
+// Arguments:
+// - columnBegin - The first column to read from.
+// - charInfos - Receives the cells. Anything past the end of the row is left untouched.
+// Return Value:
+// - <none>
+void ROW::ReadCharInfos(const til::CoordType columnBegin, const std::span<CHAR_INFO> charInfos) const
+{
+    const auto colBeg = _clampedColumnInclusive(columnBegin);
+    const auto colEnd = _clampedColumnInclusive(static_cast<size_t>(colBeg) + charInfos.size());
+
+    _initializeColumns(colEnd);
+
+    auto out = charInfos.begin();
+    for (auto col = colBeg; col < colEnd; ++col, ++out)
+    {
+        // A column holds a narrow, single wchar_t glyph if neither it nor the next column is
+        // a trailer and the next glyph starts right after it. Comparing the raw offsets
+        // (including the CharOffsetsTrailer bit) checks all of this at once.
+        const auto off = til::at(_charOffsets, col);
+        if (til::at(_charOffsets, col + 1u) == off + 1u)
+        {
+            out->Char.UnicodeChar = _uncheckedChar(off);
+            out->Attributes = 0;
+        }
+        else
+        {
+            const auto glyph = GlyphAt(col);
+            out->Char.UnicodeChar = glyph.size() == 1 ? glyph.front() : UNICODE_REPLACEMENT;
+            out->Attributes = GeneratePublicApiAttributeFormat(DbcsAttrAt(col));
+        }
+    }
+
+    size_t runBeg = 0;
+    for (const auto& run : _attr.runs())
+    {
+        const auto runEnd = runBeg + run.length;
+        if (runEnd > colBeg)
+        {
+            const auto beg = std::max<size_t>(runBeg, colBeg);
+            const auto end = std::min<size_t>(runEnd, colEnd);
+            const auto legacyAttributes = _attrTable->at(run.value).GetLegacyAttributes();
+            for (auto col = beg; col < end; ++col)
+            {
+                til::at(charInfos, col - colBeg).Attributes |= legacyAttributes;
+            }
+        }
+        if (runEnd >= colEnd)
+        {
+            break;
+        }
+        runBeg = runEnd;
+    }
+}
+
+// Prepares the columns [colBeg, colEnd) to hold exactly 1 narrow character each and returns
+// the part of _chars that these characters need to be written to. This works just like
+// ReplaceCharacters() except that every column gets its own glyph: Wide glyphs that we
+// partially overwrite at either end are replaced with whitespace.
+// Safety: colBeg must be [0, _columnCount) and colEnd must be (colBeg, _columnCount].
+std::span<wchar_t> ROW::_replaceWithNarrowChars(const uint16_t colBeg, const uint16_t colEnd)
+{
+    _initializeColumns(colEnd);
+
+    uint16_t colExtBeg = colBeg;
+    const uint16_t chExtBeg = _uncheckedCharOffset(colExtBeg);
+    for (; colExtBeg != 0 && _uncheckedIsTrailer(colExtBeg); --colExtBeg)
+    {
+    }
+
+    uint16_t colExtEnd = colEnd;
+    for (; _uncheckedIsTrailer(colExtEnd); ++colExtEnd)
+    {
+    }
+    const uint16_t chExtEnd = _uncheckedCharOffset(colExtEnd);
+
+    const uint16_t count = colEnd - colBeg;
+    const uint16_t leadingSpaces = colBeg - colExtBeg;
+    const uint16_t trailingSpaces = colExtEnd - colEnd;
+    const size_t chExtEndNew = count + leadingSpaces + trailingSpaces + chExtBeg;
+
+    if (chExtEndNew != chExtEnd)
+    {
+        _resizeChars(colExtEnd, chExtBeg, chExtEnd, chExtEndNew);
+    }
+
+    fill_n_small(_chars.begin() + chExtBeg, leadingSpaces, L' ');
+    fill_n_small(_chars.begin() + chExtBeg + leadingSpaces + count, trailingSpaces, L' ');
+
+    // Every column in [colExtBeg, colExtEnd) now holds exactly 1 character.
+    auto chPos = chExtBeg;
+    iota_n_mut(_charOffsets.begin() + colExtBeg, colExtEnd - colExtBeg, chPos);
+
+    return _chars.subspan(chExtBeg + leadingSpaces, count);
+}
+
 // This function represents the slow path of ReplaceCharacters(),
 // as it reallocates the backing buffer and shifts the char offsets.
 // The parameters are difficult to explain, but their names are identical to
 // local variables in ReplaceCharacters() which I've attempted to document there.
 void ROW::_resizeChars(uint16_t colExtEnd, uint16_t chExtBeg, uint16_t chExtEnd, size_t chExtEndNew)
 {
+    // The trailing characters get shifted around below, which requires us to know where they end.
+    _initializeColumns(_columnCount);
+
     const auto diff = chExtEndNew - chExtEnd;
     const auto currentLength = _charSize();
     const auto newLength = currentLength + diff;
@@ -477,13 +759,12 @@ void ROW::_resizeChars(uint16_t colExtEnd, uint16_t chExtBeg, uint16_t chExtEnd,
         const auto minCapacity = std::min<size_t>(UINT16_MAX, _chars.size() + (_chars.size() >> 1));
         const auto newCapacity = gsl::narrow<uint16_t>(std::max(newLength, minCapacity));
 
-        auto charsHeap = std::make_unique_for_overwrite<wchar_t[]>(newCapacity);
-        const std::span chars{ charsHeap.get(), newCapacity };
+        const auto chars = _charsPool->Allocate(newCapacity);
 
         std::copy_n(_chars.begin(), chExtBeg, chars.begin());
         std::copy_n(_chars.begin() + chExtEnd, currentLength - chExtEnd, chars.begin() + chExtEndNew);
 
-        _charsHeap = std::move(charsHeap);
+        _releaseChars();
         _chars = chars;
     }
 
@@ -495,14 +776,18 @@ void ROW::_resizeChars(uint16_t colExtEnd, uint16_t chExtBeg, uint16_t chExtEnd,
     }
 }
 
-const til::small_rle<TextAttribute, uint16_t, 1>& ROW::Attributes() const noexcept
+// Returns _chars to the _charsPool, if it came from there.
+void ROW::_releaseChars() noexcept
 {
-    return _attr;
+    if (_chars.data() != _charsBuffer)
+    {
+        _charsPool->Free(_chars);
+    }
 }
 
 TextAttribute ROW::GetAttrByColumn(const til::CoordType column) const
 {
-    return _attr.at(_clampedUint16(column));
+    return _attrTable->at(_attr.at(_clampedUint16(column)));
 }
 
 std::vector<uint16_t> ROW::GetHyperlinks() const
@@ -510,9 +795,9 @@ std::vector<uint16_t> ROW::GetHyperlinks() const
     std::vector<uint16_t> ids;
     for (const auto& run : _attr.runs())
     {
-        if (run.value.IsHyperlink())
+        if (const auto& attr = _attrTable->at(run.value); attr.IsHyperlink())
         {
-            ids.emplace_back(run.value.GetHyperlinkId());
+            ids.emplace_back(attr.GetHyperlinkId());
         }
     }
     return ids;
@@ -523,9 +808,11 @@ uint16_t ROW::size() const noexcept
     return _columnCount;
 }
 
+// The Measure*() and ContainsText() functions below only look at the initialized columns,
+// because the ones past _initializedEnd are known to be whitespace.
 til::CoordType ROW::MeasureLeft() const noexcept
 {
-    const auto text = GetText();
+    const auto text = _initializedText();
     const auto beg = text.begin();
     const auto end = text.end();
     auto it = beg;
@@ -534,16 +821,16 @@ til::CoordType ROW::MeasureLeft() const noexcept
     {
         if (*it != L' ')
         {
-            break;
+            return gsl::narrow_cast<til::CoordType>(it - beg);
         }
     }
 
-    return gsl::narrow_cast<til::CoordType>(it - beg);
+    return gsl::narrow_cast<til::CoordType>(it - beg + (_columnCount - _initializedEnd));
 }
 
 til::CoordType ROW::MeasureRight() const noexcept
 {
-    const auto text = GetText();
+    const auto text = _initializedText();
     const auto beg = text.begin();
     const auto end = text.end();
     auto it = end;
@@ -562,12 +849,12 @@ til::CoordType ROW::MeasureRight() const noexcept
     //
     // An example: The row is 10 cells wide and `it` points to the second character.
     // `it - beg` would return 1, but it's possible it's actually 1 wide glyph and 8 whitespace.
-    return gsl::narrow_cast<til::CoordType>(_columnCount - (end - it));
+    return gsl::narrow_cast<til::CoordType>(_initializedEnd - (end - it));
 }
 
 bool ROW::ContainsText() const noexcept
 {
-    const auto text = GetText();
+    const auto text = _initializedText();
     const auto beg = text.begin();
     const auto end = text.end();
     auto it = beg;
@@ -586,6 +873,7 @@ bool ROW::ContainsText() const noexcept
 std::wstring_view ROW::GlyphAt(til::CoordType column) const noexcept
 {
     auto col = _clampedColumn(column);
+    _initializeColumns(gsl::narrow_cast<uint16_t>(col + 1));
 
     // Safety: col is [0, _columnCount).
     const auto beg = _uncheckedCharOffset(col);
@@ -603,6 +891,7 @@ std::wstring_view ROW::GlyphAt(til::CoordType column) const noexcept
 DbcsAttribute ROW::DbcsAttrAt(til::CoordType column) const noexcept
 {
     const auto col = _clampedColumn(column);
+    _initializeColumns(gsl::narrow_cast<uint16_t>(col + 1));
 
     auto attr = DbcsAttribute::Single;
     // Safety: col is [0, _columnCount).
@@ -621,12 +910,14 @@ DbcsAttribute ROW::DbcsAttrAt(til::CoordType column) const noexcept
 
 std::wstring_view ROW::GetText() const noexcept
 {
+    _initializeColumns(_columnCount);
     return { _chars.data(), _charSize() };
 }
 
 DelimiterClass ROW::DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept
 {
     const auto col = _clampedColumn(column);
+    _initializeColumns(gsl::narrow_cast<uint16_t>(col + 1));
     // Safety: col is [0, _columnCount).
     const auto glyph = _uncheckedChar(_uncheckedCharOffset(col));
 
@@ -668,6 +959,12 @@ wchar_t ROW::_uncheckedChar(size_t off) const noexcept
     return til::at(_chars, off);
 }
 
+// Returns the text of the columns [0, _initializedEnd), without initializing any more of them.
+std::wstring_view ROW::_initializedText() const noexcept
+{
+    return { _chars.data(), _uncheckedCharOffset(_initializedEnd) };
+}
+
 uint16_t ROW::_charSize() const noexcept
 {
     // Safety: _charOffsets is an array of `_columnCount + 1` entries.
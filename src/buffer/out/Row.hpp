@@ -27,6 +27,8 @@ Revision History:
 #include "LineRendition.hpp"
 #include "OutputCell.hpp"
 #include "OutputCellIterator.hpp"
+#include "RowCharsPool.hpp"
+#include "TextAttributeTable.hpp"
 
 class TextBuffer;
 
@@ -37,17 +39,87 @@ enum class DelimiterClass
     RegularChar
 };
 
+// Iterates over the TextAttribute of each column of a ROW. ROWs only store
+// indices into the TextAttributeTable of their TextBuffer, which this resolves.
+class RowAttributeIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = TextAttribute;
+    using difference_type = ptrdiff_t;
+    using pointer = const TextAttribute*;
+    using reference = const TextAttribute&;
+    using IndexIterator = til::small_rle<TextAttributeTable::Index, uint16_t, 1>::const_iterator;
+
+    RowAttributeIterator(IndexIterator it, const TextAttributeTable* table) noexcept :
+        _it{ it },
+        _table{ table }
+    {
+    }
+
+    reference operator*() const noexcept
+    {
+        return _table->at(*_it);
+    }
+
+    pointer operator->() const noexcept
+    {
+        return &operator*();
+    }
+
+    RowAttributeIterator& operator++() noexcept
+    {
+        ++_it;
+        return *this;
+    }
+
+    RowAttributeIterator operator++(int) noexcept
+    {
+        auto tmp = *this;
+        ++_it;
+        return tmp;
+    }
+
+    RowAttributeIterator& operator+=(const difference_type move) noexcept
+    {
+        _it += move;
+        return *this;
+    }
+
+    RowAttributeIterator operator+(const difference_type move) const noexcept
+    {
+        auto tmp = *this;
+        tmp += move;
+        return tmp;
+    }
+
+    bool operator==(const RowAttributeIterator& other) const noexcept
+    {
+        return _it == other._it;
+    }
+
+    bool operator!=(const RowAttributeIterator& other) const noexcept
+    {
+        return _it != other._it;
+    }
+
+private:
+    IndexIterator _it;
+    const TextAttributeTable* _table;
+};
+
 class ROW final
 {
 public:
     ROW() = default;
-    ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, const TextAttribute& fillAttribute);
+    ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, const TextAttribute& fillAttribute, TextAttributeTable* attrTable, RowCharsPool* charsPool);
+    ~ROW();
 
     ROW(const ROW& other) = delete;
     ROW& operator=(const ROW& other) = delete;
 
-    explicit ROW(ROW&& other) = default;
-    ROW& operator=(ROW&& other) = default;
+    explicit ROW(ROW&& other) noexcept;
+    ROW& operator=(ROW&& other) noexcept;
 
     friend void swap(ROW& lhs, ROW& rhs) noexcept;
 
@@ -60,15 +132,17 @@ public:
 
     void Reset(const TextAttribute& attr);
     void Resize(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, const TextAttribute& fillAttribute);
-    void TransferAttributes(const til::small_rle<TextAttribute, uint16_t, 1>& attr, til::CoordType newWidth);
+    void TransferAttributes(const ROW& source, til::CoordType newWidth);
 
     void ClearCell(til::CoordType column);
     OutputCellIterator WriteCells(OutputCellIterator it, til::CoordType columnBegin, std::optional<bool> wrap = std::nullopt, std::optional<til::CoordType> limitRight = std::nullopt);
     bool SetAttrToEnd(til::CoordType columnBegin, TextAttribute attr);
     void ReplaceAttributes(til::CoordType beginIndex, til::CoordType endIndex, const TextAttribute& newAttr);
     void ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, const std::wstring_view& chars);
+    void WriteNarrowCharInfos(til::CoordType columnBegin, std::span<const CHAR_INFO> charInfos);
+    void FillNarrowCharacters(til::CoordType columnBegin, til::CoordType columnEnd, wchar_t ch);
+    void ReadCharInfos(til::CoordType columnBegin, std::span<CHAR_INFO> charInfos) const;
 
-    const til::small_rle<TextAttribute, uint16_t, 1>& Attributes() const noexcept;
     TextAttribute GetAttrByColumn(til::CoordType column) const;
     std::vector<uint16_t> GetHyperlinks() const;
     uint16_t size() const noexcept;
@@ -80,8 +154,8 @@ public:
     std::wstring_view GetText() const noexcept;
     DelimiterClass DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept;
 
-    auto AttrBegin() const noexcept { return _attr.begin(); }
-    auto AttrEnd() const noexcept { return _attr.end(); }
+    RowAttributeIterator AttrBegin() const noexcept { return { _attr.begin(), _attrTable }; }
+    RowAttributeIterator AttrEnd() const noexcept { return { _attr.end(), _attrTable }; }
 
 #ifdef UNIT_TESTING
     friend constexpr bool operator==(const ROW& a, const ROW& b) noexcept;
@@ -104,17 +178,20 @@ private:
 
     wchar_t _uncheckedChar(size_t off) const noexcept;
     uint16_t _charSize() const noexcept;
+    std::wstring_view _initializedText() const noexcept;
     uint16_t _uncheckedCharOffset(size_t col) const noexcept;
     bool _uncheckedIsTrailer(size_t col) const noexcept;
 
     void _init() noexcept;
+    void _initializeColumns(uint16_t colEnd) const noexcept;
+    void _replaceAttributes(uint16_t colBeg, uint16_t colEnd, const TextAttribute& attr);
+    void _releaseAttributes(uint16_t colBeg, uint16_t colEnd) noexcept;
     void _resizeChars(uint16_t colExtEnd, uint16_t chExtBeg, uint16_t chExtEnd, size_t chExtEndNew);
+    void _releaseChars() noexcept;
+    std::span<wchar_t> _replaceWithNarrowChars(uint16_t colBeg, uint16_t colEnd);
 
     // These fields are a bit "wasteful", but it makes all this a bit more robust against
     // programming errors during initial development (which is when this comment was written).
-    // * _chars and _charsHeap are redundant
-    //   If _charsHeap is stored in _chars, we can still infer that
-    //   _chars was allocated on the heap if _chars != _charsBuffer.
     // * _chars doesn't need a size_t size()
     //   The size may never exceed an uint16_t anyways.
     // * _charOffsets doesn't need a size() at all
@@ -126,10 +203,11 @@ private:
     // _charsBuffer fits _columnCount characters at most.
     wchar_t* _charsBuffer = nullptr;
     // ...but if this ROW needs to store more than _columnCount characters
-    // then it will allocate a larger string on the heap and store it here.
-    // The capacity of this string on the heap is stored in _chars.size().
-    std::unique_ptr<wchar_t[]> _charsHeap;
-    // _chars either refers to our _charsBuffer or _charsHeap, defaulting to the former.
+    // then it will get a larger string from the TextBuffer's _charsPool instead.
+    // We can infer that this is the case if _chars.data() != _charsBuffer.
+    // Only null for default constructed rows.
+    RowCharsPool* _charsPool = nullptr;
+    // _chars either refers to our _charsBuffer or a buffer from _charsPool, defaulting to the former.
     // _chars.size() is NOT the length of the string, but rather its capacity.
     // _charOffsets[_columnCount] stores the length.
     std::span<wchar_t> _chars;
@@ -150,11 +228,26 @@ private:
     // In other words, _charOffsets tells us both the width in chars and width in columns.
     // See CharOffsetsTrailer for more information.
     std::span<uint16_t> _charOffsets;
-    // _attr is a run-length-encoded vector of TextAttribute with a decompressed
-    // length equal to _columnCount (= 1 TextAttribute per column).
-    til::small_rle<TextAttribute, uint16_t, 1> _attr;
+    // _attr is a run-length-encoded vector of indices into _attrTable with a decompressed
+    // length equal to _columnCount (= 1 TextAttribute per column). Each run is just 8 bytes
+    // and comparing attributes boils down to comparing their indices.
+    til::small_rle<TextAttributeTable::Index, uint16_t, 1> _attr;
+    // The attributes of all rows of a TextBuffer are interned in its TextAttributeTable.
+    // It's reference counted by the number of cells using each entry, which every
+    // modification of _attr keeps up to date. Only null for default constructed rows.
+    TextAttributeTable* _attrTable = nullptr;
     // The width of the row in visual columns.
     uint16_t _columnCount = 0;
+    // Reset() doesn't write the whitespace that a cleared row holds, since most rows that get
+    // recycled by IncrementCircularBuffer() are only partially written to before they scroll
+    // out again. Instead, the columns [_initializedEnd, _columnCount) are logically filled with
+    // narrow whitespace and only _charOffsets[0, _initializedEnd] is valid. Any access to
+    // those columns has to call _initializeColumns() first, which writes them out on demand.
+    // This is mutable, because reading the row may need to do so as well. As a consequence,
+    // even the const accessors (GlyphAt(), DbcsAttrAt(), DelimiterClassAt(), GetText(), etc.)
+    // write to the row. Reading it thus requires the same exclusive lock as writing does (the
+    // console lock or Terminal::LockForWriting()), as concurrent readers would race on these members.
+    mutable uint16_t _initializedEnd = 0;
     // Stores double-width/height (DECSWL/DECDWL/DECDHL) attributes.
     LineRendition _lineRendition = LineRendition::SingleWidth;
     // Occurs when the user runs out of text in a given row and we're forced to wrap the cursor to the next line
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "RowCharsPool.hpp"
+
+#include <bit>
+
+// Routine Description:
+// - Returns the index into _freeLists of the smallest size class that fits capacity.
+size_t RowCharsPool::_classIndex(const size_t capacity) noexcept
+{
+    const auto shift = std::max<size_t>(MinClassShift, std::bit_width(capacity - 1));
+    return std::min(shift, MaxClassShift) - MinClassShift;
+}
+
+// Routine Description:
+// - Returns a buffer with room for at least minCapacity characters. The returned
+//   span covers the whole size class, but never more than UINT16_MAX characters,
+//   and must be handed back to Free() unchanged.
+// Arguments:
+// - minCapacity - the number of characters needed, up to UINT16_MAX
+// Return Value:
+// - The buffer.
+std::span<wchar_t> RowCharsPool::Allocate(const size_t minCapacity)
+{
+    THROW_HR_IF(E_INVALIDARG, minCapacity > UINT16_MAX);
+
+    const auto index = _classIndex(minCapacity);
+    const auto capacity = size_t{ 1 } << (index + MinClassShift);
+    const auto size = std::min<size_t>(capacity, UINT16_MAX);
+    auto& freeList = til::at(_freeLists, index);
+
+    if (!freeList.empty())
+    {
+        const auto chars = freeList.back();
+        freeList.pop_back();
+        return { chars, size };
+    }
+
+    if (gsl::narrow_cast<size_t>(_slabEnd - _slabBeg) < capacity)
+    {
+        auto slab = std::make_unique_for_overwrite<wchar_t[]>(SlabCapacity);
+        _slabs.emplace_back(std::move(slab));
+        _retireSlabTail();
+        _slabBeg = _slabs.back().get();
+        _slabEnd = _slabBeg + SlabCapacity;
+    }
+
+    const auto chars = _slabBeg;
+    _slabBeg += capacity;
+    return { chars, size };
+}
+
+// Routine Description:
+// - Returns a buffer previously returned by Allocate() to its free list.
+void RowCharsPool::Free(const std::span<wchar_t> chars) noexcept
+{
+    if (!chars.data())
+    {
+        return;
+    }
+
+    try
+    {
+        til::at(_freeLists, _classIndex(chars.size())).emplace_back(chars.data());
+    }
+    CATCH_LOG();
+}
+
+// Routine Description:
+// - Hands the unused end of the current slab out to the free lists before we move
+//   on to a new slab. Everything carved out of a slab is a multiple of the smallest
+//   size class, so the remainder splits up into at most one block per class.
+void RowCharsPool::_retireSlabTail() noexcept
+{
+    for (auto shift = MaxClassShift; shift >= MinClassShift; --shift)
+    {
+        const auto capacity = size_t{ 1 } << shift;
+        if (gsl::narrow_cast<size_t>(_slabEnd - _slabBeg) >= capacity)
+        {
+            try
+            {
+                til::at(_freeLists, shift - MinClassShift).emplace_back(_slabBeg);
+                _slabBeg += capacity;
+            }
+            CATCH_LOG();
+        }
+    }
+}
+
+size_t RowCharsPool::SlabCount() const noexcept
+{
+    return _slabs.size();
+}
+
+size_t RowCharsPool::ReservedBytes() const noexcept
+{
+    return _slabs.size() * SlabCapacity * sizeof(wchar_t);
+}
@@ -0,0 +1,51 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- RowCharsPool.hpp
+
+Abstract:
+- Serves the heap buffers of ROWs that store more characters than they have columns
+  (surrogate pairs, combining marks, ZWJ sequences, ...).
+- Buffers are rounded up to a power of two and carved out of large slabs. Released
+  buffers are kept in a free list per size class, so that rows that get reused by
+  IncrementCircularBuffer() don't cause a heap allocation and free every time.
+- The slabs are only returned to the OS when the owning TextBuffer is destroyed.
+--*/
+
+#pragma once
+
+#include <array>
+#include <span>
+
+class RowCharsPool final
+{
+public:
+    RowCharsPool() = default;
+
+    RowCharsPool(const RowCharsPool&) = delete;
+    RowCharsPool& operator=(const RowCharsPool&) = delete;
+
+    std::span<wchar_t> Allocate(size_t minCapacity);
+    void Free(std::span<wchar_t> chars) noexcept;
+
+    size_t SlabCount() const noexcept;
+    size_t ReservedBytes() const noexcept;
+
+private:
+    // The smallest size class holds 64 characters and the largest 64Ki,
+    // which is more than a ROW can address with its uint16_t offsets.
+    static constexpr size_t MinClassShift = 6;
+    static constexpr size_t MaxClassShift = 16;
+    static constexpr size_t SlabCapacity = size_t{ 1 } << MaxClassShift;
+
+    static size_t _classIndex(size_t capacity) noexcept;
+    void _retireSlabTail() noexcept;
+
+    std::array<std::vector<wchar_t*>, MaxClassShift - MinClassShift + 1> _freeLists;
+    std::vector<std::unique_ptr<wchar_t[]>> _slabs;
+    // The part of the newest slab that hasn't been handed out yet.
+    wchar_t* _slabBeg = nullptr;
+    wchar_t* _slabEnd = nullptr;
+};
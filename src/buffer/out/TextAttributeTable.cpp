@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "TextAttributeTable.hpp"
+
+#include <til/hash.h>
+
+// Index 0 always refers to the default attributes and is never recycled.
+TextAttributeTable::TextAttributeTable()
+{
+    _entries.push_back({ TextAttribute{}, 1 });
+    _lookup.emplace(TextAttribute{}, Index{ 0 });
+}
+
+size_t TextAttributeTable::Hash::operator()(const TextAttribute& attr) const noexcept
+{
+    return til::hash(&attr, sizeof(attr));
+}
+
+// Routine Description:
+// - Returns the attributes stored at the given index.
+const TextAttribute& TextAttributeTable::at(const Index index) const noexcept
+{
+    return til::at(_entries, index).attr;
+}
+
+// Routine Description:
+// - Returns the index of the given attributes, adding them to the table if needed,
+//   and adds count references to them.
+// Arguments:
+// - attr - the attributes to intern
+// - count - the number of cells that will refer to the returned index
+// Return Value:
+// - The index of attr in this table.
+TextAttributeTable::Index TextAttributeTable::Acquire(const TextAttribute& attr, const uint32_t count)
+{
+    auto index = _lastIndex;
+
+    if (index == InvalidIndex || attr != _lastAttr)
+    {
+        if (const auto it = _lookup.find(attr); it != _lookup.end())
+        {
+            index = it->second;
+        }
+        else if (!count)
+        {
+            // There's no point in adding attributes nobody refers to. They'd never be released.
+            return 0;
+        }
+        else
+        {
+            // Allocate everything Retain() and Release() might need for this entry up front.
+            if (attr.IsHyperlink() && attr.GetHyperlinkId() >= _hyperlinkRefCounts.size())
+            {
+                _hyperlinkRefCounts.resize(attr.GetHyperlinkId() + 1u);
+            }
+            if (_freeIndices.empty())
+            {
+                // Every entry in use is referred to by at least one cell and a buffer has
+                // at most 65535*65535 cells, so this can't reach InvalidIndex.
+                _entries.push_back({ attr, 0 });
+                _freeIndices.reserve(_entries.capacity());
+                _freeIndices.push_back(gsl::narrow_cast<Index>(_entries.size() - 1));
+            }
+
+            index = _freeIndices.back();
+            _lookup.emplace(attr, index);
+            _freeIndices.pop_back();
+            til::at(_entries, index).attr = attr;
+        }
+
+        _lastAttr = attr;
+        _lastIndex = index;
+    }
+
+    Retain(index, count);
+    return index;
+}
+
+// Routine Description:
+// - Adds count references to the entry at the given index, which must be in use.
+void TextAttributeTable::Retain(const Index index, const uint32_t count) noexcept
+{
+    auto& entry = til::at(_entries, index);
+    entry.refCount += count;
+
+    if (entry.attr.IsHyperlink())
+    {
+        til::at(_hyperlinkRefCounts, entry.attr.GetHyperlinkId()) += count;
+    }
+}
+
+// Routine Description:
+// - Removes count references from the entry at the given index.
+//   The entry is recycled once nothing refers to it anymore.
+void TextAttributeTable::Release(const Index index, const uint32_t count) noexcept
+{
+    auto& entry = til::at(_entries, index);
+    entry.refCount -= count;
+
+    if (entry.attr.IsHyperlink())
+    {
+        til::at(_hyperlinkRefCounts, entry.attr.GetHyperlinkId()) -= count;
+    }
+
+    if (entry.refCount == 0)
+    {
+        // Erasing from an unordered_map doesn't throw and Acquire() reserved
+        // enough capacity for _freeIndices, so none of this actually throws.
+        _lookup.erase(entry.attr);
+        _freeIndices.push_back(index);
+
+        if (index == _lastIndex)
+        {
+            _lastIndex = InvalidIndex;
+        }
+    }
+}
+
+// Routine Description:
+// - Returns the number of cells referring to the given hyperlink ID.
+uint32_t TextAttributeTable::HyperlinkRefCount(const uint16_t hyperlinkId) const noexcept
+{
+    return hyperlinkId < _hyperlinkRefCounts.size() ? til::at(_hyperlinkRefCounts, hyperlinkId) : 0;
+}
+
+// Routine Description:
+// - Returns the number of attributes that are currently in use.
+size_t TextAttributeTable::size() const noexcept
+{
+    return _entries.size() - _freeIndices.size();
+}
@@ -0,0 +1,61 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- TextAttributeTable.hpp
+
+Abstract:
+- Interns the TextAttributes used by the rows of a TextBuffer, so that each row
+  only needs to store 32-bit indices instead of full TextAttribute copies.
+- The entries are reference counted by the number of cells that use them.
+  Unused entries are recycled for new attributes.
+--*/
+
+#pragma once
+
+#include "TextAttribute.hpp"
+
+class TextAttributeTable final
+{
+public:
+    // 32 bits are enough to give every cell of the largest possible buffer its own entry,
+    // which is what truecolor image output in a large scrollback easily gets close to.
+    using Index = uint32_t;
+
+    TextAttributeTable();
+
+    TextAttributeTable(const TextAttributeTable&) = delete;
+    TextAttributeTable& operator=(const TextAttributeTable&) = delete;
+
+    const TextAttribute& at(Index index) const noexcept;
+    Index Acquire(const TextAttribute& attr, uint32_t count);
+    void Retain(Index index, uint32_t count) noexcept;
+    void Release(Index index, uint32_t count) noexcept;
+
+    uint32_t HyperlinkRefCount(uint16_t hyperlinkId) const noexcept;
+    size_t size() const noexcept;
+
+private:
+    struct Entry
+    {
+        TextAttribute attr;
+        uint32_t refCount = 0;
+    };
+
+    struct Hash
+    {
+        size_t operator()(const TextAttribute& attr) const noexcept;
+    };
+
+    static constexpr Index InvalidIndex = std::numeric_limits<Index>::max();
+
+    std::vector<Entry> _entries;
+    std::unordered_map<TextAttribute, Index, Hash> _lookup;
+    std::vector<Index> _freeIndices;
+    // The number of cells referring to each hyperlink ID, indexed by the ID.
+    std::vector<uint32_t> _hyperlinkRefCounts;
+    // Consecutive writes tend to use the same attributes. This caches the last lookup.
+    TextAttribute _lastAttr;
+    Index _lastIndex = InvalidIndex;
+};
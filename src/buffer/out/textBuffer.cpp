@@ -15,6 +15,10 @@
 
 namespace
 {
+    // Hands out the chars and indices arrays of all rows from a single VirtualAlloc block.
+    // The chars of all rows are stored back to back, followed by the indices of all rows,
+    // so that scans over the text of the entire buffer (search, reflow, ...) stay dense.
+    // The block is zeroed, which ROW relies on to avoid touching rows before they're used.
     struct BufferAllocator
     {
         BufferAllocator(til::size sz)
@@ -26,35 +30,41 @@ namespace
             // The ROW::_indices array stores 1 more item than the buffer is wide.
             // That extra column stores the past-the-end _chars pointer.
             const auto indicesBytes = w * sizeof(uint16_t) + sizeof(uint16_t);
-            const auto rowStride = charsBytes + indicesBytes;
             // 65535*65535 cells would result in a charsAreaSize of 8GiB.
             // --> Use uint64_t so that we can safely do our calculations even on x86.
-            const auto allocSize = gsl::narrow<size_t>(::base::strict_cast<uint64_t>(rowStride) * ::base::strict_cast<uint64_t>(h));
+            const auto charsAreaSize = gsl::narrow<size_t>(::base::strict_cast<uint64_t>(charsBytes) * ::base::strict_cast<uint64_t>(h));
+            const auto indicesAreaSize = gsl::narrow<size_t>(::base::strict_cast<uint64_t>(indicesBytes) * ::base::strict_cast<uint64_t>(h));
+            const auto allocSize = charsAreaSize + indicesAreaSize;
 
+            // The pages of a committed VirtualAlloc block are zeroed on demand.
+            // Until a row is written to, its pages cost commit charge, but no physical memory.
             _buffer = wil::unique_virtualalloc_ptr<std::byte>{ static_cast<std::byte*>(VirtualAlloc(nullptr, allocSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE)) };
             THROW_IF_NULL_ALLOC(_buffer);
 
-            _data = std::span{ _buffer.get(), allocSize }.begin();
-            _rowStride = rowStride;
-            _indicesOffset = charsBytes;
+            const auto data = std::span{ _buffer.get(), allocSize }.begin();
+            _chars = data;
+            _indices = data + charsAreaSize;
+            _charsStride = charsBytes;
+            _indicesStride = indicesBytes;
             _width = w;
             _height = h;
         }
 
         BufferAllocator& operator++() noexcept
         {
-            _data += _rowStride;
+            _chars += _charsStride;
+            _indices += _indicesStride;
             return *this;
         }
 
         wchar_t* chars() const noexcept
         {
-            return til::bit_cast<wchar_t*>(&*_data);
+            return til::bit_cast<wchar_t*>(&*_chars);
         }
 
         uint16_t* indices() const noexcept
         {
-            return til::bit_cast<uint16_t*>(&*(_data + _indicesOffset));
+            return til::bit_cast<uint16_t*>(&*_indices);
         }
 
         uint16_t width() const noexcept
@@ -74,9 +84,10 @@ namespace
 
     private:
         wil::unique_virtualalloc_ptr<std::byte> _buffer;
-        std::span<std::byte>::iterator _data;
-        size_t _rowStride;
-        size_t _indicesOffset;
+        std::span<std::byte>::iterator _chars;
+        std::span<std::byte>::iterator _indices;
+        size_t _charsStride;
+        size_t _indicesStride;
         uint16_t _width;
         uint16_t _height;
     };
@@ -117,7 +128,7 @@ TextBuffer::TextBuffer(til::size screenBufferSize,
     _storage.reserve(allocator.height());
     for (til::CoordType i = 0; i < screenBufferSize.height; ++i, ++allocator)
     {
-        _storage.emplace_back(allocator.chars(), allocator.indices(), allocator.width(), _currentAttributes);
+        _storage.emplace_back(allocator.chars(), allocator.indices(), allocator.width(), _currentAttributes, &_attrTable, &_charsPool);
     }
 
     _charBuffer = allocator.take();
@@ -460,6 +471,94 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
     return newIt;
 }
 
+// Routine Description:
+// - Calls fill for the [columnBegin, columnEnd) range of every row touched by a run of
+//   length cells starting at target and triggers a redraw for the filled area.
+// Arguments:
+// - target - The position to start filling at
+// - length - The number of cells to fill
+// - fill - A callback invoked with the row and the columns to fill on it
+// Return Value:
+// - The number of cells filled, which is less than length if the end of the buffer was reached.
+template<typename T>
+til::CoordType TextBuffer::_FillRows(const til::point target, const size_t length, T&& fill)
+{
+    const auto size = GetSize();
+    if (length == 0 || !size.IsInBounds(target))
+    {
+        return 0;
+    }
+
+    const auto width = size.Width();
+    auto remaining = length;
+    auto pos = target;
+
+    while (remaining != 0 && pos.y < size.Height())
+    {
+        const auto count = gsl::narrow_cast<til::CoordType>(std::min<size_t>(remaining, gsl::narrow_cast<size_t>(width - pos.x)));
+        fill(GetRowByOffset(pos.y), pos.x, pos.x + count);
+        remaining -= count;
+        pos.x = 0;
+        pos.y++;
+    }
+
+    // A fill usually covers many complete rows, so rather than invalidating each one
+    // individually we invalidate the exact span if it fit on a single row, or all
+    // touched rows otherwise.
+    const auto filled = gsl::narrow_cast<til::CoordType>(length - remaining);
+    if (pos.y - target.y == 1)
+    {
+        TriggerRedraw(Viewport::FromDimensions(target, { filled, 1 }));
+    }
+    else
+    {
+        TriggerRedraw(Viewport::FromExclusive({ 0, target.y, width, pos.y }));
+    }
+
+    return filled;
+}
+
+// Routine Description:
+// - Fills cells with a color, starting at target and continuing on the following rows.
+// - This is equivalent to writing a color-only fill OutputCellIterator, but every
+//   affected row only receives a single attribute run replacement.
+// Arguments:
+// - target - The position to start filling at
+// - length - The number of cells to fill
+// - attr - The color to fill with
+// Return Value:
+// - The number of cells filled, which is less than length if the end of the buffer was reached.
+til::CoordType TextBuffer::FillAttributes(const til::point target, const size_t length, const TextAttribute& attr)
+{
+    return _FillRows(target, length, [&](ROW& row, const til::CoordType columnBegin, const til::CoordType columnEnd) {
+        row.ReplaceAttributes(columnBegin, columnEnd, attr);
+    });
+}
+
+// Routine Description:
+// - Fills cells with a narrow character, starting at target and continuing on the following rows.
+// - This is equivalent to writing a character-only fill OutputCellIterator with the wrap
+//   flag unset, but it fills the text of each row in bulk. Full width characters must
+//   still go through Write(), as they need to be padded at the end of each row.
+// Arguments:
+// - target - The position to start filling at
+// - length - The number of cells to fill
+// - ch - The character to fill with
+// Return Value:
+// - The number of cells filled, which is less than length if the end of the buffer was reached.
+til::CoordType TextBuffer::FillNarrowCharacters(const til::point target, const size_t length, const wchar_t ch)
+{
+    return _FillRows(target, length, [&](ROW& row, const til::CoordType columnBegin, const til::CoordType columnEnd) {
+        row.FillNarrowCharacters(columnBegin, columnEnd, ch);
+
+        // A fill operation should unset the wrap flag if it reaches the last column. See GH #1126.
+        if (columnEnd == row.size())
+        {
+            row.SetWrapForced(false);
+        }
+    });
+}
+
 //Routine Description:
 // - Inserts one codepoint into the buffer at the current cursor position and advances the cursor as appropriate.
 //Arguments:
@@ -637,9 +736,6 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
         _renderer.TriggerFlush(true);
     }
 
-    // Prune hyperlinks to delete obsolete references
-    _PruneHyperlinks();
-
     // Second, clean out the old "first row" as it will become the "last row" of the buffer after the circle is performed.
     auto fillAttributes = _currentAttributes;
     if (inVtMode)
@@ -648,7 +744,11 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
         // the current background color, but with no meta attributes set.
         fillAttributes.SetStandardErase();
     }
-    GetRowByOffset(0).Reset(fillAttributes);
+    // Clearing the old first row might have removed the last references to some hyperlinks.
+    auto& firstRow = GetRowByOffset(0);
+    const auto hyperlinks = firstRow.GetHyperlinks();
+    firstRow.Reset(fillAttributes);
+    _PruneHyperlinks(hyperlinks);
     {
         // Now proceed to increment.
         // Incrementing it will cause the next line down to become the new "top" of the window (the new "0" in logical coordinates)
@@ -749,6 +849,16 @@ const Viewport TextBuffer::GetSize() const noexcept
     return _size;
 }
 
+const TextAttributeTable& TextBuffer::GetAttributeTable() const noexcept
+{
+    return _attrTable;
+}
+
+const RowCharsPool& TextBuffer::GetCharsPool() const noexcept
+{
+    return _charsPool;
+}
+
 void TextBuffer::_UpdateSize()
 {
     _size = Viewport::FromDimensions({ _storage.at(0).size(), gsl::narrow<til::CoordType>(_storage.size()) });
@@ -767,19 +877,10 @@ void TextBuffer::ScrollRows(const til::CoordType firstRow, const til::CoordType
         return;
     }
 
-    // OK. We're about to play games by moving rows around within the deque to
-    // scroll a massive region in a faster way than copying things.
-    // To make this easier, first correct the circular buffer to have the first row be 0 again.
-    if (_firstRow != 0)
-    {
-        // Rotate the buffer to put the first row at the front.
-        std::rotate(_storage.begin(), _storage.begin() + _firstRow, _storage.end());
-
-        // The first row is now at the top.
-        _firstRow = 0;
-    }
-
-    // Rotate just the subsection specified
+    // OK. We're about to play games by moving rows around within the circular buffer
+    // to scroll a massive region in a faster way than copying things. The offsets
+    // below are relative to _firstRow and get mapped onto _storage by _RotateRows,
+    // so only the rows within the scrolled region are ever touched.
     if (delta < 0)
     {
         // The layout is like this:
@@ -815,7 +916,7 @@ void TextBuffer::ScrollRows(const til::CoordType firstRow, const til::CoordType
         // | 10
         // | 11
         // - end
-        std::rotate(_storage.begin() + firstRow + delta, _storage.begin() + firstRow, _storage.begin() + firstRow + size);
+        _RotateRows(firstRow + delta, firstRow, firstRow + size);
     }
     else
     {
@@ -852,8 +953,42 @@ void TextBuffer::ScrollRows(const til::CoordType firstRow, const til::CoordType
         // | 10
         // | 11
         // - end
-        std::rotate(_storage.begin() + firstRow, _storage.begin() + firstRow + size, _storage.begin() + firstRow + size + delta);
+        _RotateRows(firstRow, firstRow + size, firstRow + size + delta);
+    }
+}
+
+// Routine Description:
+// - Rotates the rows in the range [first, last) such that the row at middle becomes
+//   the first one, just like std::rotate. The arguments are row offsets (as used by
+//   GetRowByOffset) and not indices into _storage.
+// Arguments:
+// - first - offset of the first row in the range
+// - middle - offset of the row that should end up at the top of the range
+// - last - offset past the last row in the range
+void TextBuffer::_RotateRows(const til::CoordType first, const til::CoordType middle, const til::CoordType last)
+{
+    const auto height = gsl::narrow_cast<til::CoordType>(_storage.size());
+    const auto begin = (_firstRow + first) % height;
+
+    // If the range doesn't wrap around the end of _storage, it can be rotated in place.
+    if (begin + (last - first) <= height)
+    {
+        const auto it = _storage.begin() + begin;
+        std::rotate(it, it + (middle - first), it + (last - first));
+        return;
     }
+
+    // Otherwise we rotate by reversing both halves and then the whole range,
+    // which swaps each row in the range about twice.
+    const auto reverse = [this](til::CoordType lo, til::CoordType hi) {
+        for (--hi; lo < hi; ++lo, --hi)
+        {
+            swap(GetRowByOffset(lo), GetRowByOffset(hi));
+        }
+    };
+    reverse(first, middle);
+    reverse(middle, last);
+    reverse(first, last);
 }
 
 Cursor& TextBuffer::GetCursor() noexcept
@@ -992,8 +1127,16 @@ void TextBuffer::Reset()
         _SetFirstRowIndex(0);
 
         // realloc in the Y direction
-        // remove rows if we're shrinking
-        _storage.resize(allocator.height());
+        // remove rows if we're shrinking, or add empty ones (which get sized below) if we're growing
+        const auto newHeight = gsl::narrow_cast<size_t>(allocator.height());
+        if (newHeight < _storage.size())
+        {
+            _storage.erase(_storage.begin() + newHeight, _storage.end());
+        }
+        while (_storage.size() < newHeight)
+        {
+            _storage.emplace_back(nullptr, nullptr, uint16_t{ 0 }, attributes, &_attrTable, &_charsPool);
+        }
 
         // realloc in the X direction
         for (auto& it : _storage)
@@ -1354,50 +1497,77 @@ til::point TextBuffer::_GetWordEndForSelection(const til::point target, const st
     return result;
 }
 
-void TextBuffer::_PruneHyperlinks()
+// Routine Description:
+// - Removes the given hyperlinks from our maps if they aren't referenced anymore,
+//   so that obsolete hyperlinks don't hang around and their IDs can be reused.
+// Arguments:
+// - ids - the hyperlinks of a row that was just cleared, possibly with duplicates
+void TextBuffer::_PruneHyperlinks(const std::vector<uint16_t>& ids)
+{
+    for (const auto id : ids)
+    {
+        // The map lookup also filters out duplicates.
+        if (_IsHyperlinkUnused(id) && _hyperlinkMap.contains(id))
+        {
+            RemoveHyperlinkFromMap(id);
+            _hyperlinkFreeIds.emplace_back(id);
+        }
+    }
+}
+
+// Routine Description:
+// - Returns true if no cell in the buffer refers to the given hyperlink ID.
+//   The current attributes count as a reference, since they'll be written soon.
+bool TextBuffer::_IsHyperlinkUnused(const uint16_t id) const noexcept
+{
+    return _attrTable.HyperlinkRefCount(id) == 0 && id != _currentAttributes.GetHyperlinkId();
+}
+
+// Routine Description:
+// - Returns an ID for a new hyperlink. Pruned IDs are reused first. Once all IDs
+//   are in use, hyperlinks that have been overwritten in the meantime are reclaimed.
+// Return Value:
+// - The ID, or 0 if all IDs are still referenced by the buffer.
+uint16_t TextBuffer::_AllocateHyperlinkId()
 {
-    // Check the old first row for hyperlink references
-    // If there are any, search the entire buffer for the same reference
-    // If the buffer does not contain the same reference, we can remove that hyperlink from our map
-    // This way, obsolete hyperlink references are cleared from our hyperlink map instead of hanging around
-    // Get all the hyperlink references in the row we're erasing
-    const auto hyperlinks = GetRowByOffset(0).GetHyperlinks();
+    if (_hyperlinkFreeIds.empty() && _currentHyperlinkId == 0)
+    {
+        _ReclaimHyperlinkIds();
+    }
 
-    if (!hyperlinks.empty())
+    if (!_hyperlinkFreeIds.empty())
     {
-        // Move to unordered set so we can use hashed lookup of IDs instead of linear search.
-        // Only make it an unordered set now because set always heap allocates but vector
-        // doesn't when the set is empty (saving an allocation in the common case of no links.)
-        std::unordered_set<uint16_t> firstRowRefs{ hyperlinks.cbegin(), hyperlinks.cend() };
+        const auto id = _hyperlinkFreeIds.back();
+        _hyperlinkFreeIds.pop_back();
+        return id;
+    }
 
-        const auto total = TotalRowCount();
-        // Loop through all the rows in the buffer except the first row -
-        // we have found all hyperlink references in the first row and put them in refs,
-        // now we need to search the rest of the buffer (i.e. all the rows except the first)
-        // to see if those references are anywhere else
-        for (til::CoordType i = 1; i < total; ++i)
+    // This wraps around to 0 after the last ID was handed out.
+    return _currentHyperlinkId ? _currentHyperlinkId++ : 0;
+}
+
+// Routine Description:
+// - Removes all hyperlinks that aren't referenced anymore from our maps and marks their IDs as free.
+//   Unlike _PruneHyperlinks this needs to visit every hyperlink, which is why we only do it
+//   when we ran out of IDs. This happens when applications keep rewriting their hyperlinks in place.
+void TextBuffer::_ReclaimHyperlinkIds()
+{
+    for (auto it = _hyperlinkMap.begin(); it != _hyperlinkMap.end();)
+    {
+        if (_IsHyperlinkUnused(it->first))
         {
-            const auto nextRowRefs = GetRowByOffset(i).GetHyperlinks();
-            for (auto id : nextRowRefs)
-            {
-                if (firstRowRefs.find(id) != firstRowRefs.end())
-                {
-                    firstRowRefs.erase(id);
-                }
-            }
-            if (firstRowRefs.empty())
-            {
-                // No more hyperlink references left to search for, terminate early
-                break;
-            }
+            _hyperlinkFreeIds.emplace_back(it->first);
+            it = _hyperlinkMap.erase(it);
         }
-
-        // Now delete obsolete references from our map
-        for (auto hyperlinkReference : firstRowRefs)
+        else
         {
-            RemoveHyperlinkFromMap(hyperlinkReference);
+            ++it;
         }
     }
+
+    std::erase_if(_hyperlinkCustomIdMap, [&](const auto& pair) {
+        return !_hyperlinkMap.contains(pair.second);
+    });
 }
 
 // Method Description:
@@ -2563,7 +2733,7 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
         // the last attr when wider.
         auto& newRow = newBuffer.GetRowByOffset(newRowY);
         const auto newWidth = newBuffer.GetLineWidth(newRowY);
-        newRow.TransferAttributes(row.Attributes(), newWidth);
+        newRow.TransferAttributes(row, newWidth);
 
         newRowY++;
     }
@@ -2668,31 +2838,25 @@ std::wstring TextBuffer::GetHyperlinkUriFromId(uint16_t id) const
 // - The internal hyperlink ID
 uint16_t TextBuffer::GetHyperlinkId(std::wstring_view uri, std::wstring_view id)
 {
-    uint16_t numericId = 0;
     if (id.empty())
     {
-        // no custom id specified, return our internal count
-        numericId = _currentHyperlinkId;
-        ++_currentHyperlinkId;
+        // no custom id specified, return a new id
+        return _AllocateHyperlinkId();
     }
-    else
+
+    std::wstring newId{ id };
+    // hash the URL and add it to the custom ID - GH#7698
+    newId += L"%" + std::to_wstring(til::hash(uri));
+    if (const auto it = _hyperlinkCustomIdMap.find(newId); it != _hyperlinkCustomIdMap.end())
     {
-        // assign _currentHyperlinkId if the custom id does not already exist
-        std::wstring newId{ id };
-        // hash the URL and add it to the custom ID - GH#7698
-        newId += L"%" + std::to_wstring(til::hash(uri));
-        const auto result = _hyperlinkCustomIdMap.emplace(newId, _currentHyperlinkId);
-        if (result.second)
-        {
-            // the custom id did not already exist
-            ++_currentHyperlinkId;
-        }
-        numericId = (*(result.first)).second;
+        return it->second;
     }
-    // _currentHyperlinkId could overflow, make sure its not 0
-    if (_currentHyperlinkId == 0)
+
+    // the custom id does not already exist
+    const auto numericId = _AllocateHyperlinkId();
+    if (numericId)
     {
-        ++_currentHyperlinkId;
+        _hyperlinkCustomIdMap.emplace(std::move(newId), numericId);
     }
     return numericId;
 }
@@ -2736,13 +2900,15 @@ std::wstring TextBuffer::GetCustomIdFromId(uint16_t id) const
 
 // Method Description:
 // - Copies the hyperlink/customID maps of the old buffer into this one,
-//   also copies currentHyperlinkId
+//   also copies the free and current hyperlink IDs. The reference counts
+//   aren't copied, since they belong to the rows of each buffer.
 // Arguments:
 // - The other buffer
 void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
 {
     _hyperlinkMap = other._hyperlinkMap;
     _hyperlinkCustomIdMap = other._hyperlinkCustomIdMap;
+    _hyperlinkFreeIds = other._hyperlinkFreeIds;
     _currentHyperlinkId = other._currentHyperlinkId;
 }
 
@@ -2801,6 +2967,19 @@ PointTree TextBuffer::GetPatterns(const til::CoordType firstRow, const til::Coor
         concatAll += row.GetText();
     }
 
+    const auto measureColumns = [](const std::wstring& str) {
+        if (IsNarrowRun(str))
+        {
+            return gsl::narrow_cast<til::CoordType>(str.size());
+        }
+        til::CoordType columns = 0;
+        for (const auto& glyph : til::utf16_iterator{ str })
+        {
+            columns += IsGlyphFullWidth(glyph) ? 2 : 1;
+        }
+        return columns;
+    };
+
     // for each pattern we know of, iterate through the string
     for (const auto& idAndPattern : _idsAndPatterns)
     {
@@ -2817,17 +2996,9 @@ PointTree TextBuffer::GetPatterns(const til::CoordType firstRow, const til::Coor
             // when we find a match, the prefix is text that is between this
             // match and the previous match, so we use the size of the prefix
             // along with the size of the match to determine the locations
-            til::CoordType prefixSize = 0;
-            for (const auto str = i->prefix().str(); const auto& glyph : til::utf16_iterator{ str })
-            {
-                prefixSize += IsGlyphFullWidth(glyph) ? 2 : 1;
-            }
+            const auto prefixSize = measureColumns(i->prefix().str());
             const auto start = lenUpToThis + prefixSize;
-            til::CoordType matchSize = 0;
-            for (const auto str = i->str(); const auto& glyph : til::utf16_iterator{ str })
-            {
-                matchSize += IsGlyphFullWidth(glyph) ? 2 : 1;
-            }
+            const auto matchSize = measureColumns(i->str());
             const auto end = start + matchSize;
             lenUpToThis = end;
 
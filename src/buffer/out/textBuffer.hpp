@@ -100,6 +100,9 @@ public:
                                  const std::optional<bool> setWrap = std::nullopt,
                                  const std::optional<til::CoordType> limitRight = std::nullopt);
 
+    til::CoordType FillAttributes(const til::point target, const size_t length, const TextAttribute& attr);
+    til::CoordType FillNarrowCharacters(const til::point target, const size_t length, const wchar_t ch);
+
     bool InsertCharacter(const wchar_t wch, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool InsertCharacter(const std::wstring_view chars, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool IncrementCursor();
@@ -116,6 +119,8 @@ public:
     const til::CoordType GetFirstRowIndex() const noexcept;
 
     const Microsoft::Console::Types::Viewport GetSize() const noexcept;
+    const TextAttributeTable& GetAttributeTable() const noexcept;
+    const RowCharsPool& GetCharsPool() const noexcept;
 
     void ScrollRows(const til::CoordType firstRow, const til::CoordType size, const til::CoordType delta);
 
@@ -218,6 +223,7 @@ public:
 private:
     void _UpdateSize();
     void _SetFirstRowIndex(const til::CoordType FirstRowIndex) noexcept;
+    void _RotateRows(const til::CoordType first, const til::CoordType middle, const til::CoordType last);
     til::point _GetPreviousFromCursor() const noexcept;
     void _SetWrapOnCurrentRow() noexcept;
     void _AdjustWrapOnCurrentRow(const bool fSet) noexcept;
@@ -231,7 +237,12 @@ private:
     til::point _GetWordStartForSelection(const til::point target, const std::wstring_view wordDelimiters) const noexcept;
     til::point _GetWordEndForAccessibility(const til::point target, const std::wstring_view wordDelimiters, const til::point limit) const;
     til::point _GetWordEndForSelection(const til::point target, const std::wstring_view wordDelimiters) const noexcept;
-    void _PruneHyperlinks();
+    void _PruneHyperlinks(const std::vector<uint16_t>& ids);
+    bool _IsHyperlinkUnused(uint16_t id) const noexcept;
+    uint16_t _AllocateHyperlinkId();
+    void _ReclaimHyperlinkIds();
+    template<typename T>
+    til::CoordType _FillRows(const til::point target, const size_t length, T&& fill);
 
     static void _AppendRTFText(std::ostringstream& contentBuilder, const std::wstring_view& text);
 
@@ -239,12 +250,20 @@ private:
 
     std::unordered_map<uint16_t, std::wstring> _hyperlinkMap;
     std::unordered_map<std::wstring, uint16_t> _hyperlinkCustomIdMap;
+    // IDs of pruned hyperlinks, which are handed out again before _currentHyperlinkId.
+    std::vector<uint16_t> _hyperlinkFreeIds;
+    // The next never used ID. 0 once all IDs have been used.
     uint16_t _currentHyperlinkId = 1;
 
     std::unordered_map<size_t, std::wstring> _idsAndPatterns;
     size_t _currentPatternId = 0;
 
     wil::unique_virtualalloc_ptr<std::byte> _charBuffer;
+    // Interns the attributes of all rows in _storage. It also counts the
+    // references to each hyperlink ID. Must outlive _storage.
+    TextAttributeTable _attrTable;
+    // Serves the chars of rows in _storage that don't fit into _charBuffer. Must outlive _storage.
+    RowCharsPool _charsPool;
     std::vector<ROW> _storage;
     TextAttribute _currentAttributes;
     til::CoordType _firstRow = 0; // indexes top row (not necessarily 0)
@@ -50,26 +50,26 @@ public:
                                                             ULONG& events) noexcept override;
 
     [[nodiscard]] HRESULT PeekConsoleInputAImpl(IConsoleInputObject& context,
-                                                std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                const size_t eventsToRead,
+                                                std::span<INPUT_RECORD> outRecords,
+                                                size_t& eventsRead,
                                                 INPUT_READ_HANDLE_DATA& readHandleState,
                                                 std::unique_ptr<IWaitRoutine>& waiter) noexcept override;
 
     [[nodiscard]] HRESULT PeekConsoleInputWImpl(IConsoleInputObject& context,
-                                                std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                const size_t eventsToRead,
+                                                std::span<INPUT_RECORD> outRecords,
+                                                size_t& eventsRead,
                                                 INPUT_READ_HANDLE_DATA& readHandleState,
                                                 std::unique_ptr<IWaitRoutine>& waiter) noexcept override;
 
     [[nodiscard]] HRESULT ReadConsoleInputAImpl(IConsoleInputObject& context,
-                                                std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                const size_t eventsToRead,
+                                                std::span<INPUT_RECORD> outRecords,
+                                                size_t& eventsRead,
                                                 INPUT_READ_HANDLE_DATA& readHandleState,
                                                 std::unique_ptr<IWaitRoutine>& waiter) noexcept override;
 
     [[nodiscard]] HRESULT ReadConsoleInputWImpl(IConsoleInputObject& context,
-                                                std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                const size_t eventsToRead,
+                                                std::span<INPUT_RECORD> outRecords,
+                                                size_t& eventsRead,
                                                 INPUT_READ_HANDLE_DATA& readHandleState,
                                                 std::unique_ptr<IWaitRoutine>& waiter) noexcept override;
 
@@ -106,45 +106,45 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
 }
 
 [[nodiscard]] HRESULT VtApiRoutines::PeekConsoleInputAImpl(IConsoleInputObject& context,
-                                                           std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                           const size_t eventsToRead,
+                                                           std::span<INPUT_RECORD> outRecords,
+                                                           size_t& eventsRead,
                                                            INPUT_READ_HANDLE_DATA& readHandleState,
                                                            std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
-    const auto hr = m_pUsualRoutines->PeekConsoleInputAImpl(context, outEvents, eventsToRead, readHandleState, waiter);
+    const auto hr = m_pUsualRoutines->PeekConsoleInputAImpl(context, outRecords, eventsRead, readHandleState, waiter);
     _SynchronizeCursor(waiter);
     return hr;
 }
 
 [[nodiscard]] HRESULT VtApiRoutines::PeekConsoleInputWImpl(IConsoleInputObject& context,
-                                                           std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                           const size_t eventsToRead,
+                                                           std::span<INPUT_RECORD> outRecords,
+                                                           size_t& eventsRead,
                                                            INPUT_READ_HANDLE_DATA& readHandleState,
                                                            std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
-    const auto hr = m_pUsualRoutines->PeekConsoleInputWImpl(context, outEvents, eventsToRead, readHandleState, waiter);
+    const auto hr = m_pUsualRoutines->PeekConsoleInputWImpl(context, outRecords, eventsRead, readHandleState, waiter);
     _SynchronizeCursor(waiter);
     return hr;
 }
 
 [[nodiscard]] HRESULT VtApiRoutines::ReadConsoleInputAImpl(IConsoleInputObject& context,
-                                                           std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                           const size_t eventsToRead,
+                                                           std::span<INPUT_RECORD> outRecords,
+                                                           size_t& eventsRead,
                                                            INPUT_READ_HANDLE_DATA& readHandleState,
                                                            std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
-    const auto hr = m_pUsualRoutines->ReadConsoleInputAImpl(context, outEvents, eventsToRead, readHandleState, waiter);
+    const auto hr = m_pUsualRoutines->ReadConsoleInputAImpl(context, outRecords, eventsRead, readHandleState, waiter);
     _SynchronizeCursor(waiter);
     return hr;
 }
 
 [[nodiscard]] HRESULT VtApiRoutines::ReadConsoleInputWImpl(IConsoleInputObject& context,
-                                                           std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                           const size_t eventsToRead,
+                                                           std::span<INPUT_RECORD> outRecords,
+                                                           size_t& eventsRead,
                                                            INPUT_READ_HANDLE_DATA& readHandleState,
                                                            std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
-    const auto hr = m_pUsualRoutines->ReadConsoleInputWImpl(context, outEvents, eventsToRead, readHandleState, waiter);
+    const auto hr = m_pUsualRoutines->ReadConsoleInputWImpl(context, outRecords, eventsRead, readHandleState, waiter);
     _SynchronizeCursor(waiter);
     return hr;
 }
@@ -203,16 +203,17 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
                                                        bool requiresVtQuirk,
                                                        std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
+    // The output is forwarded to the terminal as is. Since we trust passthrough
+    // clients to write well-formed VT, there's no need to parse it first.
     if (CP_UTF8 == m_outputCodepage)
     {
-        (void)m_pVtEngine->WriteTerminalUtf8(buffer);
+        (void)m_pVtEngine->QueueTerminalUtf8(buffer);
     }
     else
     {
-        (void)m_pVtEngine->WriteTerminalW(ConvertToW(m_outputCodepage, buffer));
+        (void)m_pVtEngine->QueueTerminalW(ConvertToW(m_outputCodepage, buffer));
     }
 
-    (void)m_pVtEngine->_Flush();
     read = buffer.size();
     return S_OK;
 }
@@ -223,8 +224,7 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
                                                        bool requiresVtQuirk,
                                                        std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
-    (void)m_pVtEngine->WriteTerminalW(buffer);
-    (void)m_pVtEngine->_Flush();
+    (void)m_pVtEngine->QueueTerminalW(buffer);
     read = buffer.size();
     return S_OK;
 }
@@ -184,6 +184,14 @@ VtIo::VtIo() :
                     }
                 }
 
+                if constexpr (Feature_VtMinimalDiffRendering::IsEnabled())
+                {
+                    if (!_passthroughMode)
+                    {
+                        xterm256Engine->SetMinimalDiffMode(true);
+                    }
+                }
+
                 _pVtRenderEngine = std::move(xterm256Engine);
                 break;
             }
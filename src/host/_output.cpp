@@ -12,6 +12,7 @@
 #include "../interactivity/inc/ServiceLocator.hpp"
 #include "../types/inc/Viewport.hpp"
 #include "../types/inc/convert.hpp"
+#include "../types/inc/GlyphWidth.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -215,10 +216,9 @@ void WriteToScreen(SCREEN_INFORMATION& screenInfo, const Viewport& region)
 
     try
     {
-        TextAttribute useThisAttr(attribute);
-        const OutputCellIterator it(useThisAttr, lengthToWrite);
-        const auto done = screenBuffer.Write(it, startingCoordinate);
-        const auto cellsModifiedCoord = done.GetCellDistance(it);
+        // Filling with a color replaces at most a single attribute run per row.
+        const TextAttribute useThisAttr(attribute);
+        const auto cellsModifiedCoord = screenBuffer.GetTextBuffer().FillAttributes(startingCoordinate, lengthToWrite, useThisAttr);
 
         cellsModified = cellsModifiedCoord;
 
@@ -277,12 +277,21 @@ void WriteToScreen(SCREEN_INFORMATION& screenInfo, const Viewport& region)
     auto hr = S_OK;
     try
     {
-        const OutputCellIterator it(character, lengthToWrite);
+        til::CoordType cellsModifiedCoord = 0;
+        if (!IsGlyphFullWidth(character))
+        {
+            // Narrow characters fill each row in bulk. This also unsets the wrap flag of every row it fills completely.
+            cellsModifiedCoord = screenInfo.GetTextBuffer().FillNarrowCharacters(startingCoordinate, lengthToWrite, character);
+        }
+        else
+        {
+            const OutputCellIterator it(character, lengthToWrite);
 
-        // when writing to the buffer, specifically unset wrap if we get to the last column.
-        // a fill operation should UNSET wrap in that scenario. See GH #1126 for more details.
-        const auto done = screenInfo.Write(it, startingCoordinate, false);
-        const auto cellsModifiedCoord = done.GetInputDistance(it);
+            // when writing to the buffer, specifically unset wrap if we get to the last column.
+            // a fill operation should UNSET wrap in that scenario. See GH #1126 for more details.
+            const auto done = screenInfo.Write(it, startingCoordinate, false);
+            cellsModifiedCoord = done.GetInputDistance(it);
+        }
 
         cellsModified = cellsModifiedCoord;
 
@@ -28,6 +28,58 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
 // Used by WriteCharsLegacy.
 #define IS_GLYPH_CHAR(wch) (((wch) >= L' ') && ((wch) != 0x007F))
 
+// Routine Description:
+// - Counts the leading characters in the given text that are printable ASCII (U+0020 to U+007E).
+//   Those are all narrow glyphs and WriteCharsLegacy can copy them without looking at them any further.
+// Arguments:
+// - text - the text to scan
+// - count - the number of characters in text
+// Return Value:
+// - the number of leading printable ASCII characters
+static size_t _CountPrintableAscii(_In_reads_(count) const wchar_t* const text, const size_t count) noexcept
+{
+    auto it = text;
+    const auto end = text + count;
+
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+#if _M_AMD64
+    // SSE2 lacks unsigned 16-bit comparisons, so this tests two things per character instead:
+    // * a saturating subtraction of 0x7E results in 0 for everything up to U+007E
+    // * a signed comparison with 0x20 catches C0 control characters (and everything >= U+8000,
+    //   which would've been caught by the subtraction anyways)
+    const auto last = _mm_set1_epi16(0x7E);
+    const auto first = _mm_set1_epi16(0x20);
+    const auto zero = _mm_setzero_si128();
+    for (; end - it >= 8; it += 8)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const auto belowLast = _mm_cmpeq_epi16(_mm_subs_epu16(chars, last), zero);
+        const auto belowFirst = _mm_cmplt_epi16(chars, first);
+        const auto printable = static_cast<unsigned long>(_mm_movemask_epi8(_mm_andnot_si128(belowFirst, belowLast)));
+        if (printable != 0xffff)
+        {
+            // The mask has 2 bits per character. The first zero bit marks the first non-printable one.
+            unsigned long index;
+            _BitScanForward(&index, ~printable);
+            return gsl::narrow_cast<size_t>(it - text) + index / 2;
+        }
+    }
+#endif
+
+    for (; it != end; ++it)
+    {
+        if (*it < L' ' || *it > L'~')
+        {
+            break;
+        }
+    }
+#pragma warning(pop)
+
+    return gsl::narrow_cast<size_t>(it - text);
+}
+
 // Routine Description:
 // - This routine updates the cursor position.  Its input is the non-special
 //   cased new location of the cursor.  For example, if the cursor were being
@@ -380,6 +432,24 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
         auto LocalBufPtr = LocalBuffer;
         while (*pcb < BufferSize && i < LOCAL_BUFFER_SIZE && XPosition < coordScreenBufferSize.width)
         {
+            // Most text is printable ASCII, which doesn't need any of the processing below.
+            // Copy all of it up to the next control character (or the end of the buffer or row) at once.
+            const auto plainLimit = std::min<size_t>({ (BufferSize - *pcb) / sizeof(WCHAR),
+                                                       gsl::narrow_cast<size_t>(LOCAL_BUFFER_SIZE - i),
+                                                       gsl::narrow_cast<size_t>(coordScreenBufferSize.width - XPosition) });
+            if (const auto plain = _CountPrintableAscii(lpString, plainLimit))
+            {
+                std::copy_n(lpString, plain, LocalBufPtr);
+                LocalBufPtr += plain;
+                lpString += plain;
+                pwchRealUnicode += plain;
+                pwchBuffer += plain;
+                XPosition += gsl::narrow_cast<til::CoordType>(plain);
+                i += gsl::narrow_cast<til::CoordType>(plain);
+                *pcb += plain * sizeof(WCHAR);
+                continue;
+            }
+
 #pragma prefast(suppress : 26019, "Buffer is taken in multiples of 2. Validation is ok.")
             const auto Char = *lpString;
             // WCL-NOTE: We believe RealUnicodeChar to be identical to Char, because we believe pwchRealUnicode
@@ -21,7 +21,9 @@ using Microsoft::Console::Interactivity::ServiceLocator;
 
 struct case_insensitive_hash
 {
-    std::size_t operator()(const std::wstring& key) const
+    using is_transparent = void;
+
+    std::size_t operator()(const std::wstring_view key) const
     {
         til::hasher h;
         for (const auto& ch : key)
@@ -34,9 +36,11 @@ struct case_insensitive_hash
 
 struct case_insensitive_equality
 {
-    bool operator()(const std::wstring& lhs, const std::wstring& rhs) const
+    using is_transparent = void;
+
+    bool operator()(const std::wstring_view lhs, const std::wstring_view rhs) const
     {
-        return 0 == _wcsicmp(lhs.data(), rhs.data());
+        return lhs.size() == rhs.size() && 0 == _wcsnicmp(lhs.data(), rhs.data(), lhs.size());
     }
 };
 
@@ -49,6 +53,17 @@ std::unordered_map<std::wstring,
                    case_insensitive_equality>
     g_aliasData;
 
+// The targets of g_aliasData compiled for s_MatchAndCopyAlias, under the same keys.
+// Both are kept in sync wherever an alias is added or removed.
+std::unordered_map<std::wstring,
+                   std::unordered_map<std::wstring,
+                                      Alias::CompiledTarget,
+                                      case_insensitive_hash,
+                                      case_insensitive_equality>,
+                   case_insensitive_hash,
+                   case_insensitive_equality>
+    g_compiledAliases;
+
 // Routine Description:
 // - Adds a command line alias to the global set.
 // - Converts and calls the W version of this function.
@@ -108,13 +123,38 @@ std::unordered_map<std::wstring,
             auto exeData = g_aliasData.find(exeNameString);
             if (exeData != g_aliasData.end())
             {
-                g_aliasData[exeNameString].erase(sourceString);
+                exeData->second.erase(sourceString);
+
+                const auto exeCompiled = g_compiledAliases.find(exeNameString);
+                if (exeCompiled != g_compiledAliases.end())
+                {
+                    exeCompiled->second.erase(sourceString);
+                }
             }
         }
         else
         {
-            // Map will auto-create each level as necessary
-            g_aliasData[exeNameString][sourceString] = targetString;
+            auto compiled = Alias::s_CompileTarget(targetString);
+
+            // Map will auto-create each level as necessary.
+            // Everything that can throw happens before the alias is replaced in either map,
+            // so that a failure can't leave a compiled target behind that doesn't match its text.
+            auto& exeData = g_aliasData[exeNameString];
+            auto& exeCompiled = g_compiledAliases[exeNameString];
+
+            const auto emplaced = exeData.try_emplace(sourceString);
+            const auto aliasIter = emplaced.first;
+            auto eraseAlias = wil::scope_exit([&] {
+                if (emplaced.second)
+                {
+                    exeData.erase(aliasIter);
+                }
+            });
+            auto& compiledTarget = exeCompiled[sourceString];
+            eraseAlias.release();
+
+            aliasIter->second = std::move(targetString);
+            compiledTarget = std::move(compiled);
         }
     }
     CATCH_RETURN();
@@ -156,10 +196,10 @@ std::unordered_map<std::wstring,
     // We use .find for the iterators then dereference to search without creating entries.
     const auto exeIter = g_aliasData.find(exeNameString);
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), exeIter == g_aliasData.end());
-    const auto exeData = exeIter->second;
+    const auto& exeData = exeIter->second;
     const auto sourceIter = exeData.find(sourceString);
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), sourceIter == exeData.end());
-    const auto targetString = sourceIter->second;
+    const auto& targetString = sourceIter->second;
     RETURN_HR_IF(HRESULT_FROM_WIN32(ERROR_GEN_FAILURE), targetString.size() == 0);
 
     // TargetLength is a byte count, convert to characters.
@@ -333,7 +373,7 @@ static std::wstring aliasesSeparator(L"=");
         auto exeIter = g_aliasData.find(exeNameString);
         if (exeIter != g_aliasData.end())
         {
-            auto list = exeIter->second;
+            const auto& list = exeIter->second;
             for (auto& pair : list)
             {
                 // Alias stores lengths in bytes.
@@ -423,6 +463,12 @@ void Alias::s_ClearCmdExeAliases()
     {
         exeIter->second.clear();
     }
+
+    auto compiledIter = g_compiledAliases.find(L"cmd.exe");
+    if (compiledIter != g_compiledAliases.end())
+    {
+        compiledIter->second.clear();
+    }
 }
 
 // Routine Description:
@@ -464,7 +510,7 @@ void Alias::s_ClearCmdExeAliases()
     auto exeIter = g_aliasData.find(exeNameString);
     if (exeIter != g_aliasData.end())
     {
-        auto list = exeIter->second;
+        const auto& list = exeIter->second;
         for (auto& pair : list)
         {
             // Alias stores lengths in bytes.
@@ -817,126 +863,6 @@ void Alias::s_ClearCmdExeAliases()
     CATCH_RETURN();
 }
 
-// Routine Description:
-// - Trims trailing \r\n off of a string
-// Arguments:
-// - str - String to trim
-void Alias::s_TrimTrailingCrLf(std::wstring& str)
-{
-    const auto trailingCrLfPos = str.find_last_of(UNICODE_CARRIAGERETURN);
-    if (std::wstring::npos != trailingCrLfPos)
-    {
-        str.erase(trailingCrLfPos);
-    }
-}
-
-// Routine Description:
-// - Tokenizes a string into a collection using space as a separator
-// Arguments:
-// - str - String to tokenize
-// Return Value:
-// - Collection of tokenized strings
-std::deque<std::wstring> Alias::s_Tokenize(const std::wstring& str)
-{
-    std::deque<std::wstring> result;
-
-    size_t prevIndex = 0;
-    auto spaceIndex = str.find(L' ');
-    while (std::wstring::npos != spaceIndex)
-    {
-        const auto length = spaceIndex - prevIndex;
-
-        result.emplace_back(str.substr(prevIndex, length));
-
-        spaceIndex++;
-        prevIndex = spaceIndex;
-
-        spaceIndex = str.find(L' ', spaceIndex);
-    }
-
-    // Place the final one into the set.
-    result.emplace_back(str.substr(prevIndex));
-
-    return result;
-}
-
-// Routine Description:
-// - Gets just the arguments portion of the command string
-//   Specifically, all text after the first space character.
-// Arguments:
-// - str - String to split into just args
-// Return Value:
-// - Only the arguments part of the string or empty if there are no arguments.
-std::wstring Alias::s_GetArgString(const std::wstring& str)
-{
-    std::wstring result;
-    auto firstSpace = str.find_first_of(L' ');
-    if (std::wstring::npos != firstSpace)
-    {
-        firstSpace++;
-        if (firstSpace < str.size())
-        {
-            result = str.substr(firstSpace);
-        }
-    }
-
-    return result;
-}
-
-// Routine Description:
-// - Checks the given character to see if it is a numbered arg replacement macro
-//   and replaces it with the counted argument if there is a match
-// Arguments:
-// - ch - Character to test as a macro
-// - appendToStr - Append the macro result here if it matched
-// - tokens - Tokens of the original command string. 0 is alias. 1-N are arguments.
-// Return Value:
-// - True if we found the macro and appended to the string.
-// - False if the given character doesn't match this macro.
-bool Alias::s_TryReplaceNumberedArgMacro(const wchar_t ch,
-                                         std::wstring& appendToStr,
-                                         const std::deque<std::wstring>& tokens)
-{
-    if (ch >= L'1' && ch <= L'9')
-    {
-        // Numerical macros substitute that numbered argument
-        const size_t index = ch - L'0';
-
-        if (index < tokens.size() && index > 0)
-        {
-            appendToStr.append(tokens[index]);
-        }
-
-        return true;
-    }
-
-    return false;
-}
-
-// Routine Description:
-// - Checks the given character to see if it is a wildcard arg replacement macro
-//   and replaces it with the entire argument string if there is a match
-// Arguments:
-// - ch - Character to test as a macro
-// - appendToStr - Append the macro result here if it matched
-// - fullArgString - All of the arguments as one big string.
-// Return Value:
-// - True if we found the macro and appended to the string.
-// - False if the given character doesn't match this macro.
-bool Alias::s_TryReplaceWildcardArgMacro(const wchar_t ch,
-                                         std::wstring& appendToStr,
-                                         const std::wstring fullArgString)
-{
-    if (L'*' == ch)
-    {
-        // Wildcard substitutes all arguments
-        appendToStr.append(fullArgString);
-        return true;
-    }
-
-    return false;
-}
-
 // Routine Description:
 // - Checks the given character to see if it is an input redirection macro
 //   and replaces it with the < redirector if there is a match
@@ -1037,150 +963,186 @@ void Alias::s_AppendCrLf(std::wstring& appendToStr,
 }
 
 // Routine Description:
-// - Searches through the given string for macros and replaces them
-//   with the matching action
+// - Compiles the target of an alias for repeated expansion by s_MatchAndCopyAlias.
+// - The $L, $G, $B and $T macros expand to the same text every time and are substituted right away.
+//   Only $1-$9 and $* depend on the command line. They split the remaining text into segments that
+//   each end in a reference to the argument to insert.
 // Arguments:
-// - str - On input, the string to search. On output, the string is replaced.
-// - tokens - The tokenized command line input. 0 is the alias, 1-N are arguments.
-// - fullArgString - Shorthand to 1-N argument string in case of wildcard match.
+// - target - The destination/expansion text of the alias
 // Return Value:
-// - The number of commands in the final string (line feeds, CRLFs)
-size_t Alias::s_ReplaceMacros(std::wstring& str,
-                              const std::deque<std::wstring>& tokens,
-                              const std::wstring& fullArgString)
+// - The literal text and argument references that make up the expansion of the alias.
+Alias::CompiledTarget Alias::s_CompileTarget(const std::wstring_view target)
 {
-    size_t lineCount = 0;
-    std::wstring finalText;
+    CompiledTarget compiled;
+    size_t segmentStart = 0;
+
+    const auto endSegment = [&](const uint8_t argument) {
+        compiled.segments.push_back({ compiled.literals.size() - segmentStart, argument });
+        segmentStart = compiled.literals.size();
+    };
 
-    // The target text may contain substitution macros indicated by $.
-    // Walk through and substitute them as appropriate.
-    for (auto ch = str.cbegin(); ch < str.cend(); ch++)
+    for (size_t i = 0; i < target.size(); ++i)
     {
-        if (L'$' == *ch)
-        {
-            // Attempt to read ahead by one character.
-            const auto chNext = ch + 1;
+        const auto ch = til::at(target, i);
 
-            if (chNext < str.cend())
-            {
-                auto isProcessed = s_TryReplaceNumberedArgMacro(*chNext, finalText, tokens);
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplaceWildcardArgMacro(*chNext, finalText, fullArgString);
-                }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplaceInputRedirMacro(*chNext, finalText);
-                }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplaceOutputRedirMacro(*chNext, finalText);
-                }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplacePipeRedirMacro(*chNext, finalText);
-                }
-                if (!isProcessed)
-                {
-                    isProcessed = s_TryReplaceNextCommandMacro(*chNext, finalText, lineCount);
-                }
-                if (!isProcessed)
-                {
-                    // If nothing matches, just push these two characters in.
-                    finalText.push_back(*ch);
-                    finalText.push_back(*chNext);
-                }
+        // A $ without a character following it is just copied through.
+        if (L'$' != ch || i + 1 == target.size())
+        {
+            compiled.literals.push_back(ch);
+            continue;
+        }
 
-                // Since we read ahead and used that character,
-                // advance the iterator one extra to compensate.
-                ch++;
-            }
-            else
-            {
-                // If no read-ahead, just push this character and be done.
-                finalText.push_back(*ch);
-            }
+        const auto chNext = til::at(target, ++i);
+        if (chNext >= L'1' && chNext <= L'9')
+        {
+            endSegment(gsl::narrow_cast<uint8_t>(chNext - L'0'));
         }
-        else
+        else if (L'*' == chNext)
+        {
+            endSegment(CompiledTarget::AllArguments);
+        }
+        else if (!s_TryReplaceInputRedirMacro(chNext, compiled.literals) &&
+                 !s_TryReplaceOutputRedirMacro(chNext, compiled.literals) &&
+                 !s_TryReplacePipeRedirMacro(chNext, compiled.literals) &&
+                 !s_TryReplaceNextCommandMacro(chNext, compiled.literals, compiled.lineCount))
         {
-            // If it didn't match the macro specifier $, push the character.
-            finalText.push_back(*ch);
+            // If nothing matches, just push these two characters in.
+            compiled.literals.push_back(ch);
+            compiled.literals.push_back(chNext);
         }
     }
 
     // We always terminate with a CRLF to symbolize end of command.
-    s_AppendCrLf(finalText, lineCount);
+    s_AppendCrLf(compiled.literals, compiled.lineCount);
+    endSegment(0);
 
-    // Give back the final text and count.
-    str.swap(finalText);
-    return lineCount;
+    return compiled;
 }
 
 // Routine Description:
 // - Takes the source text and searches it for an alias belonging to exe name's list.
+// - The command line is split at each space. The first token is the alias, $1-$9 are the ones
+//   after it and $* is all text after the first space.
 // Arguments:
-// - sourceText - The string to search for an alias
+// - source - The command line to search for an alias. A trailing \r\n is ignored.
 // - exeName - The name of the EXE that has aliases associated
-// - lineCount - Number of lines worth of text processed.
+// - arguments - Receives the text of each argument reference, pointing into source.
 // Return Value:
-// - If we found a matching alias, this will be the processed data
-//   and lineCount is updated to the new number of lines.
-// - If we didn't match and process an alias, return an empty string.
-std::wstring Alias::s_MatchAndCopyAlias(const std::wstring& sourceText,
-                                        const std::wstring& exeName,
-                                        size_t& lineCount)
+// - The compiled target of the matching alias or nullptr if there is none.
+const Alias::CompiledTarget* Alias::s_FindCompiledTarget(std::wstring_view source,
+                                                         const std::wstring_view exeName,
+                                                         Arguments& arguments)
 {
-    // Copy source text into a local for manipulation.
-    auto sourceCopy = sourceText;
-
-    // Trim trailing \r\n off of sourceCopy if it has one.
-    s_TrimTrailingCrLf(sourceCopy);
+    // Trim trailing \r\n off of the source if it has one.
+    const auto trailingCrLfPos = source.find_last_of(UNICODE_CARRIAGERETURN);
+    if (std::wstring_view::npos != trailingCrLfPos)
+    {
+        source = source.substr(0, trailingCrLfPos);
+    }
 
     // Check if we have an EXE in the list that matches the request first.
-    auto exeIter = g_aliasData.find(exeName);
-    if (exeIter == g_aliasData.end())
+    const auto exeIter = g_compiledAliases.find(exeName);
+    if (exeIter == g_compiledAliases.end())
     {
-        // We found no data for this exe. Give back an empty string.
-        return std::wstring();
+        return nullptr;
     }
 
-    auto exeList = exeIter->second;
-    if (exeList.size() == 0)
+    // The alias is the first token of the command line.
+    const auto firstSpace = source.find(L' ');
+    const auto aliasIter = exeIter->second.find(source.substr(0, firstSpace));
+    if (aliasIter == exeIter->second.end())
     {
-        // If there's no match, give back an empty string.
-        return std::wstring();
+        return nullptr;
     }
 
-    // Tokenize the text by spaces
-    const auto tokens = s_Tokenize(sourceCopy);
+    arguments = {};
+    if (std::wstring_view::npos != firstSpace)
+    {
+        // $* is all text after the first space and $1-$9 are the tokens within it.
+        auto remaining = source.substr(firstSpace + 1);
+        til::at(arguments, CompiledTarget::AllArguments) = remaining;
 
-    // If there are no tokens, return an empty string
-    if (tokens.size() == 0)
+        for (size_t i = 1; i < CompiledTarget::AllArguments; ++i)
+        {
+            const auto space = remaining.find(L' ');
+            til::at(arguments, i) = remaining.substr(0, space);
+            if (std::wstring_view::npos == space)
+            {
+                break;
+            }
+            remaining = remaining.substr(space + 1);
+        }
+    }
+
+    return &aliasIter->second;
+}
+
+// Routine Description:
+// - Calculates the length of the expansion of a compiled alias target.
+// Arguments:
+// - compiled - The compiled alias target
+// - arguments - The text of each argument reference, see s_FindCompiledTarget.
+// Return Value:
+// - The number of characters s_Expand will write.
+size_t Alias::s_ExpandedLength(const CompiledTarget& compiled,
+                               const Arguments& arguments) noexcept
+{
+    auto length = compiled.literals.size();
+    for (const auto& segment : compiled.segments)
     {
-        return std::wstring();
+        length += til::at(arguments, segment.argument).size();
     }
+    return length;
+}
 
-    // Find alias. If there isn't one, return an empty string
-    const auto alias = tokens.front();
-    const auto aliasIter = exeList.find(alias);
-    if (aliasIter == exeList.end())
+// Routine Description:
+// - Writes the expansion of a compiled alias target.
+// Arguments:
+// - compiled - The compiled alias target
+// - arguments - The text of each argument reference, see s_FindCompiledTarget.
+// - target - Receives the expansion. Must have room for s_ExpandedLength characters
+//            and must not overlap the text the arguments point into.
+void Alias::s_Expand(const CompiledTarget& compiled,
+                     const Arguments& arguments,
+                     wchar_t* target) noexcept
+{
+    auto literal = compiled.literals.data();
+    for (const auto& segment : compiled.segments)
     {
-        // We found no alias pair with this name. Give back an empty string.
-        return std::wstring();
+        target = std::copy_n(literal, segment.literalLength, target);
+        literal += segment.literalLength;
+
+        const auto& argument = til::at(arguments, segment.argument);
+        target = std::copy_n(argument.data(), argument.size(), target);
     }
+}
 
-    const auto target = aliasIter->second;
-    if (target.size() == 0)
+// Routine Description:
+// - Takes the source text and searches it for an alias belonging to exe name's list.
+// Arguments:
+// - sourceText - The string to search for an alias
+// - exeName - The name of the EXE that has aliases associated
+// - lineCount - Number of lines worth of text processed.
+// Return Value:
+// - If we found a matching alias, this will be the processed data
+//   and lineCount is updated to the new number of lines.
+// - If we didn't match and process an alias, return an empty string.
+std::wstring Alias::s_MatchAndCopyAlias(const std::wstring& sourceText,
+                                        const std::wstring& exeName,
+                                        size_t& lineCount)
+{
+    Arguments arguments;
+    const auto compiled = s_FindCompiledTarget(sourceText, exeName, arguments);
+    if (!compiled)
     {
+        // We found no alias pair with this name. Give back an empty string.
         return std::wstring();
     }
 
-    // Get the string of all parameters as a shorthand for $* later.
-    const auto allParams = s_GetArgString(sourceCopy);
-
-    // The final text will be the target but with macros replaced.
-    auto finalText = target;
-    lineCount = s_ReplaceMacros(finalText, tokens, allParams);
+    std::wstring finalText;
+    finalText.resize(s_ExpandedLength(*compiled, arguments));
+    s_Expand(*compiled, arguments, finalText.data());
+    lineCount = compiled->lineCount;
 
     return finalText;
 }
@@ -1208,28 +1170,40 @@ void Alias::s_MatchAndCopyAliasLegacy(_In_reads_bytes_(cbSource) PCWCH pwchSourc
 {
     try
     {
-        std::wstring sourceText(pwchSource, cbSource / sizeof(WCHAR));
-        size_t lineCount = lines;
+        std::wstring_view sourceText(pwchSource, cbSource / sizeof(WCHAR));
+        const auto cchTargetSize = cbTargetSize / sizeof(wchar_t);
 
-        const auto targetText = s_MatchAndCopyAlias(sourceText, exeName, lineCount);
+        Arguments arguments;
+        auto compiled = s_FindCompiledTarget(sourceText, exeName, arguments);
 
-        // Only return data if the reply was non-empty (we had a match).
-        if (!targetText.empty())
+        // Only return data if we had a match.
+        if (!compiled)
         {
-            const auto cchTargetSize = cbTargetSize / sizeof(wchar_t);
+            return;
+        }
 
-            // If the target text will fit in the result buffer, fill out the results.
-            if (targetText.size() <= cchTargetSize)
-            {
-                // Non-null terminated copy into memory space
-                std::copy_n(targetText.data(), targetText.size(), pwchTarget);
+        // The expansion is written straight into the target, while reading the arguments out of the
+        // source. Cooked reads pass the same buffer for both, in which case we need a copy of the source.
+        til::small_vector<wchar_t, 256> sourceCopy;
+        if (pwchTarget < sourceText.data() + sourceText.size() && sourceText.data() < pwchTarget + cchTargetSize)
+        {
+            sourceCopy.insert(sourceCopy.end(), sourceText.begin(), sourceText.end());
+            sourceText = { sourceCopy.data(), sourceCopy.size() };
+            compiled = s_FindCompiledTarget(sourceText, exeName, arguments);
+        }
 
-                // Return bytes copied.
-                cbTargetWritten = gsl::narrow<ULONG>(targetText.size() * sizeof(wchar_t));
+        // If the target text will fit in the result buffer, fill out the results.
+        const auto cchTarget = s_ExpandedLength(*compiled, arguments);
+        if (cchTarget <= cchTargetSize)
+        {
+            // Non-null terminated copy into memory space
+            s_Expand(*compiled, arguments, pwchTarget);
 
-                // Return lines info.
-                lines = gsl::narrow<DWORD>(lineCount);
-            }
+            // Return bytes copied.
+            cbTargetWritten = gsl::narrow<ULONG>(cchTarget * sizeof(wchar_t));
+
+            // Return lines info.
+            lines = gsl::narrow<DWORD>(compiled->lineCount);
         }
     }
     catch (...)
@@ -1243,12 +1217,15 @@ void Alias::s_TestAddAlias(std::wstring& exe,
                            std::wstring& alias,
                            std::wstring& target)
 {
+    auto compiled = s_CompileTarget(target);
     g_aliasData[exe][alias] = target;
+    g_compiledAliases[exe][alias] = std::move(compiled);
 }
 
 void Alias::s_TestClearAliases()
 {
     g_aliasData.clear();
+    g_compiledAliases.clear();
 }
 
 #endif
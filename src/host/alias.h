@@ -14,6 +14,26 @@ Abstract:
 class Alias
 {
 public:
+    // An alias target with its macros resolved ahead of time, see s_CompileTarget.
+    struct CompiledTarget
+    {
+        // Segment::argument for the $* macro. 1 to 9 stand for $1 to $9 and 0 for no argument.
+        static constexpr uint8_t AllArguments = 10;
+
+        // The next literalLength characters of literals, followed by the given argument.
+        struct Segment
+        {
+            size_t literalLength;
+            uint8_t argument;
+        };
+
+        std::wstring literals;
+        std::vector<Segment> segments;
+        size_t lineCount = 0;
+    };
+
+    static CompiledTarget s_CompileTarget(const std::wstring_view target);
+
     static void s_ClearCmdExeAliases();
 
     static void s_MatchAndCopyAliasLegacy(_In_reads_bytes_(cbSource) PCWCH pwchSource,
@@ -29,19 +49,17 @@ public:
                                             size_t& lineCount);
 
 private:
-    static void s_TrimTrailingCrLf(std::wstring& str);
-    static std::deque<std::wstring> s_Tokenize(const std::wstring& str);
-    static std::wstring s_GetArgString(const std::wstring& str);
-    static size_t s_ReplaceMacros(std::wstring& str,
-                                  const std::deque<std::wstring>& tokens,
-                                  const std::wstring& fullArgString);
-
-    static bool s_TryReplaceNumberedArgMacro(const wchar_t ch,
-                                             std::wstring& appendToStr,
-                                             const std::deque<std::wstring>& tokens);
-    static bool s_TryReplaceWildcardArgMacro(const wchar_t ch,
-                                             std::wstring& appendToStr,
-                                             const std::wstring fullArgString);
+    // The text each argument reference of a CompiledTarget expands to for a given command line.
+    using Arguments = std::array<std::wstring_view, CompiledTarget::AllArguments + 1>;
+
+    static const CompiledTarget* s_FindCompiledTarget(std::wstring_view source,
+                                                      const std::wstring_view exeName,
+                                                      Arguments& arguments);
+    static size_t s_ExpandedLength(const CompiledTarget& compiled,
+                                   const Arguments& arguments) noexcept;
+    static void s_Expand(const CompiledTarget& compiled,
+                         const Arguments& arguments,
+                         wchar_t* target) noexcept;
 
     static bool s_TryReplaceInputRedirMacro(const wchar_t ch,
                                             std::wstring& appendToStr);
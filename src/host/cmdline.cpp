@@ -197,6 +197,29 @@ void CommandLine::EndAllPopups()
     }
 }
 
+// Routine Description:
+// - Returns the number of cells DeleteCommandLine blanks to erase a line that occupied visibleCharCount
+//   cells, starting at the original cursor position. That's one more cell than the line occupied,
+//   unless its text bisects a full-width character at the end of the first row.
+// Arguments:
+// - cookedReadData - The cooked read whose edit line is being erased.
+// - visibleCharCount - The number of cells the line occupied on the screen.
+// Return Value:
+// - The number of cells to blank.
+size_t GetCommandLineDeleteLength(COOKED_READ_DATA& cookedReadData, const size_t visibleCharCount) noexcept
+{
+    const auto bufferWidth = cookedReadData.ScreenInfo().GetBufferSize().Width();
+
+    if (!CheckBisectStringW(cookedReadData.BufferStartPtr(),
+                            visibleCharCount,
+                            bufferWidth - cookedReadData.OriginalCursorPosition().x))
+    {
+        return visibleCharCount + 1;
+    }
+
+    return visibleCharCount;
+}
+
 void DeleteCommandLine(COOKED_READ_DATA& cookedReadData, const bool fUpdateFields)
 {
     auto CharsToWrite = cookedReadData.VisibleCharCount();
@@ -214,12 +237,7 @@ void DeleteCommandLine(COOKED_READ_DATA& cookedReadData, const bool fUpdateField
         coordOriginalCursor.y = 0;
     }
 
-    if (!CheckBisectStringW(cookedReadData.BufferStartPtr(),
-                            CharsToWrite,
-                            coordBufferSize.width - cookedReadData.OriginalCursorPosition().x))
-    {
-        CharsToWrite++;
-    }
+    CharsToWrite = GetCommandLineDeleteLength(cookedReadData, CharsToWrite);
 
     try
     {
@@ -1036,12 +1054,6 @@ til::point CommandLine::DeleteFromRightOfCursor(COOKED_READ_DATA& cookedReadData
 
     if (!cookedReadData.AtEol())
     {
-        // Delete commandline.
-        // clang-format off
-#pragma prefast(suppress: __WARNING_BUFFER_OVERFLOW, "Not sure why prefast is getting confused here")
-        // clang-format on
-        DeleteCommandLine(cookedReadData, false);
-
         // Delete char.
         cookedReadData.BytesRead() -= sizeof(WCHAR);
         memmove(cookedReadData.BufferCurrentPtr(),
@@ -1053,18 +1065,12 @@ til::point CommandLine::DeleteFromRightOfCursor(COOKED_READ_DATA& cookedReadData
             *buf = (WCHAR)' ';
         }
 
-        // Write commandline.
+        // Write the part of the commandline behind the cursor.
         if (cookedReadData.IsEchoInput())
         {
-            FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          &cookedReadData.BytesRead(),
-                                                          &cookedReadData.VisibleCharCount(),
-                                                          cookedReadData.OriginalCursorPosition().x,
-                                                          WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                          nullptr));
+            FAIL_FAST_IF_NTSTATUS_FAILED(cookedReadData.RedrawFrom(cookedReadData.InsertionPoint(),
+                                                                   WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
+                                                                   nullptr));
         }
 
         // restore cursor position
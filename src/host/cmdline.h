@@ -126,6 +126,8 @@ private:
     bool _isVisible;
 };
 
+size_t GetCommandLineDeleteLength(COOKED_READ_DATA& cookedReadData, const size_t visibleCharCount) noexcept;
+
 void DeleteCommandLine(COOKED_READ_DATA& cookedReadData, const bool fUpdateFields);
 
 void RedrawCommandLine(COOKED_READ_DATA& cookedReadData);
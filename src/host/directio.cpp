@@ -130,8 +130,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 //   from the input buffer and in the peek case they are not.
 // Arguments:
 // - pInputBuffer - The input buffer to take records from to return to the client
-// - outEvents - The storage location to fill with input events
-// - eventReadCount - The number of events to read
+// - outRecords - The storage location to fill with input events. Its size is the number of events to read.
+// - eventsRead - On output, the number of events stored in outRecords
 // - pInputReadHandleData - A structure that will help us maintain
 // some input context across various calls on the same input
 // handle. Primarily used to restore the "other piece" of partially
@@ -150,8 +150,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 // block, this will be returned along with context in *ppWaiter.
 // - Or an out of memory/math/string error message in NTSTATUS format.
 [[nodiscard]] static NTSTATUS _DoGetConsoleInput(InputBuffer& inputBuffer,
-                                                 std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                 const size_t eventReadCount,
+                                                 const std::span<INPUT_RECORD> outRecords,
+                                                 size_t& eventsRead,
                                                  INPUT_READ_HANDLE_DATA& readHandleState,
                                                  const bool IsUnicode,
                                                  const bool IsPeek,
@@ -160,8 +160,9 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
     try
     {
         waiter.reset();
+        eventsRead = 0;
 
-        if (eventReadCount == 0)
+        if (outRecords.empty())
         {
             return STATUS_SUCCESS;
         }
@@ -178,14 +179,11 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
             }
         }
 
-        size_t amountToRead;
-        if (FAILED(SizeTSub(eventReadCount, partialEvents.size(), &amountToRead)))
-        {
-            return STATUS_INTEGER_OVERFLOW;
-        }
-        std::deque<std::unique_ptr<IInputEvent>> readEvents;
-        auto Status = inputBuffer.Read(readEvents,
-                                       amountToRead,
+        // the partial byte sequence goes first, the events read from the input buffer after it.
+        const auto readRecords = outRecords.subspan(partialEvents.size());
+        size_t recordsRead;
+        auto Status = inputBuffer.Read(readRecords,
+                                       recordsRead,
                                        IsPeek,
                                        true,
                                        IsUnicode,
@@ -193,12 +191,12 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 
         if (CONSOLE_STATUS_WAIT == Status)
         {
-            FAIL_FAST_IF(!(readEvents.empty()));
+            FAIL_FAST_IF(recordsRead != 0);
             // If we're told to wait until later, move all of our context
             // to the read data object and send it back up to the server.
             waiter = std::make_unique<DirectReadData>(&inputBuffer,
                                                       &readHandleState,
-                                                      eventReadCount,
+                                                      outRecords.size(),
                                                       std::move(partialEvents));
         }
         else if (NT_SUCCESS(Status))
@@ -208,36 +206,24 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
             {
                 try
                 {
-                    SplitToOem(readEvents);
+                    std::unique_ptr<IInputEvent> partialEvent;
+                    recordsRead = SplitToOem(readRecords, recordsRead, partialEvent);
+
+                    // store partial event if necessary
+                    if (partialEvent)
+                    {
+                        inputBuffer.StoreReadPartialByteSequence(std::move(partialEvent));
+                    }
                 }
                 CATCH_LOG();
             }
 
-            // combine partial and readEvents
-            while (!partialEvents.empty())
-            {
-                readEvents.push_front(std::move(partialEvents.back()));
-                partialEvents.pop_back();
-            }
-
-            // move events over
-            for (size_t i = 0; i < eventReadCount; ++i)
+            for (size_t i = 0; i < partialEvents.size(); ++i)
             {
-                if (readEvents.empty())
-                {
-                    break;
-                }
-                outEvents.push_back(std::move(readEvents.front()));
-                readEvents.pop_front();
+                til::at(outRecords, i) = partialEvents[i]->ToInputRecord();
             }
 
-            // store partial event if necessary
-            if (!readEvents.empty())
-            {
-                inputBuffer.StoreReadPartialByteSequence(std::move(readEvents.front()));
-                readEvents.pop_front();
-                FAIL_FAST_IF(!(readEvents.empty()));
-            }
+            eventsRead = partialEvents.size() + recordsRead;
         }
         return Status;
     }
@@ -253,8 +239,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 // - The A version will convert to W using the console's current Input codepage (see SetConsoleCP)
 // Arguments:
 // - context - The input buffer to take records from to return to the client
-// - outEvents - storage location for read events
-// - eventsToRead - The number of input events to read
+// - outRecords - storage location for read events. Its size is the number of input events to read.
+// - eventsRead - on output, the number of events stored in outRecords
 // - readHandleState - A structure that will help us maintain
 // some input context across various calls on the same input
 // handle. Primarily used to restore the "other piece" of partially
@@ -264,16 +250,16 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 // buffer), this contains context that will allow the server to
 // restore this call later.
 [[nodiscard]] HRESULT ApiRoutines::PeekConsoleInputAImpl(IConsoleInputObject& context,
-                                                         std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                         const size_t eventsToRead,
+                                                         std::span<INPUT_RECORD> outRecords,
+                                                         size_t& eventsRead,
                                                          INPUT_READ_HANDLE_DATA& readHandleState,
                                                          std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
     try
     {
         auto Status = _DoGetConsoleInput(context,
-                                         outEvents,
-                                         eventsToRead,
+                                         outRecords,
+                                         eventsRead,
                                          readHandleState,
                                          false,
                                          true,
@@ -293,8 +279,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 // - The W version accepts UCS-2 formatted characters (wide characters)
 // Arguments:
 // - context - The input buffer to take records from to return to the client
-// - outEvents - storage location for read events
-// - eventsToRead - The number of input events to read
+// - outRecords - storage location for read events. Its size is the number of input events to read.
+// - eventsRead - on output, the number of events stored in outRecords
 // - readHandleState - A structure that will help us maintain
 // some input context across various calls on the same input
 // handle. Primarily used to restore the "other piece" of partially
@@ -304,16 +290,16 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 // buffer), this contains context that will allow the server to
 // restore this call later.
 [[nodiscard]] HRESULT ApiRoutines::PeekConsoleInputWImpl(IConsoleInputObject& context,
-                                                         std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                         const size_t eventsToRead,
+                                                         std::span<INPUT_RECORD> outRecords,
+                                                         size_t& eventsRead,
                                                          INPUT_READ_HANDLE_DATA& readHandleState,
                                                          std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
     try
     {
         auto Status = _DoGetConsoleInput(context,
-                                         outEvents,
-                                         eventsToRead,
+                                         outRecords,
+                                         eventsRead,
                                          readHandleState,
                                          true,
                                          true,
@@ -333,8 +319,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 // - The A version will convert to W using the console's current Input codepage (see SetConsoleCP)
 // Arguments:
 // - context - The input buffer to take records from to return to the client
-// - outEvents - storage location for read events
-// - eventsToRead - The number of input events to read
+// - outRecords - storage location for read events. Its size is the number of input events to read.
+// - eventsRead - on output, the number of events stored in outRecords
 // - readHandleState - A structure that will help us maintain
 // some input context across various calls on the same input
 // handle. Primarily used to restore the "other piece" of partially
@@ -344,16 +330,16 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 // buffer), this contains context that will allow the server to
 // restore this call later.
 [[nodiscard]] HRESULT ApiRoutines::ReadConsoleInputAImpl(IConsoleInputObject& context,
-                                                         std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                         const size_t eventsToRead,
+                                                         std::span<INPUT_RECORD> outRecords,
+                                                         size_t& eventsRead,
                                                          INPUT_READ_HANDLE_DATA& readHandleState,
                                                          std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
     try
     {
         auto Status = _DoGetConsoleInput(context,
-                                         outEvents,
-                                         eventsToRead,
+                                         outRecords,
+                                         eventsRead,
                                          readHandleState,
                                          false,
                                          false,
@@ -373,8 +359,8 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 // - The W version accepts UCS-2 formatted characters (wide characters)
 // Arguments:
 // - context - The input buffer to take records from to return to the client
-// - outEvents - storage location for read events
-// - eventsToRead - The number of input events to read
+// - outRecords - storage location for read events. Its size is the number of input events to read.
+// - eventsRead - on output, the number of events stored in outRecords
 // - readHandleState - A structure that will help us maintain
 // some input context across various calls on the same input
 // handle. Primarily used to restore the "other piece" of partially
@@ -384,16 +370,16 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 // buffer), this contains context that will allow the server to
 // restore this call later.
 [[nodiscard]] HRESULT ApiRoutines::ReadConsoleInputWImpl(IConsoleInputObject& context,
-                                                         std::deque<std::unique_ptr<IInputEvent>>& outEvents,
-                                                         const size_t eventsToRead,
+                                                         std::span<INPUT_RECORD> outRecords,
+                                                         size_t& eventsRead,
                                                          INPUT_READ_HANDLE_DATA& readHandleState,
                                                          std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
     try
     {
         auto Status = _DoGetConsoleInput(context,
-                                         outEvents,
-                                         eventsToRead,
+                                         outRecords,
+                                         eventsRead,
                                          readHandleState,
                                          true,
                                          false,
@@ -507,9 +493,34 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 
     try
     {
-        auto events = IInputEvent::Create(buffer);
+        // IInputEvent::Create used to reject these while converting the records.
+        // The records are stored as they are now, so we need to check them ourselves.
+        for (const auto& record : buffer)
+        {
+            switch (record.EventType)
+            {
+            case KEY_EVENT:
+            case MOUSE_EVENT:
+            case WINDOW_BUFFER_SIZE_EVENT:
+            case MENU_EVENT:
+            case FOCUS_EVENT:
+                break;
+            default:
+                return E_INVALIDARG;
+            }
+        }
 
-        return _WriteConsoleInputWImplHelper(context, events, written, append);
+        // add to InputBuffer
+        if (append)
+        {
+            written = context.Write(buffer);
+        }
+        else
+        {
+            written = context.Prepend(buffer);
+        }
+
+        return S_OK;
     }
     CATCH_RETURN();
 }
@@ -728,7 +739,6 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 {
     try
     {
-        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
         const auto& storageBuffer = context.GetActiveBuffer().GetTextBuffer();
         const auto storageSize = storageBuffer.GetSize().Dimensions();
 
@@ -763,44 +773,21 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
         // The final "request rectangle" or the area inside the buffer we want to read, is the clipped dimensions.
         const auto clippedRequestRectangle = Viewport::FromExclusive(clip);
 
-        // We will start reading the buffer at the point of the top left corner (origin) of the (potentially adjusted) request
-        const auto sourcePoint = clippedRequestRectangle.Origin();
-
-        // Get an iterator to the beginning of the return buffer
-        // We might have to seek this forward or skip around if we clipped the request.
-        auto targetIter = targetBuffer.begin();
-        til::point targetPos;
-        const auto targetLimit = Viewport::FromDimensions(targetPoint, clippedRequestRectangle.Dimensions());
-
-        // Get an iterator to the beginning of the request inside the screen buffer
-        // This should walk exactly along every cell of the clipped request.
-        auto sourceIter = storageBuffer.GetCellDataAt(sourcePoint, clippedRequestRectangle);
-
-        // Walk through every cell of the target, advancing the buffer.
-        // Validate that we always still have a valid iterator to the backing store,
-        // that we always are writing inside the user's buffer (before the end)
-        // and we're always targeting the user's buffer inside its original bounds.
-        while (sourceIter && targetIter < targetBuffer.end())
+        // Convert the clipped request one row slice at a time. Each slice of the user's buffer
+        // starts at the target point (which skips the clipped columns/rows) and is as wide as
+        // the clipped request. Cells of the user's buffer outside of it are left untouched.
+        const auto clippedWidth = gsl::narrow_cast<size_t>(std::max(0, clippedRequestRectangle.Width()));
+        for (til::CoordType y = 0; y < clippedRequestRectangle.Height(); ++y)
         {
-            // If the point we're trying to write is inside the limited buffer write zone...
-            if (targetLimit.IsInBounds(targetPos))
+            const auto targetOffset = gsl::narrow_cast<size_t>((targetPoint.y + y) * targetSize.width + targetPoint.x);
+            if (targetOffset >= targetBuffer.size())
             {
-                // Copy the data into position...
-                *targetIter = gci.AsCharInfo(*sourceIter);
-                // ... and advance the read iterator.
-                ++sourceIter;
+                break;
             }
 
-            // Always advance the write iterator, we might have skipped it due to clipping.
-            ++targetIter;
-
-            // Increment the target
-            targetPos.x++;
-            if (targetPos.x >= targetSize.width)
-            {
-                targetPos.x = 0;
-                targetPos.y++;
-            }
+            const auto target = targetBuffer.subspan(targetOffset, std::min(clippedWidth, targetBuffer.size() - targetOffset));
+            const auto& row = storageBuffer.GetRowByOffset(clippedRequestRectangle.Top() + y);
+            row.ReadCharInfos(clippedRequestRectangle.Left(), target);
         }
 
         // Reply with the region we read out of the backing buffer (potentially clipped)
@@ -926,6 +913,7 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
 
         const auto writeRectangle = Viewport::FromInclusive(writeRegion);
 
+        auto& textBuffer = storageBuffer.GetTextBuffer();
         auto target = writeRectangle.Origin();
 
         // For every row in the request, create a view into the clamped portion of just the one line to write.
@@ -944,9 +932,35 @@ void EventsToUnicode(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
             // Convert to a CHAR_INFO view to fit into the iterator
             const auto charInfos = std::span<const CHAR_INFO>(subspan.data(), subspan.size());
 
-            // Make the iterator and write to the target position.
-            OutputCellIterator it(charInfos);
-            storageBuffer.Write(it, target);
+            // Most cells are narrow and those are written into the row in bulk. Runs of cells marked as
+            // leading/trailing bytes go through the regular cell iterator, which knows how to pad
+            // wide glyphs that don't fit and how to continue them on the next row.
+            auto& row = textBuffer.GetRowByOffset(target.y);
+            size_t beg = 0;
+            while (beg < charInfos.size())
+            {
+                const auto isNarrow = WI_AreAllFlagsClear(til::at(charInfos, beg).Attributes, COMMON_LVB_SBCSDBCS);
+                auto end = beg + 1;
+                while (end < charInfos.size() && WI_AreAllFlagsClear(til::at(charInfos, end).Attributes, COMMON_LVB_SBCSDBCS) == isNarrow)
+                {
+                    ++end;
+                }
+
+                const auto column = target.x + gsl::narrow_cast<til::CoordType>(beg);
+                const auto run = charInfos.subspan(beg, end - beg);
+                if (isNarrow)
+                {
+                    row.WriteNarrowCharInfos(column, run);
+                }
+                else
+                {
+                    OutputCellIterator it(run);
+                    storageBuffer.Write(it, { column, target.y });
+                }
+                beg = end;
+            }
+
+            textBuffer.TriggerRedraw(Viewport::FromDimensions(target, { writeRectangle.Width(), 1 }));
         }
 
         // Since we've managed to write part of the request, return the clamped part that we actually used.
@@ -0,0 +1,237 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "ReplayDeviceComm.hpp"
+#include "../../server/ApiMessage.h"
+
+// Messages are serialized as a ULONG function, a ULONG output size, a ULONG flags
+// field (bit 0: use the input handle), a ULONG input size and the input itself.
+static constexpr ULONG s_useInputHandleFlag = 1;
+
+ULONG ReplayMessage::ApiNumber() const noexcept
+{
+    if (function == CONSOLE_IO_USER_DEFINED && input.size() >= sizeof(CONSOLE_MSG_HEADER))
+    {
+        return reinterpret_cast<const CONSOLE_MSG_HEADER*>(input.data())->ApiNumber;
+    }
+    return function;
+}
+
+void ReplayMessage::Serialize(std::vector<BYTE>& stream) const
+{
+    const auto append = [&](const ULONG value) {
+        const auto bytes = reinterpret_cast<const BYTE*>(&value);
+        stream.insert(stream.end(), bytes, bytes + sizeof(value));
+    };
+
+    append(function);
+    append(outputSize);
+    append(useInputHandle ? s_useInputHandleFlag : 0);
+    append(gsl::narrow<ULONG>(input.size()));
+    stream.insert(stream.end(), input.begin(), input.end());
+}
+
+std::vector<ReplayMessage> ReplayMessage::s_Deserialize(std::span<const BYTE> stream)
+{
+    std::vector<ReplayMessage> messages;
+
+    const auto read = [&]() {
+        THROW_HR_IF(E_UNEXPECTED, stream.size() < sizeof(ULONG));
+        ULONG value;
+        memcpy(&value, stream.data(), sizeof(value));
+        stream = stream.subspan(sizeof(value));
+        return value;
+    };
+
+    while (!stream.empty())
+    {
+        auto& message = messages.emplace_back();
+        message.function = read();
+        message.outputSize = read();
+        message.useInputHandle = WI_IsFlagSet(read(), s_useInputHandleFlag);
+        const auto inputSize = read();
+        THROW_HR_IF(E_UNEXPECTED, stream.size() < inputSize);
+        message.input.assign(stream.begin(), stream.begin() + inputSize);
+        stream = stream.subspan(inputSize);
+    }
+
+    return messages;
+}
+
+// Routine Description:
+// - Sets the handles that replayed messages refer to. Recorded streams can't contain
+//   them, because they're pointers into the console host that recorded them.
+void ReplayDeviceComm::SetHandles(const ULONG_PTR process, const ULONG_PTR input, const ULONG_PTR output) noexcept
+{
+    _process = process;
+    _input = input;
+    _output = output;
+}
+
+// Routine Description:
+// - Hands the given messages to the console IO thread and waits until all of them have been completed.
+// - Messages that pend (like a ReadConsole without any input) will never complete. Don't replay them.
+// Arguments:
+// - messages - The messages to replay. Must stay alive until this function returns.
+// - iterations - How often to replay the messages.
+// Return Value:
+// - The time it took to replay all messages.
+std::chrono::nanoseconds ReplayDeviceComm::Replay(const std::vector<ReplayMessage>& messages, const size_t iterations)
+{
+    std::unique_lock lock{ _mutex };
+
+    _messages = &messages;
+    _next = 0;
+    _completed = 0;
+    _total = messages.size() * iterations;
+    _started.resize(_total);
+
+    const auto start = std::chrono::steady_clock::now();
+    _cv.notify_all();
+    _cv.wait(lock, [&]() { return _completed == _total; });
+    const auto end = std::chrono::steady_clock::now();
+
+    _messages = nullptr;
+    _total = 0;
+    return end - start;
+}
+
+std::map<ULONG, ReplayDeviceComm::ApiStats> ReplayDeviceComm::GetStats() const
+{
+    const std::lock_guard lock{ _mutex };
+    return _stats;
+}
+
+uint64_t ReplayDeviceComm::GetBytesWritten() const noexcept
+{
+    const std::lock_guard lock{ _mutex };
+    return _bytesWritten;
+}
+
+void ReplayDeviceComm::ResetStats() noexcept
+{
+    const std::lock_guard lock{ _mutex };
+    _stats.clear();
+    _bytesWritten = 0;
+}
+
+[[nodiscard]] HRESULT ReplayDeviceComm::SetServerInformation(_In_ CD_IO_SERVER_INFORMATION* const /*pServerInfo*/) const
+{
+    return S_OK;
+}
+
+// Routine Description:
+// - Completes the previous message (if any) and blocks until the next one is available.
+// - Just like the console driver, the message header and API descriptor are copied into
+//   the message itself. The payload has to be read separately with ReadInput.
+[[nodiscard]] HRESULT ReplayDeviceComm::ReadIo(_In_opt_ PCONSOLE_API_MSG const pReplyMsg,
+                                               _Out_ CONSOLE_API_MSG* const pMessage) const
+try
+{
+    if (pReplyMsg)
+    {
+        _Complete(pReplyMsg->Complete);
+    }
+
+    std::unique_lock lock{ _mutex };
+    _cv.wait(lock, [&]() { return _next < _total; });
+
+    const auto sequence = _next++;
+    const auto& message = til::at(*_messages, sequence % _messages->size());
+
+    auto& descriptor = pMessage->Descriptor;
+    descriptor = {};
+    descriptor.Identifier.LowPart = gsl::narrow<DWORD>(sequence);
+    descriptor.Process = _process;
+    descriptor.Object = message.useInputHandle ? _input : _output;
+    descriptor.Function = message.function;
+    descriptor.InputSize = gsl::narrow<ULONG>(message.input.size());
+    descriptor.OutputSize = message.outputSize;
+
+    const auto packet = reinterpret_cast<BYTE*>(&pMessage->Descriptor + 1);
+    const auto packetCapacity = sizeof(CONSOLE_API_MSG) - gsl::narrow_cast<size_t>(packet - reinterpret_cast<BYTE*>(pMessage));
+    memcpy(packet, message.input.data(), std::min(message.input.size(), packetCapacity));
+
+    til::at(_started, sequence) = std::chrono::steady_clock::now();
+    return S_OK;
+}
+CATCH_RETURN()
+
+[[nodiscard]] HRESULT ReplayDeviceComm::CompleteIo(_In_ CD_IO_COMPLETE* const pCompletion) const
+try
+{
+    _Complete(*pCompletion);
+    return S_OK;
+}
+CATCH_RETURN()
+
+[[nodiscard]] HRESULT ReplayDeviceComm::ReadInput(_In_ CD_IO_OPERATION* const pIoOperation) const
+try
+{
+    const std::lock_guard lock{ _mutex };
+    const auto& input = _GetMessage(pIoOperation->Identifier).input;
+    const auto offset = pIoOperation->Buffer.Offset;
+    const auto size = pIoOperation->Buffer.Size;
+
+    RETURN_HR_IF(E_INVALIDARG, offset > input.size() || size > input.size() - offset);
+    memcpy(pIoOperation->Buffer.Data, input.data() + offset, size);
+    return S_OK;
+}
+CATCH_RETURN()
+
+// Routine Description:
+// - A real client would receive this output. We only count the bytes.
+[[nodiscard]] HRESULT ReplayDeviceComm::WriteOutput(_In_ CD_IO_OPERATION* const pIoOperation) const
+{
+    const std::lock_guard lock{ _mutex };
+    _bytesWritten += pIoOperation->Buffer.Size;
+    return S_OK;
+}
+
+[[nodiscard]] HRESULT ReplayDeviceComm::AllowUIAccess() const
+{
+    return S_OK;
+}
+
+[[nodiscard]] ULONG_PTR ReplayDeviceComm::PutHandle(const void* handle)
+{
+    return reinterpret_cast<ULONG_PTR>(handle);
+}
+
+[[nodiscard]] void* ReplayDeviceComm::GetHandle(ULONG_PTR handleId) const
+{
+    return reinterpret_cast<void*>(handleId);
+}
+
+[[nodiscard]] HRESULT ReplayDeviceComm::GetServerHandle(_Out_ HANDLE* pHandle) const
+{
+    *pHandle = nullptr;
+    return E_NOTIMPL;
+}
+
+const ReplayMessage& ReplayDeviceComm::_GetMessage(const LUID& identifier) const
+{
+    THROW_HR_IF(E_UNEXPECTED, !_messages || identifier.LowPart >= _next);
+    return til::at(*_messages, identifier.LowPart % _messages->size());
+}
+
+void ReplayDeviceComm::_Complete(const CD_IO_COMPLETE& completion) const
+{
+    const auto end = std::chrono::steady_clock::now();
+
+    const std::lock_guard lock{ _mutex };
+    const auto sequence = completion.Identifier.LowPart;
+    const auto elapsed = end - til::at(_started, sequence);
+    auto& stats = _stats[_GetMessage(completion.Identifier).ApiNumber()];
+
+    stats.count++;
+    stats.total += elapsed;
+    stats.max = std::max<std::chrono::nanoseconds>(stats.max, elapsed);
+
+    if (++_completed == _total)
+    {
+        _cv.notify_all();
+    }
+}
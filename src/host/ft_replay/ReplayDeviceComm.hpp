@@ -0,0 +1,92 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ReplayDeviceComm.hpp
+
+Abstract:
+- An in-memory implementation of IDeviceComm. Instead of reading messages from
+  the console driver, it hands a prerecorded stream of console API messages to
+  the console IO thread and measures how long each of them took to be serviced.
+- This allows us to benchmark the API dispatch path of the console host,
+  reproducibly and without a client process on the other end.
+--*/
+
+#pragma once
+
+#include "../../server/DeviceComm.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// A single recorded message, in the form the console driver presents it to us.
+struct ReplayMessage
+{
+    ULONG function = CONSOLE_IO_USER_DEFINED;
+    // The message's input: the CONSOLE_MSG_HEADER, the API descriptor and any payload.
+    std::vector<BYTE> input;
+    // The size of the client's output buffer, including the API descriptor.
+    ULONG outputSize = 0;
+    // Whether the message refers to the input handle instead of the output handle.
+    bool useInputHandle = false;
+
+    ULONG ApiNumber() const noexcept;
+
+    void Serialize(std::vector<BYTE>& stream) const;
+    static std::vector<ReplayMessage> s_Deserialize(std::span<const BYTE> stream);
+};
+
+class ReplayDeviceComm : public IDeviceComm
+{
+public:
+    struct ApiStats
+    {
+        uint64_t count = 0;
+        std::chrono::nanoseconds total{};
+        std::chrono::nanoseconds max{};
+    };
+
+    void SetHandles(const ULONG_PTR process, const ULONG_PTR input, const ULONG_PTR output) noexcept;
+    std::chrono::nanoseconds Replay(const std::vector<ReplayMessage>& messages, const size_t iterations);
+    std::map<ULONG, ApiStats> GetStats() const;
+    uint64_t GetBytesWritten() const noexcept;
+    void ResetStats() noexcept;
+
+    [[nodiscard]] HRESULT SetServerInformation(_In_ CD_IO_SERVER_INFORMATION* const pServerInfo) const override;
+    [[nodiscard]] HRESULT ReadIo(_In_opt_ PCONSOLE_API_MSG const pReplyMsg,
+                                 _Out_ CONSOLE_API_MSG* const pMessage) const override;
+    [[nodiscard]] HRESULT CompleteIo(_In_ CD_IO_COMPLETE* const pCompletion) const override;
+
+    [[nodiscard]] HRESULT ReadInput(_In_ CD_IO_OPERATION* const pIoOperation) const override;
+    [[nodiscard]] HRESULT WriteOutput(_In_ CD_IO_OPERATION* const pIoOperation) const override;
+
+    [[nodiscard]] HRESULT AllowUIAccess() const override;
+
+    [[nodiscard]] ULONG_PTR PutHandle(const void*) override;
+    [[nodiscard]] void* GetHandle(ULONG_PTR) const override;
+
+    [[nodiscard]] HRESULT GetServerHandle(_Out_ HANDLE* pHandle) const override;
+
+private:
+    const ReplayMessage& _GetMessage(const LUID& identifier) const;
+    void _Complete(const CD_IO_COMPLETE& completion) const;
+
+    ULONG_PTR _process = 0;
+    ULONG_PTR _input = 0;
+    ULONG_PTR _output = 0;
+
+    // The IO thread calls into us through the const methods of IDeviceComm.
+    mutable std::mutex _mutex;
+    mutable std::condition_variable _cv;
+    const std::vector<ReplayMessage>* _messages = nullptr;
+    mutable size_t _next = 0;
+    mutable size_t _completed = 0;
+    size_t _total = 0;
+    mutable std::vector<std::chrono::steady_clock::time_point> _started;
+    mutable std::map<ULONG, ApiStats> _stats;
+    mutable uint64_t _bytesWritten = 0;
+};
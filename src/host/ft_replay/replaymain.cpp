@@ -0,0 +1,1008 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// A benchmark driver for the console API dispatch path. It boots a console host
+// on top of ReplayDeviceComm and replays synthetic (or previously saved) streams
+// of console API messages, reporting the latency and throughput of each API.
+
+#include "precomp.h"
+
+#include "ReplayDeviceComm.hpp"
+
+#include "../alias.h"
+#include "../ConsoleArguments.hpp"
+#include "../history.h"
+#include "../srvinit.h"
+#include "../../server/Entrypoints.h"
+#include "../../interactivity/inc/ServiceLocator.hpp"
+#include "../../server/IoThread.h"
+#include "../../terminal/adapter/InteractDispatch.hpp"
+#include "../../terminal/parser/InputStateMachineEngine.hpp"
+#include "../../terminal/parser/base64.hpp"
+#include "../../terminal/parser/stateMachine.hpp"
+
+#include <fstream>
+
+using Microsoft::Console::Interactivity::ServiceLocator;
+using namespace Microsoft::Console::VirtualTerminal;
+
+static ReplayDeviceComm* s_deviceComm = nullptr;
+
+[[nodiscard]] static HRESULT StartReplayConsole(const ConsoleArguments* const args)
+{
+    auto& globals = ServiceLocator::LocateGlobals();
+    s_deviceComm = new ReplayDeviceComm{}; // quickly, before we "connect". Leak this.
+    globals.pDeviceComm = s_deviceComm;
+
+    // it is safe to pass INVALID_HANDLE_VALUE here because the null handle would have been detected
+    // in ConDrvDeviceComm (which has been avoided by setting a global device comm beforehand)
+    RETURN_IF_NTSTATUS_FAILED(ConsoleCreateIoThreadLegacy(INVALID_HANDLE_VALUE, args));
+
+    auto& gci = globals.getConsoleInformation();
+
+    // Process handle list manipulation must be done under lock
+    gci.LockConsole();
+    auto unlock = wil::scope_exit([&]() { gci.UnlockConsole(); });
+
+    ConsoleProcessHandle* pProcessHandle{ nullptr };
+    RETURN_IF_FAILED(gci.ProcessHandleList.AllocProcessData(GetCurrentProcessId(),
+                                                            GetCurrentThreadId(),
+                                                            0,
+                                                            &pProcessHandle));
+    pProcessHandle->fRootProcess = true;
+
+    constexpr static std::wstring_view fakeTitle{ L"Replay Harness" };
+
+    CONSOLE_API_CONNECTINFO fakeConnectInfo{};
+    fakeConnectInfo.ConsoleInfo.SetShowWindow(SW_NORMAL);
+    fakeConnectInfo.ConsoleInfo.SetScreenBufferSize({ 200, 9001 });
+    fakeConnectInfo.ConsoleInfo.SetWindowSize({ 120, 30 });
+    fakeConnectInfo.ConsoleInfo.SetStartupFlags(STARTF_USECOUNTCHARS);
+    wcscpy_s(fakeConnectInfo.Title, fakeTitle.data());
+    fakeConnectInfo.TitleLength = gsl::narrow_cast<DWORD>(fakeTitle.size() * sizeof(wchar_t)); // bytes, not wchars
+    wcscpy_s(fakeConnectInfo.AppName, fakeTitle.data());
+    fakeConnectInfo.AppNameLength = gsl::narrow_cast<DWORD>(fakeTitle.size() * sizeof(wchar_t)); // bytes, not wchars
+    fakeConnectInfo.ConsoleApp = TRUE;
+    fakeConnectInfo.WindowVisible = TRUE;
+    RETURN_IF_NTSTATUS_FAILED(ConsoleAllocateConsole(&fakeConnectInfo));
+    WI_SetFlag(gci.Flags, CONSOLE_INITIALIZED);
+
+    CommandHistory::s_Allocate(fakeTitle, (HANDLE)pProcessHandle);
+
+    // Same as the handles a client receives during ConsoleHandleConnectionRequest.
+    RETURN_IF_FAILED(gci.pInputBuffer->AllocateIoHandle(ConsoleHandleData::HandleType::Input,
+                                                        GENERIC_READ | GENERIC_WRITE,
+                                                        FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                                        pProcessHandle->pInputHandle));
+    RETURN_IF_FAILED(gci.GetActiveOutputBuffer().GetMainBuffer().AllocateIoHandle(ConsoleHandleData::HandleType::Output,
+                                                                                  GENERIC_READ | GENERIC_WRITE,
+                                                                                  FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                                                                  pProcessHandle->pOutputHandle));
+
+    s_deviceComm->SetHandles(reinterpret_cast<ULONG_PTR>(pProcessHandle),
+                             reinterpret_cast<ULONG_PTR>(pProcessHandle->pInputHandle.get()),
+                             reinterpret_cast<ULONG_PTR>(pProcessHandle->pOutputHandle.get()));
+    return S_OK;
+}
+
+// Builds a console API message the same way the client side of the console driver does:
+// the message header, followed by the API descriptor, followed by the payload.
+template<typename T>
+static ReplayMessage makeApiMessage(const ULONG apiNumber, const T& body, std::span<const std::byte> payload = {}, const size_t outputPayloadSize = 0, const bool useInputHandle = false)
+{
+    const CONSOLE_MSG_HEADER header{ apiNumber, gsl::narrow<ULONG>(sizeof(T)) };
+
+    ReplayMessage message;
+    message.useInputHandle = useInputHandle;
+    message.outputSize = gsl::narrow<ULONG>(sizeof(T) + outputPayloadSize);
+    message.input.resize(sizeof(header) + sizeof(T) + payload.size());
+    memcpy(message.input.data(), &header, sizeof(header));
+    memcpy(message.input.data() + sizeof(header), &body, sizeof(T));
+    if (!payload.empty())
+    {
+        memcpy(message.input.data() + sizeof(header) + sizeof(T), payload.data(), payload.size());
+    }
+    return message;
+}
+
+static ReplayMessage makeWriteConsole(const std::wstring_view text)
+{
+    CONSOLE_WRITECONSOLE_MSG body{};
+    body.Unicode = TRUE;
+    return makeApiMessage(ConsolepWriteConsole, body, std::as_bytes(std::span{ text }));
+}
+
+static ReplayMessage makeSetTextAttribute(const USHORT attributes)
+{
+    CONSOLE_SETTEXTATTRIBUTE_MSG body{};
+    body.Attributes = attributes;
+    return makeApiMessage(ConsolepSetTextAttribute, body);
+}
+
+static ReplayMessage makeSetCursorPosition(const SHORT x, const SHORT y)
+{
+    CONSOLE_SETCURSORPOSITION_MSG body{};
+    body.CursorPosition = { x, y };
+    return makeApiMessage(ConsolepSetCursorPosition, body);
+}
+
+static ReplayMessage makeFillConsoleOutput(const ULONG elementType, const USHORT element, const SHORT y, const ULONG length)
+{
+    CONSOLE_FILLCONSOLEOUTPUT_MSG body{};
+    body.WriteCoord = { 0, y };
+    body.ElementType = elementType;
+    body.Element = element;
+    body.Length = length;
+    return makeApiMessage(ConsolepFillConsoleOutput, body);
+}
+
+static ReplayMessage makeGetScreenBufferInfo()
+{
+    return makeApiMessage(ConsolepGetScreenBufferInfo, CONSOLE_SCREENBUFFERINFO_MSG{});
+}
+
+static ReplayMessage makeReadConsoleOutput(const SMALL_RECT region)
+{
+    CONSOLE_READCONSOLEOUTPUT_MSG body{};
+    body.CharRegion = region;
+    body.Unicode = TRUE;
+    const size_t cells = (region.Right - region.Left + 1) * (region.Bottom - region.Top + 1);
+    return makeApiMessage(ConsolepReadConsoleOutput, body, {}, cells * sizeof(CHAR_INFO));
+}
+
+static ReplayMessage makeWriteConsoleOutput(const SMALL_RECT region)
+{
+    CONSOLE_WRITECONSOLEOUTPUT_MSG body{};
+    body.CharRegion = region;
+    body.Unicode = TRUE;
+    const size_t cells = (region.Right - region.Left + 1) * (region.Bottom - region.Top + 1);
+    std::vector<CHAR_INFO> chars(cells);
+    for (size_t i = 0; i < cells; ++i)
+    {
+        chars[i].Char.UnicodeChar = gsl::narrow_cast<wchar_t>(L'!' + i % 94);
+        chars[i].Attributes = gsl::narrow_cast<WORD>(i % 16);
+    }
+    return makeApiMessage(ConsolepWriteConsoleOutput, body, std::as_bytes(std::span{ chars }));
+}
+
+static ReplayMessage makeWriteConsoleInput(const std::span<const INPUT_RECORD> records)
+{
+    CONSOLE_WRITECONSOLEINPUT_MSG body{};
+    body.NumRecords = gsl::narrow<ULONG>(records.size());
+    body.Unicode = TRUE;
+    body.Append = TRUE;
+    return makeApiMessage(ConsolepWriteConsoleInput, body, std::as_bytes(records), 0, true);
+}
+
+static ReplayMessage makeReadConsoleInput(const size_t count)
+{
+    CONSOLE_GETCONSOLEINPUT_MSG body{};
+    body.Flags = CONSOLE_READ_NOWAIT;
+    body.Unicode = TRUE;
+    return makeApiMessage(ConsolepGetConsoleInput, body, {}, count * sizeof(INPUT_RECORD), true);
+}
+
+static ReplayMessage makeReadConsole(const size_t maxChars)
+{
+    CONSOLE_READCONSOLE_MSG body{};
+    body.Unicode = TRUE;
+    return makeApiMessage(ConsolepReadConsole, body, {}, maxChars * sizeof(wchar_t), true);
+}
+
+// Returns the key down and key up records a keyboard would generate for the given text.
+static std::vector<INPUT_RECORD> makeKeyRecords(const std::wstring_view text)
+{
+    std::vector<INPUT_RECORD> records;
+    records.reserve(text.size() * 2);
+    for (const auto ch : text)
+    {
+        INPUT_RECORD record{};
+        record.EventType = KEY_EVENT;
+        record.Event.KeyEvent.bKeyDown = TRUE;
+        record.Event.KeyEvent.wRepeatCount = 1;
+        record.Event.KeyEvent.uChar.UnicodeChar = ch;
+        records.emplace_back(record);
+        record.Event.KeyEvent.bKeyDown = FALSE;
+        records.emplace_back(record);
+    }
+    return records;
+}
+
+// Returns the key down and key up records of pressing a key without a character, like the arrow keys, repeatedly.
+static std::vector<INPUT_RECORD> makeVirtualKeyRecords(const WORD virtualKeyCode, const size_t count)
+{
+    INPUT_RECORD record{};
+    record.EventType = KEY_EVENT;
+    record.Event.KeyEvent.wRepeatCount = 1;
+    record.Event.KeyEvent.wVirtualKeyCode = virtualKeyCode;
+
+    std::vector<INPUT_RECORD> records;
+    records.reserve(count * 2);
+    for (size_t i = 0; i < count; ++i)
+    {
+        record.Event.KeyEvent.bKeyDown = TRUE;
+        records.emplace_back(record);
+        record.Event.KeyEvent.bKeyDown = FALSE;
+        records.emplace_back(record);
+    }
+    return records;
+}
+
+// Approximates MSBuild: short colored status lines, each one wrapped in a pair of SetConsoleTextAttribute calls.
+static std::vector<ReplayMessage> makeMsbuildWorkload()
+{
+    std::vector<ReplayMessage> messages;
+    for (auto i = 0; i < 256; ++i)
+    {
+        const auto line = fmt::format(FMT_COMPILE(L"  Project{}.vcxproj -> C:\\src\\bin\\x64\\Release\\Project{}.dll\r\n"), i, i);
+        messages.emplace_back(makeSetTextAttribute(gsl::narrow_cast<USHORT>(FOREGROUND_GREEN | FOREGROUND_INTENSITY)));
+        messages.emplace_back(makeWriteConsole(line));
+        messages.emplace_back(makeSetTextAttribute(gsl::narrow_cast<USHORT>(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE)));
+    }
+    return messages;
+}
+
+// Approximates cmd.exe running a batch script: it queries the buffer, clears lines and positions the cursor a lot.
+static std::vector<ReplayMessage> makeCmdWorkload()
+{
+    std::vector<ReplayMessage> messages;
+    for (SHORT i = 0; i < 256; ++i)
+    {
+        const auto y = gsl::narrow_cast<SHORT>(i % 30);
+        messages.emplace_back(makeGetScreenBufferInfo());
+        messages.emplace_back(makeFillConsoleOutput(CONSOLE_REAL_UNICODE, L' ', y, 120));
+        messages.emplace_back(makeFillConsoleOutput(CONSOLE_ATTRIBUTE, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE, y, 120));
+        messages.emplace_back(makeSetCursorPosition(0, y));
+        messages.emplace_back(makeWriteConsole(L"C:\\src>echo Hello World\r\nHello World\r\n"));
+    }
+    return messages;
+}
+
+// Approximates cls and installers clearing the entire 200x9001 buffer with FillConsoleOutput.
+static std::vector<ReplayMessage> makeClsWorkload()
+{
+    constexpr ULONG length = 200 * 9001;
+    std::vector<ReplayMessage> messages;
+    for (auto i = 0; i < 8; ++i)
+    {
+        messages.emplace_back(makeFillConsoleOutput(CONSOLE_REAL_UNICODE, L' ', 0, length));
+        messages.emplace_back(makeFillConsoleOutput(CONSOLE_ATTRIBUTE, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE, 0, length));
+    }
+    return messages;
+}
+
+// Approximates full-screen applications that blit their UI with Read/WriteConsoleOutput.
+static std::vector<ReplayMessage> makeBlitWorkload()
+{
+    constexpr SMALL_RECT region{ 0, 0, 119, 29 };
+    std::vector<ReplayMessage> messages;
+    for (auto i = 0; i < 64; ++i)
+    {
+        messages.emplace_back(makeWriteConsoleOutput(region));
+        messages.emplace_back(makeReadConsoleOutput(region));
+    }
+    return messages;
+}
+
+// Same as the blit workload, but with the larger frames of a maximized far manager or curses application.
+static std::vector<ReplayMessage> makeLargeBlitWorkload()
+{
+    constexpr SMALL_RECT region{ 0, 0, 199, 59 };
+    std::vector<ReplayMessage> messages;
+    for (auto i = 0; i < 64; ++i)
+    {
+        messages.emplace_back(makeWriteConsoleOutput(region));
+        messages.emplace_back(makeReadConsoleOutput(region));
+    }
+    return messages;
+}
+
+// Approximates a tool dumping a large file without line breaks: long runs of printable ASCII that only wrap.
+static std::vector<ReplayMessage> makePlainWorkload()
+{
+    std::wstring text;
+    while (text.size() < 64 * 1024)
+    {
+        text.append(L"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor. ");
+    }
+
+    std::vector<ReplayMessage> messages;
+    for (auto i = 0; i < 16; ++i)
+    {
+        messages.emplace_back(makeWriteConsole(text));
+    }
+    return messages;
+}
+
+// Approximates a log being printed: many short CRLF terminated lines in each WriteConsole call.
+static std::vector<ReplayMessage> makeCrlfWorkload()
+{
+    std::wstring text;
+    for (auto i = 0; text.size() < 64 * 1024; ++i)
+    {
+        fmt::format_to(std::back_inserter(text), FMT_COMPILE(L"[{:>6}] info: request completed\r\n"), i);
+    }
+
+    std::vector<ReplayMessage> messages;
+    for (auto i = 0; i < 16; ++i)
+    {
+        messages.emplace_back(makeWriteConsole(text));
+    }
+    return messages;
+}
+
+// Approximates pasting a large block of text into an application that reads it with ReadConsoleInput.
+static std::vector<ReplayMessage> makePasteWorkload()
+{
+    std::wstring text;
+    while (text.size() < 2048)
+    {
+        text.append(L"The quick brown fox jumps over the lazy dog. ");
+    }
+    text.resize(2048);
+
+    const auto records = makeKeyRecords(text);
+    std::vector<ReplayMessage> messages;
+    for (auto i = 0; i < 16; ++i)
+    {
+        messages.emplace_back(makeWriteConsoleInput(records));
+        messages.emplace_back(makeReadConsoleInput(records.size()));
+    }
+    return messages;
+}
+
+// Approximates typing: every keystroke is written and read on its own.
+static std::vector<ReplayMessage> makeKeystrokeWorkload()
+{
+    const auto records = makeKeyRecords(L"dir /s /b C:\\src\\*.cpp\r");
+    std::vector<ReplayMessage> messages;
+    for (auto i = 0; i < 64; ++i)
+    {
+        for (size_t j = 0; j < records.size(); j += 2)
+        {
+            messages.emplace_back(makeWriteConsoleInput(std::span{ records }.subspan(j, 2)));
+            messages.emplace_back(makeReadConsoleInput(2));
+        }
+    }
+    return messages;
+}
+
+// Approximates pasting a 32K character command line into cmd.exe, which reads it with a cooked ReadConsole,
+// then fixing it up near its end and in front of it before pressing enter.
+static std::vector<ReplayMessage> makeCookedWorkload()
+{
+    std::wstring line;
+    while (line.size() < 32 * 1024)
+    {
+        line.append(L"robocopy C:\\src D:\\dst *.cpp /mir /xd .git ");
+    }
+    line.resize(32 * 1024);
+
+    auto records = makeKeyRecords(line);
+    const auto append = [&](const std::vector<INPUT_RECORD>& more) {
+        records.insert(records.end(), more.begin(), more.end());
+    };
+    append(makeVirtualKeyRecords(VK_LEFT, 16));
+    append(makeKeyRecords(L"/np /nfl /ndl "));
+    append(makeVirtualKeyRecords(VK_HOME, 1));
+    append(makeKeyRecords(L"rem \r"));
+
+    std::vector<ReplayMessage> messages;
+    messages.emplace_back(makeWriteConsoleInput(records));
+    messages.emplace_back(makeReadConsole(33 * 1024));
+    return messages;
+}
+
+struct Workload
+{
+    std::string_view name;
+    std::string_view description;
+    std::vector<ReplayMessage> (*make)();
+};
+
+static constexpr std::array workloads{
+    Workload{ "msbuild", "colored WriteConsole lines between SetConsoleTextAttribute calls", makeMsbuildWorkload },
+    Workload{ "cmd", "GetConsoleScreenBufferInfo, FillConsoleOutput, SetConsoleCursorPosition and WriteConsole", makeCmdWorkload },
+    Workload{ "cls", "FillConsoleOutput of every character and attribute in the 200x9001 buffer", makeClsWorkload },
+    Workload{ "blit", "120x30 WriteConsoleOutput and ReadConsoleOutput", makeBlitWorkload },
+    Workload{ "blit200", "200x60 WriteConsoleOutput and ReadConsoleOutput", makeLargeBlitWorkload },
+    Workload{ "plain", "64K character WriteConsole calls without any control characters", makePlainWorkload },
+    Workload{ "crlf", "64K character WriteConsole calls made of short CRLF terminated lines", makeCrlfWorkload },
+    Workload{ "paste", "4096 key records at once with WriteConsoleInput, drained with ReadConsoleInput", makePasteWorkload },
+    Workload{ "keystroke", "single keystrokes with WriteConsoleInput, each read with ReadConsoleInput", makeKeystrokeWorkload },
+    Workload{ "cooked", "a 32K character line pasted into a cooked ReadConsole and edited in the middle", makeCookedWorkload },
+};
+
+static std::string_view apiName(const ULONG apiNumber) noexcept
+{
+    switch (apiNumber)
+    {
+    case ConsolepWriteConsole:
+        return "WriteConsole";
+    case ConsolepFillConsoleOutput:
+        return "FillConsoleOutput";
+    case ConsolepGetScreenBufferInfo:
+        return "GetConsoleScreenBufferInfo";
+    case ConsolepSetCursorPosition:
+        return "SetConsoleCursorPosition";
+    case ConsolepSetTextAttribute:
+        return "SetConsoleTextAttribute";
+    case ConsolepReadConsoleOutput:
+        return "ReadConsoleOutput";
+    case ConsolepWriteConsoleOutput:
+        return "WriteConsoleOutput";
+    case ConsolepWriteConsoleInput:
+        return "WriteConsoleInput";
+    case ConsolepGetConsoleInput:
+        return "ReadConsoleInput";
+    case ConsolepReadConsole:
+        return "ReadConsole";
+    default:
+        return {};
+    }
+}
+
+static void printResults(const std::string_view name, const size_t messageCount, const std::chrono::nanoseconds elapsed)
+{
+    const auto seconds = std::chrono::duration<double>(elapsed).count();
+    fmt::print(stderr, FMT_COMPILE("{}: {} messages in {:.3f}s, {:.0f} messages/s, {} bytes written to the client\n"), name, messageCount, seconds, messageCount / seconds, s_deviceComm->GetBytesWritten());
+
+    for (const auto& [apiNumber, stats] : s_deviceComm->GetStats())
+    {
+        const auto average = std::chrono::duration<double, std::micro>(stats.total).count() / stats.count;
+        const auto max = std::chrono::duration<double, std::micro>(stats.max).count();
+        const auto known = apiName(apiNumber);
+        const auto label = known.empty() ? fmt::format(FMT_COMPILE("0x{:08x}"), apiNumber) : std::string{ known };
+        fmt::print(stderr, FMT_COMPILE("  {:<28} {:>9} calls {:>10.2f}us avg {:>10.2f}us max\n"), label, stats.count, average, max);
+    }
+}
+
+// Feeds a bracketed paste of the given size through an input state machine, the same
+// way VtInputThread does for the input of a conpty, once for a client in VT input mode
+// and once for a legacy client. The client is emulated by flushing the input buffer.
+static void runPasteBenchmark(const size_t megabytes)
+{
+    std::wstring paste{ L"\x1b[200~" };
+    while (paste.size() < megabytes * 1024 * 1024)
+    {
+        paste.append(L"The quick brown fox jumps over the lazy dog, again and again and again.\r");
+    }
+    paste.append(L"\x1b[201~");
+
+    auto engine = std::make_unique<InputStateMachineEngine>(std::make_unique<InteractDispatch>());
+    const auto engineRef = engine.get();
+    StateMachine stateMachine{ std::move(engine) };
+    engineRef->SetFlushToInputQueueCallback([&]() { return stateMachine.FlushToTerminal(); });
+
+    auto& inputBuffer = *ServiceLocator::LocateGlobals().getConsoleInformation().pInputBuffer;
+    const auto originalInputMode = inputBuffer.InputMode;
+
+    for (const auto vtInput : { true, false })
+    {
+        WI_UpdateFlag(inputBuffer.InputMode, ENABLE_VIRTUAL_TERMINAL_INPUT, vtInput);
+
+        // VtInputThread reads at most 256 bytes from the pipe at once.
+        const std::wstring_view remaining{ paste };
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < remaining.size(); offset += 256)
+        {
+            LockConsole();
+            stateMachine.ProcessString(remaining.substr(offset, 256));
+            inputBuffer.Flush();
+            UnlockConsole();
+        }
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const auto label = vtInput ? "VT input mode" : "legacy input mode";
+        fmt::print(stderr, FMT_COMPILE("paste ({}): {} MB in {:.3f}s, {:.1f} MB/s\n"), label, megabytes, seconds, megabytes / seconds);
+    }
+
+    inputBuffer.InputMode = originalInputMode;
+}
+
+// Adds the given number of commands to a command history of the maximum size, with duplicates
+// being suppressed like cmd.exe does, and then searches it by prefix the way F8 does.
+static void runHistoryBenchmark(const size_t commandCount)
+{
+    // Every third command repeats an earlier one.
+    std::vector<std::wstring> commands;
+    commands.reserve(commandCount);
+    for (size_t i = 0; i < commandCount; ++i)
+    {
+        const auto n = i % 3 == 2 ? i / 2 : i;
+        commands.emplace_back(fmt::format(FMT_COMPILE(L"git commit -m \"Change number {}\" --author=someone"), n));
+    }
+
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+    const auto history = CommandHistory::s_Allocate(L"OpenConsoleReplay.exe", nullptr);
+    THROW_HR_IF_NULL(E_OUTOFMEMORY, history);
+    auto freeHistory = wil::scope_exit([&] { CommandHistory::s_Free(nullptr); });
+    history->Realloc(SHORT_MAX);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& command : commands)
+    {
+        THROW_IF_FAILED(history->Add(command, true));
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print(stderr, FMT_COMPILE("history: {} commands added in {:.3f}s, {:.0f} commands/s, {} kept\n"), commandCount, seconds, commandCount / seconds, history->GetNumberOfCommands());
+
+    constexpr size_t searches = 10000;
+    size_t found = 0;
+    SHORT index = history->LastDisplayed;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < searches; ++i)
+    {
+        const auto prefix = fmt::format(FMT_COMPILE(L"git commit -m \"Change number {}"), i % 1000);
+        found += history->FindMatchingCommand(prefix, index, index, CommandHistory::MatchOptions::JustLooking) ? 1 : 0;
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print(stderr, FMT_COMPILE("history: {} prefix searches in {:.3f}s, {:.0f} searches/s, {} found\n"), searches, seconds, searches / seconds, found);
+}
+
+// Defines the given number of aliases for cmd.exe, like a large doskey /macrofile would,
+// and then expands them for command lines the way a cooked read does on enter.
+static void runAliasBenchmark(const size_t aliasCount)
+{
+    static constexpr std::array targets{
+        L"git log --oneline --graph $*",
+        L"dir /b /s $1 $g $2.txt",
+        L"pushd $1 $t git status $t popd",
+        L"findstr /s /i /n $2 $1\\*.cpp $b sort $b more",
+        L"copy $1 $2 $t echo copied $1 to $2 $t dir $2",
+        L"cd /d %USERPROFILE%\\source\\repos",
+    };
+
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+    auto& routines = ServiceLocator::LocateGlobals().api;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < aliasCount; ++i)
+    {
+        const auto source = fmt::format(FMT_COMPILE(L"macro{}"), i);
+        THROW_IF_FAILED(routines->AddConsoleAliasWImpl(source, til::at(targets, i % targets.size()), L"cmd.exe"));
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print(stderr, FMT_COMPILE("aliases: {} defined in {:.3f}s, {:.0f} aliases/s\n"), aliasCount, seconds, aliasCount / seconds);
+
+    constexpr size_t lines = 100000;
+    std::vector<std::wstring> commandLines;
+    commandLines.reserve(lines);
+    for (size_t i = 0; i < lines; ++i)
+    {
+        commandLines.emplace_back(fmt::format(FMT_COMPILE(L"macro{} src\\host include\\{} --all\r\n"), i * 7919 % aliasCount, i));
+    }
+
+    const std::wstring exeName{ L"cmd.exe" };
+    std::array<wchar_t, 4096> buffer{};
+    size_t expanded = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& commandLine : commandLines)
+    {
+        // Cooked reads expand aliases in place, like this.
+        std::copy(commandLine.begin(), commandLine.end(), buffer.begin());
+        size_t written = commandLine.size() * sizeof(wchar_t);
+        DWORD lineCount = 1;
+        Alias::s_MatchAndCopyAliasLegacy(buffer.data(), written, buffer.data(), sizeof(buffer), written, exeName, lineCount);
+        expanded += written / sizeof(wchar_t);
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print(stderr, FMT_COMPILE("aliases: {} command lines expanded in {:.3f}s, {:.0f} lines/s, {} characters\n"), lines, seconds, lines / seconds, expanded);
+
+    Alias::s_ClearCmdExeAliases();
+}
+
+// Fills the scrollback of the active screen buffer and then scrolls the viewport within
+// DECSTBM margins, leaving a status line at the bottom, the way vim, less or tmux do it.
+// Every line feed at the bottom margin scrolls the rows within the margins by one.
+static void runMarginScrollBenchmark(const size_t scrollCount)
+{
+    auto& screenInfo = ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer();
+    auto& stateMachine = screenInfo.GetStateMachine();
+
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+    // Write more lines than the buffer holds, so that the circular buffer has wrapped around.
+    const auto bufferHeight = gsl::narrow_cast<size_t>(screenInfo.GetBufferSize().Height());
+    std::wstring text;
+    for (size_t i = 0; i < bufferHeight * 3 / 2; ++i)
+    {
+        fmt::format_to(std::back_inserter(text), FMT_COMPILE(L"Filling up the scrollback with line {}\r\n"), i);
+    }
+    stateMachine.ProcessString(text);
+
+    const auto viewportHeight = screenInfo.GetViewport().Height();
+    stateMachine.ProcessString(fmt::format(FMT_COMPILE(L"\x1b[1;{0}r\x1b[{0};1H"), viewportHeight - 1));
+
+    // The line feeds are written in batches, like a client would.
+    constexpr size_t batchSize = 1000;
+    text.clear();
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+        fmt::format_to(std::back_inserter(text), FMT_COMPILE(L"\nScrolled line {}\r"), i);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < scrollCount; i += batchSize)
+    {
+        stateMachine.ProcessString(text);
+    }
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto scrolls = (scrollCount + batchSize - 1) / batchSize * batchSize;
+    fmt::print(stderr, FMT_COMPILE("margin scrolling: {} scrolls of {} rows with {} rows of scrollback in {:.3f}s, {:.0f} scrolls/s\n"), scrolls, viewportHeight - 1, bufferHeight, seconds, scrolls / seconds);
+
+    stateMachine.ProcessString(L"\x1b[r");
+}
+
+// Writes the numbers from 1 to lineCount on their own lines to the active screen buffer's state
+// machine, just like `seq 1 10000000` would. Every line feed recycles a row of the full scrollback,
+// while only the first few columns of each row are ever written to.
+static void runSeqBenchmark(const size_t lineCount)
+{
+    auto& screenInfo = ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer();
+    auto& stateMachine = screenInfo.GetStateMachine();
+
+    std::wstring text;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 1; i <= lineCount;)
+    {
+        text.clear();
+        for (; i <= lineCount && text.size() < 64 * 1024; ++i)
+        {
+            fmt::format_to(std::back_inserter(text), FMT_COMPILE(L"{}\r\n"), i);
+        }
+
+        LockConsole();
+        stateMachine.ProcessString(text);
+        UnlockConsole();
+    }
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fmt::print(stderr, FMT_COMPILE("seq: {} lines in {:.3f}s, {:.0f} lines/s\n"), lineCount, seconds, lineCount / seconds);
+}
+
+// Writes the given amount of text with a different 24-bit foreground color for every character, the
+// way lolcat does, followed by the same amount of syntax highlighted lines, the way bat does, to the
+// active screen buffer's state machine. Besides the throughput, this prints how many distinct
+// attributes the rows of the buffer still refer to afterwards.
+static void runColoredOutputBenchmark(const size_t megabytes)
+{
+    auto& screenInfo = ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer();
+    auto& stateMachine = screenInfo.GetStateMachine();
+
+    std::wstring rainbow;
+    for (size_t i = 0; rainbow.size() < megabytes * 1024 * 1024; ++i)
+    {
+        const auto hue = i % 96;
+        fmt::format_to(std::back_inserter(rainbow), FMT_COMPILE(L"\x1b[38;2;{};{};{}m{}"), hue * 2, 255 - hue * 2, (hue * 5) % 256, gsl::narrow_cast<wchar_t>(L'!' + i % 94));
+        if (i % 80 == 79)
+        {
+            rainbow.append(L"\r\n");
+        }
+    }
+    rainbow.append(L"\x1b[m");
+
+    std::wstring highlighted;
+    for (size_t i = 0; highlighted.size() < megabytes * 1024 * 1024; ++i)
+    {
+        fmt::format_to(std::back_inserter(highlighted), FMT_COMPILE(L"\x1b[38;5;242m{:>6}\x1b[m \x1b[38;5;204mstatic\x1b[m \x1b[38;5;81mvoid\x1b[m \x1b[38;5;149mfunction{}\x1b[m(\x1b[38;5;208;3mvalue\x1b[m) \x1b[38;5;242m// comment\x1b[m\r\n"), i, i);
+    }
+
+    for (const auto& [label, text] : { std::pair{ "lolcat", std::wstring_view{ rainbow } }, std::pair{ "bat", std::wstring_view{ highlighted } } })
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < text.size(); offset += 64 * 1024)
+        {
+            LockConsole();
+            stateMachine.ProcessString(text.substr(offset, 64 * 1024));
+            UnlockConsole();
+        }
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        LockConsole();
+        const auto attributes = screenInfo.GetTextBuffer().GetAttributeTable().size();
+        UnlockConsole();
+        fmt::print(stderr, FMT_COMPILE("colored output ({}): {} MB in {:.3f}s, {:.1f} MB/s, {} distinct attributes in the buffer\n"), label, megabytes, seconds, megabytes / seconds, attributes);
+    }
+}
+
+// Writes the given amount of Devanagari text with combining vowel signs and of ZWJ emoji sequences,
+// the way a chat log would look like, to the active screen buffer's state machine. Most rows need
+// more characters than they have columns. Besides the throughput, this prints how many slabs the
+// buffer's RowCharsPool had to allocate for them, which shouldn't grow once the scrollback is full.
+static void runCombiningOutputBenchmark(const size_t megabytes)
+{
+    auto& screenInfo = ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer();
+    auto& stateMachine = screenInfo.GetStateMachine();
+
+    std::wstring devanagari;
+    while (devanagari.size() < megabytes * 1024 * 1024)
+    {
+        devanagari.append(L"\u0928\u092e\u0938\u094d\u0924\u0947 \u0926\u0941\u0928\u093f\u092f\u093e \u0915\u0948\u0938\u0947 \u0939\u094b? ");
+        devanagari.append(L"\u0906\u091c \u092e\u094c\u0938\u092e \u0905\u091a\u094d\u091b\u093e \u0939\u0948\u0964\r\n");
+    }
+
+    std::wstring emoji;
+    while (emoji.size() < megabytes * 1024 * 1024)
+    {
+        emoji.append(L"<someone> \U0001F469\u200D\U0001F4BB shipped it \U0001F468\u200D\U0001F469\u200D\U0001F467\u200D\U0001F466 ");
+        emoji.append(L"\U0001F44D\U0001F3FD \U0001F3F3\uFE0F\u200D\U0001F308 \u2764\uFE0F\u200D\U0001F525\r\n");
+    }
+
+    for (const auto& [label, text] : { std::pair{ "devanagari", std::wstring_view{ devanagari } }, std::pair{ "emoji", std::wstring_view{ emoji } } })
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < text.size(); offset += 64 * 1024)
+        {
+            LockConsole();
+            stateMachine.ProcessString(text.substr(offset, 64 * 1024));
+            UnlockConsole();
+        }
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        LockConsole();
+        const auto& pool = screenInfo.GetTextBuffer().GetCharsPool();
+        const auto slabs = pool.SlabCount();
+        const auto reserved = pool.ReservedBytes();
+        UnlockConsole();
+        fmt::print(stderr, FMT_COMPILE("combining output ({}): {} MB in {:.3f}s, {:.1f} MB/s, {} slabs ({} KiB) allocated for overflowing rows\n"), label, megabytes, seconds, megabytes / seconds, slabs, reserved / 1024);
+    }
+}
+
+// Writes an OSC 52 (clipboard) and a DECDLD (soft font) sequence with payloads of the given
+// size to the active screen buffer's state machine, the way WriteConsole does for a client
+// with VT processing enabled, to measure how quickly long control strings get parsed.
+// The base64 decoding of the OSC 52 payload is measured on its own beforehand, both in one
+// go and in pieces the way the payload streams in. Note that the state machine rejects
+// clipboard requests larger than OutputStateMachineEngine::MAX_CLIPBOARD_SIZE early on.
+static void runControlStringBenchmark(const size_t megabytes)
+{
+    const auto size = megabytes * 1024 * 1024;
+
+    std::wstring osc52{ L"\x1b]52;c;" };
+    while (osc52.size() < size)
+    {
+        osc52.append(L"VGhlIHF1aWNrIGJyb3duIGZveCBqdW1wcyBvdmVyIHRoZSBsYXp5IGRvZy4K");
+    }
+    osc52.append(L"\x1b\\");
+
+    {
+        const auto payload = std::wstring_view{ osc52 }.substr(7, osc52.size() - 9);
+        std::wstring decoded;
+
+        auto start = std::chrono::steady_clock::now();
+        THROW_IF_FAILED(Base64::Decode(payload, decoded));
+        auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fmt::print(stderr, FMT_COMPILE("base64 (in one go): {} MB in {:.3f}s, {:.1f} MB/s\n"), megabytes, seconds, megabytes / seconds);
+
+        start = std::chrono::steady_clock::now();
+        Base64::Decoder decoder{ SIZE_MAX };
+        for (size_t offset = 0; offset < payload.size(); offset += 64 * 1024)
+        {
+            THROW_IF_FAILED(decoder.Append(payload.substr(offset, 64 * 1024)));
+        }
+        THROW_IF_FAILED(decoder.Finish(decoded));
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fmt::print(stderr, FMT_COMPILE("base64 (in pieces): {} MB in {:.3f}s, {:.1f} MB/s\n"), megabytes, seconds, megabytes / seconds);
+    }
+
+    // A font of 10x20 cells, where every character is made up of 4 rows of
+    // sixels. The data keeps on going long after the last character is full.
+    std::wstring decdld{ L"\x1bP1;1;2;10;0;2;20;0{ @" };
+    while (decdld.size() < size)
+    {
+        decdld.append(L"??~~AA~~??/??~~AA~~??/??~~AA~~??/??~~AA~~??;");
+    }
+    decdld.append(L"\x1b\\");
+
+    auto& stateMachine = ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer().GetStateMachine();
+    const std::array sequences{
+        std::pair{ "OSC 52", std::wstring_view{ osc52 } },
+        std::pair{ "DECDLD", std::wstring_view{ decdld } },
+    };
+
+    for (const auto& [label, sequence] : sequences)
+    {
+        // Clients tend to write their output in chunks of at most 64K.
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < sequence.size(); offset += 64 * 1024)
+        {
+            LockConsole();
+            stateMachine.ProcessString(sequence.substr(offset, 64 * 1024));
+            UnlockConsole();
+        }
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fmt::print(stderr, FMT_COMPILE("control string ({}): {} MB in {:.3f}s, {:.1f} MB/s\n"), label, megabytes, seconds, megabytes / seconds);
+    }
+}
+
+static void printUsage()
+{
+    fmt::print(stderr, FMT_COMPILE("Usage: OpenConsoleReplay [-n <iterations>] [-p <megabytes>] [-h <commands>] [-a <aliases>] [-c <megabytes>] [-m <scrolls>] [-l <megabytes>] [-g <megabytes>] [-q <lines>] [-o <file>] [<workload> | -f <file>]...\n\n"));
+    fmt::print(stderr, FMT_COMPILE("  -n <iterations>  Replay each stream this many times (default: 100).\n"));
+    fmt::print(stderr, FMT_COMPILE("  -p <megabytes>   Measure the throughput of a bracketed paste of this size through the conpty input path.\n"));
+    fmt::print(stderr, FMT_COMPILE("  -h <commands>    Measure adding this many commands to a command history and searching it by prefix.\n"));
+    fmt::print(stderr, FMT_COMPILE("  -a <aliases>     Measure defining this many cmd.exe aliases and expanding them on command lines.\n"));
+    fmt::print(stderr, FMT_COMPILE("  -c <megabytes>   Measure decoding base64 and parsing OSC 52 and DECDLD sequences with payloads of this size.\n"));
+    fmt::print(stderr, FMT_COMPILE("  -m <scrolls>     Measure scrolling this many lines within margins, with a full scrollback.\n"));
+    fmt::print(stderr, FMT_COMPILE("  -l <megabytes>   Measure writing this much lolcat and bat style colored output.\n"));
+    fmt::print(stderr, FMT_COMPILE("  -g <megabytes>   Measure writing this much text with combining marks and ZWJ emoji sequences.\n"));
+    fmt::print(stderr, FMT_COMPILE("  -q <lines>       Measure writing this many short lines, like seq 1 <lines> does.\n"));
+    fmt::print(stderr, FMT_COMPILE("  -f <file>        Replay a previously saved message stream.\n"));
+    fmt::print(stderr, FMT_COMPILE("  -o <file>        Save the streams of the following workloads instead of replaying them.\n\n"));
+    fmt::print(stderr, FMT_COMPILE("Workloads (all of them if none is given):\n"));
+    for (const auto& workload : workloads)
+    {
+        fmt::print(stderr, FMT_COMPILE("  {:<16} {}\n"), workload.name, workload.description);
+    }
+}
+
+int main(int argc, char** argv)
+try
+{
+    size_t iterations = 100;
+    const char* outputPath = nullptr;
+    size_t pasteMegabytes = 0;
+    size_t historyCommands = 0;
+    size_t aliasCount = 0;
+    size_t controlStringMegabytes = 0;
+    size_t marginScrolls = 0;
+    size_t coloredMegabytes = 0;
+    size_t combiningMegabytes = 0;
+    size_t seqLines = 0;
+    std::vector<std::pair<std::string, std::vector<ReplayMessage>>> streams;
+
+    for (auto i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{ til::at(argv, i) };
+        const auto hasValue = i + 1 < argc;
+
+        if (arg == "-n" && hasValue)
+        {
+            iterations = std::max<size_t>(1, strtoul(til::at(argv, ++i), nullptr, 10));
+        }
+        else if (arg == "-p" && hasValue)
+        {
+            pasteMegabytes = std::max<size_t>(1, strtoul(til::at(argv, ++i), nullptr, 10));
+        }
+        else if (arg == "-h" && hasValue)
+        {
+            historyCommands = std::max<size_t>(1, strtoul(til::at(argv, ++i), nullptr, 10));
+        }
+        else if (arg == "-a" && hasValue)
+        {
+            aliasCount = std::max<size_t>(1, strtoul(til::at(argv, ++i), nullptr, 10));
+        }
+        else if (arg == "-c" && hasValue)
+        {
+            controlStringMegabytes = std::max<size_t>(1, strtoul(til::at(argv, ++i), nullptr, 10));
+        }
+        else if (arg == "-m" && hasValue)
+        {
+            marginScrolls = std::max<size_t>(1, strtoul(til::at(argv, ++i), nullptr, 10));
+        }
+        else if (arg == "-l" && hasValue)
+        {
+            coloredMegabytes = std::max<size_t>(1, strtoul(til::at(argv, ++i), nullptr, 10));
+        }
+        else if (arg == "-g" && hasValue)
+        {
+            combiningMegabytes = std::max<size_t>(1, strtoul(til::at(argv, ++i), nullptr, 10));
+        }
+        else if (arg == "-q" && hasValue)
+        {
+            seqLines = std::max<size_t>(1, strtoul(til::at(argv, ++i), nullptr, 10));
+        }
+        else if (arg == "-o" && hasValue)
+        {
+            outputPath = til::at(argv, ++i);
+        }
+        else if (arg == "-f" && hasValue)
+        {
+            const std::string path{ til::at(argv, ++i) };
+            std::ifstream file{ path, std::ios::binary };
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND), !file);
+            const std::vector<BYTE> data{ std::istreambuf_iterator<char>{ file }, {} };
+            streams.emplace_back(path, ReplayMessage::s_Deserialize(data));
+        }
+        else
+        {
+            const auto it = std::find_if(workloads.begin(), workloads.end(), [&](const auto& w) { return w.name == arg; });
+            if (it == workloads.end())
+            {
+                printUsage();
+                return 1;
+            }
+            streams.emplace_back(std::string{ it->name }, it->make());
+        }
+    }
+
+    if (streams.empty() && pasteMegabytes == 0 && historyCommands == 0 && aliasCount == 0 && controlStringMegabytes == 0 && marginScrolls == 0 && coloredMegabytes == 0 && combiningMegabytes == 0 && seqLines == 0)
+    {
+        for (const auto& workload : workloads)
+        {
+            streams.emplace_back(std::string{ workload.name }, workload.make());
+        }
+    }
+
+    if (outputPath)
+    {
+        std::vector<BYTE> data;
+        for (const auto& [name, messages] : streams)
+        {
+            for (const auto& message : messages)
+            {
+                message.Serialize(data);
+            }
+        }
+        std::ofstream file{ outputPath, std::ios::binary };
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        return file ? 0 : 1;
+    }
+
+    ServiceLocator::LocateGlobals().hInstance = wil::GetModuleInstanceHandle();
+
+    ConsoleArguments args({}, nullptr, nullptr);
+    THROW_IF_FAILED(args.ParseCommandline());
+    THROW_IF_FAILED(StartReplayConsole(&args));
+
+    if (pasteMegabytes != 0)
+    {
+        runPasteBenchmark(pasteMegabytes);
+    }
+
+    if (historyCommands != 0)
+    {
+        runHistoryBenchmark(historyCommands);
+    }
+
+    if (aliasCount != 0)
+    {
+        runAliasBenchmark(aliasCount);
+    }
+
+    if (controlStringMegabytes != 0)
+    {
+        runControlStringBenchmark(controlStringMegabytes);
+    }
+
+    if (marginScrolls != 0)
+    {
+        runMarginScrollBenchmark(marginScrolls);
+    }
+
+    if (coloredMegabytes != 0)
+    {
+        runColoredOutputBenchmark(coloredMegabytes);
+    }
+
+    if (combiningMegabytes != 0)
+    {
+        runCombiningOutputBenchmark(combiningMegabytes);
+    }
+
+    if (seqLines != 0)
+    {
+        runSeqBenchmark(seqLines);
+    }
+
+    for (const auto& [name, messages] : streams)
+    {
+        // Warm up the buffers and caches before measuring anything.
+        s_deviceComm->Replay(messages, 1);
+        s_deviceComm->ResetStats();
+
+        const auto elapsed = s_deviceComm->Replay(messages, iterations);
+        printResults(name, messages.size() * iterations, elapsed);
+    }
+
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
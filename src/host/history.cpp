@@ -81,7 +81,7 @@ bool CommandHistory::IsAppNameMatch(const std::wstring_view other) const
 // - This routine is called when escape is entered or a command is added.
 void CommandHistory::_Reset()
 {
-    LastDisplayed = gsl::narrow<SHORT>(_commands.size()) - 1;
+    LastDisplayed = gsl::narrow<SHORT>(_entries.size()) - 1;
     WI_SetFlag(Flags, CLE_RESET);
 }
 
@@ -98,49 +98,30 @@ void CommandHistory::_Reset()
 
     try
     {
-        if (_commands.size() == 0 ||
-            _commands.back().size() != newCommand.size() ||
-            !std::equal(_commands.back().cbegin(),
-                        _commands.back().cbegin() + newCommand.size(),
-                        newCommand.cbegin(),
-                        newCommand.cend()))
+        if (_entries.empty() || _Text(_entries.back()) != newCommand)
         {
-            std::wstring reuse{};
-
             if (suppressDuplicates)
             {
                 SHORT index;
                 if (FindMatchingCommand(newCommand, LastDisplayed, index, CommandHistory::MatchOptions::ExactMatch))
                 {
-                    reuse = Remove(index);
+                    Remove(index);
                 }
             }
 
             // find free record.  if all records are used, free the lru one.
-            if ((SHORT)_commands.size() == _maxCommands)
+            if ((SHORT)_entries.size() == _maxCommands)
             {
-                _commands.erase(_commands.cbegin());
+                _Erase(0);
                 // move LastDisplayed back one in order to stay synced with the
                 // command it referred to before erasing the lru one
                 --LastDisplayed;
             }
 
             // add newCommand to array
-            if (!reuse.empty())
-            {
-                _commands.emplace_back(reuse);
-            }
-            else
-            {
-                _commands.emplace_back(newCommand);
-            }
+            _Append(newCommand);
 
-            if (LastDisplayed == -1 ||
-                _commands.at(LastDisplayed).size() != newCommand.size() ||
-                !std::equal(_commands.at(LastDisplayed).cbegin(),
-                            _commands.at(LastDisplayed).cbegin() + newCommand.size(),
-                            newCommand.cbegin(),
-                            newCommand.cend()))
+            if (LastDisplayed == -1 || GetNth(LastDisplayed) != newCommand)
             {
                 _Reset();
             }
@@ -156,7 +137,7 @@ std::wstring_view CommandHistory::GetNth(const SHORT index) const
 {
     try
     {
-        return _commands.at(index);
+        return _Text(_entries.at(index));
     }
     CATCH_LOG();
 
@@ -171,7 +152,7 @@ std::wstring_view CommandHistory::GetNth(const SHORT index) const
 
     try
     {
-        const auto& cmd = _commands.at(index);
+        const auto cmd = _Text(_entries.at(index));
         if (cmd.size() > (size_t)buffer.size())
         {
             commandSize = buffer.size(); // room for CRLF?
@@ -196,12 +177,12 @@ std::wstring_view CommandHistory::GetNth(const SHORT index) const
 {
     FAIL_FAST_IF(!(WI_IsFlagSet(Flags, CLE_ALLOCATED)));
 
-    if (_commands.size() == 0)
+    if (_entries.size() == 0)
     {
         return E_FAIL;
     }
 
-    if (_commands.size() == 1)
+    if (_entries.size() == 1)
     {
         LastDisplayed = 0;
     }
@@ -229,11 +210,11 @@ std::wstring_view CommandHistory::GetNth(const SHORT index) const
 
 std::wstring_view CommandHistory::GetLastCommand() const
 {
-    if (_commands.size() != 0)
+    if (_entries.size() != 0)
     {
         try
         {
-            return _commands.at(LastDisplayed);
+            return _Text(_entries.at(LastDisplayed));
         }
         CATCH_LOG();
     }
@@ -243,7 +224,7 @@ std::wstring_view CommandHistory::GetLastCommand() const
 
 void CommandHistory::Empty()
 {
-    _commands.clear();
+    _Clear();
     LastDisplayed = -1;
     WI_SetFlag(Flags, CLE_RESET);
 }
@@ -258,15 +239,15 @@ bool CommandHistory::AtFirstCommand() const
     auto i = (SHORT)(LastDisplayed - 1);
     if (i == -1)
     {
-        i = ((SHORT)_commands.size()) - 1i16;
+        i = ((SHORT)_entries.size()) - 1i16;
     }
 
-    return (i == ((SHORT)_commands.size()) - 1i16);
+    return (i == ((SHORT)_entries.size()) - 1i16);
 }
 
 bool CommandHistory::AtLastCommand() const
 {
-    return LastDisplayed == ((SHORT)_commands.size()) - 1i16;
+    return LastDisplayed == ((SHORT)_entries.size()) - 1i16;
 }
 
 void CommandHistory::Realloc(const size_t commands)
@@ -277,17 +258,16 @@ void CommandHistory::Realloc(const size_t commands)
         return;
     }
 
-    const auto oldCommands = _commands;
-    const auto newNumberOfCommands = gsl::narrow<SHORT>(std::min(_commands.size(), commands));
-
-    _commands.clear();
-    for (SHORT i = 0; i < newNumberOfCommands; i++)
+    // Only the oldest commands are kept if the history shrinks.
+    if (_entries.size() > commands)
     {
-        _commands.emplace_back(oldCommands[i]);
+        _entries.resize(commands);
+        _Compact();
+        _RebuildIndex();
     }
 
     WI_SetFlag(Flags, CLE_RESET);
-    LastDisplayed = gsl::narrow<SHORT>(_commands.size()) - 1;
+    LastDisplayed = gsl::narrow<SHORT>(_entries.size()) - 1;
     _maxCommands = (SHORT)commands;
 }
 
@@ -297,11 +277,10 @@ void CommandHistory::s_ReallocExeToFront(const std::wstring_view appName, const
     {
         if (WI_IsFlagSet(it->Flags, CLE_ALLOCATED) && it->IsAppNameMatch(appName))
         {
-            auto backup = *it;
-            backup.Realloc(commands);
+            it->Realloc(commands);
 
-            s_historyLists.erase(it);
-            s_historyLists.push_front(backup);
+            // Splicing relinks the node without copying the history.
+            s_historyLists.splice(s_historyLists.begin(), s_historyLists, it);
 
             return;
         }
@@ -336,19 +315,18 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
     auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
     // Reuse a history buffer.  The buffer must be !CLE_ALLOCATED.
     // If possible, the buffer should have the same app name.
-    std::optional<CommandHistory> BestCandidate;
+    auto BestCandidate = s_historyLists.end();
     auto SameApp = false;
 
-    for (auto it = s_historyLists.cbegin(); it != s_historyLists.cend(); it++)
+    for (auto it = s_historyLists.begin(); it != s_historyLists.end(); it++)
     {
         if (WI_IsFlagClear(it->Flags, CLE_ALLOCATED))
         {
             // use MRU history buffer with same app name
             if (it->IsAppNameMatch(appName))
             {
-                BestCandidate = *it;
+                BestCandidate = it;
                 SameApp = true;
-                s_historyLists.erase(it);
                 break;
             }
         }
@@ -371,32 +349,26 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
     // If we have no candidate already and we need one,
     // take the LRU (which is the back/last one) which isn't allocated
     // and if possible the one with empty commands list.
-    if (!BestCandidate.has_value())
+    if (BestCandidate == s_historyLists.end())
     {
-        auto BestCandidateIt = s_historyLists.cend();
-        for (auto it = s_historyLists.cbegin(); it != s_historyLists.cend(); it++)
+        for (auto it = s_historyLists.begin(); it != s_historyLists.end(); it++)
         {
             if (WI_IsFlagClear(it->Flags, CLE_ALLOCATED))
             {
-                if (it->_commands.empty() || BestCandidateIt == s_historyLists.cend() || !BestCandidateIt->_commands.empty())
+                if (it->_entries.empty() || BestCandidate == s_historyLists.end() || !BestCandidate->_entries.empty())
                 {
-                    BestCandidateIt = it;
+                    BestCandidate = it;
                 }
             }
         }
-        if (BestCandidateIt != s_historyLists.cend())
-        {
-            BestCandidate = *BestCandidateIt;
-            s_historyLists.erase(BestCandidateIt);
-        }
     }
 
     // If the app name doesn't match, copy in the new app name and free the old commands.
-    if (BestCandidate.has_value())
+    if (BestCandidate != s_historyLists.end())
     {
         if (!SameApp)
         {
-            BestCandidate->_commands.clear();
+            BestCandidate->_Clear();
             BestCandidate->LastDisplayed = -1;
             BestCandidate->_appName = appName;
         }
@@ -404,7 +376,9 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
         BestCandidate->_processHandle = processHandle;
         WI_SetFlag(BestCandidate->Flags, CLE_ALLOCATED);
 
-        return &s_historyLists.emplace_front(BestCandidate.value());
+        // Move the history to the front (MRU) by relinking it, which keeps its commands where they are.
+        s_historyLists.splice(s_historyLists.begin(), s_historyLists, BestCandidate);
+        return &s_historyLists.front();
     }
 
     return nullptr;
@@ -412,14 +386,14 @@ CommandHistory* CommandHistory::s_Allocate(const std::wstring_view appName, cons
 
 size_t CommandHistory::GetNumberOfCommands() const
 {
-    return _commands.size();
+    return _entries.size();
 }
 
 void CommandHistory::_Prev(SHORT& ind) const
 {
     if (ind <= 0)
     {
-        ind = gsl::narrow<SHORT>(_commands.size());
+        ind = gsl::narrow<SHORT>(_entries.size());
     }
     ind--;
 }
@@ -427,7 +401,7 @@ void CommandHistory::_Prev(SHORT& ind) const
 void CommandHistory::_Next(SHORT& ind) const
 {
     ++ind;
-    if (ind >= (SHORT)_commands.size())
+    if (ind >= (SHORT)_entries.size())
     {
         ind = 0;
     }
@@ -451,21 +425,21 @@ void CommandHistory::_Inc(SHORT& ind) const
     }
 }
 
-std::wstring CommandHistory::Remove(const SHORT iDel)
+void CommandHistory::Remove(const SHORT iDel)
 {
     SHORT iFirst = 0;
-    auto iLast = gsl::narrow<SHORT>(_commands.size() - 1);
+    auto iLast = gsl::narrow<SHORT>(_entries.size() - 1);
     auto iDisp = LastDisplayed;
 
-    if (_commands.size() == 0)
+    if (_entries.size() == 0)
     {
-        return {};
+        return;
     }
 
     const auto nDel = iDel;
     if ((nDel < iFirst) || (nDel > iLast))
     {
-        return {};
+        return;
     }
 
     if (iDisp == iDel)
@@ -475,11 +449,9 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
 
     try
     {
-        const auto str = _commands.at(iDel);
-
         if (iDel < iLast)
         {
-            _commands.erase(_commands.cbegin() + iDel);
+            _Erase(iDel);
             if ((iDisp > iDel) && (iDisp <= iLast))
             {
                 _Dec(iDisp);
@@ -488,7 +460,7 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
         }
         else if (iFirst <= iDel)
         {
-            _commands.erase(_commands.cbegin() + iDel);
+            _Erase(iDel);
             if ((iDisp >= iFirst) && (iDisp < iDel))
             {
                 _Inc(iDisp);
@@ -497,11 +469,8 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
         }
 
         LastDisplayed = iDisp;
-        return str;
     }
     CATCH_LOG();
-
-    return {};
 }
 
 // Routine Description:
@@ -513,7 +482,7 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
 {
     indexFound = startingIndex;
 
-    if (_commands.size() == 0)
+    if (_entries.size() == 0)
     {
         return false;
     }
@@ -532,25 +501,42 @@ std::wstring CommandHistory::Remove(const SHORT iDel)
         return true;
     }
 
-    try
+    const auto count = gsl::narrow_cast<SHORT>(_entries.size());
+    if (indexFound < 0 || indexFound >= count)
+    {
+        return false;
+    }
+
+    // The matching commands form a contiguous range in _sortedIndices: All commands equal to givenCommand
+    // for an exact match, or all commands starting with it otherwise. Out of these, we want the one a
+    // search backwards through the history starting at indexFound would encounter first.
+    const auto exactMatch = WI_IsFlagSet(options, MatchOptions::ExactMatch);
+    auto it = std::lower_bound(_sortedIndices.begin(), _sortedIndices.end(), givenCommand, [&](const SHORT index, const std::wstring_view& value) {
+        return _Text(index) < value;
+    });
+
+    auto found = false;
+    SHORT bestDistance = count;
+    SHORT bestIndex = indexFound;
+    for (; it != _sortedIndices.end(); ++it)
     {
-        for (size_t i = 0; i < _commands.size(); i++)
+        const auto storedCommand = _Text(*it);
+        if (exactMatch ? storedCommand != givenCommand : !til::starts_with(storedCommand, givenCommand))
         {
-            const auto& storedCommand = _commands.at(indexFound);
-            if ((WI_IsFlagClear(options, MatchOptions::ExactMatch) && (givenCommand.size() <= storedCommand.size())) || (givenCommand.size() == storedCommand.size()))
-            {
-                if (til::starts_with(storedCommand, givenCommand))
-                {
-                    return true;
-                }
-            }
+            break;
+        }
 
-            _Prev(indexFound);
+        const auto distance = gsl::narrow_cast<SHORT>((indexFound - *it + count) % count);
+        if (distance < bestDistance)
+        {
+            found = true;
+            bestDistance = distance;
+            bestIndex = *it;
         }
     }
-    CATCH_LOG();
 
-    return false;
+    indexFound = bestIndex;
+    return found;
 }
 
 #ifdef UNIT_TESTING
@@ -567,7 +553,114 @@ void CommandHistory::s_ClearHistoryListStorage()
 // - indexB - index of one history item to swap
 void CommandHistory::Swap(const short indexA, const short indexB)
 {
-    std::swap(_commands.at(indexA), _commands.at(indexB));
+    auto& entryA = _entries.at(indexA);
+    auto& entryB = _entries.at(indexB);
+
+    // The texts stay where they are in sorted order, only the indices referring to them swap.
+    std::iter_swap(_FindInIndex(indexA), _FindInIndex(indexB));
+    std::swap(entryA, entryB);
+}
+
+std::wstring_view CommandHistory::_Text(const Entry& entry) const noexcept
+{
+    return { _arena.data() + entry.offset, entry.length };
+}
+
+std::wstring_view CommandHistory::_Text(const SHORT index) const noexcept
+{
+    return _Text(til::at(_entries, index));
+}
+
+// Routine Description:
+// - Appends a command to the end (most recent) of the history.
+void CommandHistory::_Append(const std::wstring_view command)
+{
+    // Reserve everything upfront, so that we don't end up with a half inserted command if we run out of memory.
+    _entries.reserve(_entries.size() + 1);
+    _sortedIndices.reserve(_sortedIndices.size() + 1);
+
+    const Entry entry{ _arena.size(), command.size() };
+    _arena.append(command);
+    _arena.push_back(UNICODE_NULL);
+
+    const auto index = gsl::narrow<SHORT>(_entries.size());
+    _entries.emplace_back(entry);
+
+    const auto it = std::upper_bound(_sortedIndices.begin(), _sortedIndices.end(), command, [&](const std::wstring_view& value, const SHORT i) {
+        return value < _Text(i);
+    });
+    _sortedIndices.insert(it, index);
+}
+
+// Routine Description:
+// - Erases the command at the given index and shifts all newer commands down by one.
+void CommandHistory::_Erase(const SHORT index)
+{
+    const auto entry = _entries.at(index);
+
+    _sortedIndices.erase(_FindInIndex(index));
+    for (auto& i : _sortedIndices)
+    {
+        if (i > index)
+        {
+            --i;
+        }
+    }
+
+    _entries.erase(_entries.begin() + index);
+
+    _arenaGaps += entry.length + 1;
+    if (_arenaGaps > _arena.size() / 2)
+    {
+        _Compact();
+    }
+}
+
+void CommandHistory::_Clear() noexcept
+{
+    _arena.clear();
+    _arenaGaps = 0;
+    _entries.clear();
+    _sortedIndices.clear();
+}
+
+// Routine Description:
+// - Rewrites the arena so that it contains exactly the commands in _entries, in history order.
+void CommandHistory::_Compact()
+{
+    std::wstring arena;
+    arena.reserve(_arena.size() - _arenaGaps);
+
+    for (auto& entry : _entries)
+    {
+        const auto offset = arena.size();
+        arena.append(_Text(entry));
+        arena.push_back(UNICODE_NULL);
+        entry.offset = offset;
+    }
+
+    _arena = std::move(arena);
+    _arenaGaps = 0;
+}
+
+void CommandHistory::_RebuildIndex()
+{
+    _sortedIndices.resize(_entries.size());
+    std::iota(_sortedIndices.begin(), _sortedIndices.end(), SHORT{ 0 });
+    std::stable_sort(_sortedIndices.begin(), _sortedIndices.end(), [&](const SHORT a, const SHORT b) {
+        return _Text(a) < _Text(b);
+    });
+}
+
+// Routine Description:
+// - Returns the position of the given index in _sortedIndices.
+std::vector<SHORT>::iterator CommandHistory::_FindInIndex(const SHORT index)
+{
+    const auto text = _Text(index);
+    const auto it = std::lower_bound(_sortedIndices.begin(), _sortedIndices.end(), text, [&](const SHORT i, const std::wstring_view& value) {
+        return _Text(i) < value;
+    });
+    return std::find(it, _sortedIndices.end(), index);
 }
 
 // Routine Description:
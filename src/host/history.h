@@ -63,7 +63,7 @@ public:
     void Realloc(const size_t commands);
     void Empty();
 
-    std::wstring Remove(const SHORT iDel);
+    void Remove(const SHORT iDel);
 
     bool AtFirstCommand() const;
     bool AtLastCommand() const;
@@ -83,7 +83,31 @@ private:
     void _Dec(SHORT& ind) const;
     void _Inc(SHORT& ind) const;
 
-    std::vector<std::wstring> _commands;
+    struct Entry
+    {
+        size_t offset;
+        size_t length;
+    };
+
+    std::wstring_view _Text(const Entry& entry) const noexcept;
+    std::wstring_view _Text(const SHORT index) const noexcept;
+    void _Append(const std::wstring_view command);
+    void _Erase(const SHORT index);
+    void _Clear() noexcept;
+    void _Compact();
+    void _RebuildIndex();
+    std::vector<SHORT>::iterator _FindInIndex(const SHORT index);
+
+    // The text of all commands is interned into a single string, each command followed by a null terminator.
+    // Removing commands leaves gaps behind, which are compacted away once they make up half of the arena.
+    std::wstring _arena;
+    size_t _arenaGaps = 0;
+    // The commands in history order (oldest first) as slices of _arena.
+    std::vector<Entry> _entries;
+    // Indices into _entries, sorted by the text of the command. All commands that
+    // start with a given prefix form a contiguous range, which turns duplicate
+    // detection and prefix searches into a binary search instead of a linear scan.
+    std::vector<SHORT> _sortedIndices;
     SHORT _maxCommands;
 
     std::wstring _appName;
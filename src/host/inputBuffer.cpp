@@ -150,7 +150,7 @@ void InputBuffer::ReinitializeInputBuffer()
 {
     ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
     InputMode = INPUT_BUFFER_DEFAULT_INPUT_MODE;
-    _storage.clear();
+    _ClearEvents();
 }
 
 // Routine Description:
@@ -185,7 +185,7 @@ void InputBuffer::TerminateRead(_In_ WaitTerminationReason Flag)
 // - The console lock must be held when calling this routine.
 size_t InputBuffer::GetNumberOfReadyEvents() const noexcept
 {
-    return _storage.size();
+    return _storage.size() - _storageBegin;
 }
 
 // Routine Description:
@@ -198,7 +198,7 @@ size_t InputBuffer::GetNumberOfReadyEvents() const noexcept
 // - The console lock must be held when calling this routine.
 void InputBuffer::Flush()
 {
-    _storage.clear();
+    _ClearEvents();
     ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
 }
 
@@ -212,12 +212,61 @@ void InputBuffer::Flush()
 // - The console lock must be held when calling this routine.
 void InputBuffer::FlushAllButKeys()
 {
-    auto newEnd = std::remove_if(_storage.begin(), _storage.end(), [](const std::unique_ptr<IInputEvent>& event) {
-        return event->EventType() != InputEventType::KeyEvent;
+    const auto newEnd = std::remove_if(_storage.begin() + _storageBegin, _storage.end(), [](const INPUT_RECORD& record) {
+        return record.EventType != KEY_EVENT;
     });
     _storage.erase(newEnd, _storage.end());
 }
 
+// Routine Description:
+// - Returns the events that are currently stored in the buffer.
+std::span<INPUT_RECORD> InputBuffer::_StoredEvents() noexcept
+{
+    return std::span{ _storage }.subspan(_storageBegin);
+}
+
+std::span<const INPUT_RECORD> InputBuffer::_StoredEvents() const noexcept
+{
+    return std::span{ _storage }.subspan(_storageBegin);
+}
+
+// Routine Description:
+// - Appends an event to the buffer.
+// - The space of events that were read already is reclaimed once it makes up at least half of
+//   the vector. Doing so any earlier would make reading and writing in lockstep quadratic.
+// Arguments:
+// - record - The event to store.
+// Note:
+// - will throw on failure
+void InputBuffer::_StoreEvent(const INPUT_RECORD& record)
+{
+    if (_storageBegin != 0 && _storage.size() == _storage.capacity() && _storageBegin >= _storage.size() / 2)
+    {
+        _storage.erase(_storage.begin(), _storage.begin() + _storageBegin);
+        _storageBegin = 0;
+    }
+    _storage.emplace_back(record);
+}
+
+// Routine Description:
+// - Removes the given number of events from the front of the buffer.
+void InputBuffer::_ConsumeEvents(const size_t count) noexcept
+{
+    _storageBegin += count;
+    if (_storageBegin >= _storage.size())
+    {
+        _ClearEvents();
+    }
+}
+
+// Routine Description:
+// - Removes all events from the buffer, but keeps its capacity around for later.
+void InputBuffer::_ClearEvents() noexcept
+{
+    _storage.clear();
+    _storageBegin = 0;
+}
+
 void InputBuffer::SetTerminalConnection(_In_ Render::VtEngine* const pTtyConnection)
 {
     this->_pTtyConnection = pTtyConnection;
@@ -245,26 +294,28 @@ void InputBuffer::PassThroughWin32MouseRequest(bool enable)
 // Note:
 // - The console lock must be held when calling this routine.
 // Arguments:
-// - OutEvents - deque to store the read events
-// - AmountToRead - the amount of events to try to read
-// - Peek - If true, copy events to pInputRecord but don't remove them from the input buffer.
+// - outRecords - where the read events are stored. The size of the span is the amount of events to try to read.
+// - eventsRead - on exit, the number of events stored in outRecords.
+// - Peek - If true, copy events to outRecords but don't remove them from the input buffer.
 // - WaitForData - if true, wait until an event is input (if there aren't enough to fill client buffer). if false, return immediately
 // - Unicode - true if the data in key events should be treated as unicode. false if they should be converted by the current input CP.
-// - Stream - true if read should unpack KeyEvents that have a >1 repeat count. AmountToRead must be 1 if Stream is true.
+// - Stream - true if read should unpack KeyEvents that have a >1 repeat count. outRecords must have a size of 1 if Stream is true.
 // Return Value:
 // - STATUS_SUCCESS if records were read into the client buffer and everything is OK.
 // - CONSOLE_STATUS_WAIT if there weren't enough records to satisfy the request (and waits are allowed)
 // - otherwise a suitable memory/math/string error in NTSTATUS form.
-[[nodiscard]] NTSTATUS InputBuffer::Read(_Out_ std::deque<std::unique_ptr<IInputEvent>>& OutEvents,
-                                         const size_t AmountToRead,
+[[nodiscard]] NTSTATUS InputBuffer::Read(const std::span<INPUT_RECORD> outRecords,
+                                         _Out_ size_t& eventsRead,
                                          const bool Peek,
                                          const bool WaitForData,
                                          const bool Unicode,
                                          const bool Stream)
 {
+    eventsRead = 0;
+
     try
     {
-        if (_storage.empty())
+        if (_StoredEvents().empty())
         {
             if (!WaitForData)
             {
@@ -273,25 +324,15 @@ void InputBuffer::PassThroughWin32MouseRequest(bool enable)
             return CONSOLE_STATUS_WAIT;
         }
 
-        // read from buffer
-        std::deque<std::unique_ptr<IInputEvent>> events;
-        size_t eventsRead;
         bool resetWaitEvent;
-        _ReadBuffer(events,
-                    AmountToRead,
+        _ReadBuffer(outRecords,
+                    outRecords.size(),
                     eventsRead,
                     Peek,
                     resetWaitEvent,
                     Unicode,
                     Stream);
 
-        // copy events to outEvents
-        while (!events.empty())
-        {
-            OutEvents.push_back(std::move(events.front()));
-            events.pop_front();
-        }
-
         if (resetWaitEvent)
         {
             ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
@@ -329,16 +370,17 @@ void InputBuffer::PassThroughWin32MouseRequest(bool enable)
     NTSTATUS Status;
     try
     {
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
-        Status = Read(outEvents,
-                      1,
+        INPUT_RECORD record;
+        size_t eventsRead;
+        Status = Read({ &record, 1 },
+                      eventsRead,
                       Peek,
                       WaitForData,
                       Unicode,
                       Stream);
-        if (!outEvents.empty())
+        if (eventsRead != 0)
         {
-            outEvent.swap(outEvents.front());
+            outEvent = IInputEvent::Create(record);
         }
     }
     catch (...)
@@ -352,7 +394,7 @@ void InputBuffer::PassThroughWin32MouseRequest(bool enable)
 // Routine Description:
 // - This routine reads from a buffer. It does the buffer manipulation.
 // Arguments:
-// - outEvents - where read events are placed
+// - outRecords - where read events are placed. Must be able to hold readCount events or all stored ones, whichever is fewer.
 // - readCount - amount of events to read
 // - eventsRead - where to store number of events read
 // - peek - if true , don't remove data from buffer, just copy it.
@@ -363,7 +405,7 @@ void InputBuffer::PassThroughWin32MouseRequest(bool enable)
 // - <none>
 // Note:
 // - The console lock must be held when calling this routine.
-void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& outEvents,
+void InputBuffer::_ReadBuffer(const std::span<INPUT_RECORD> outRecords,
                               const size_t readCount,
                               _Out_ size_t& eventsRead,
                               const bool peek,
@@ -376,98 +418,56 @@ void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& ou
     FAIL_FAST_IF(streamRead && readCount != 1);
 
     resetWaitEvent = false;
+    eventsRead = 0;
 
-    std::deque<std::unique_ptr<IInputEvent>> readEvents;
+    const auto events = _StoredEvents();
+    // the number of events that are removed from the buffer, unless we're peeking.
+    size_t consumed = 0;
     // we need another var to keep track of how many we've read
     // because dbcs records count for two when we aren't doing a
     // unicode read but the eventsRead count should return the number
     // of events actually put into outRecords.
     size_t virtualReadCount = 0;
 
-    while (!_storage.empty() && virtualReadCount < readCount)
+    while (consumed < events.size() && virtualReadCount < readCount)
     {
-        auto performNormalRead = true;
+        auto& event = til::at(events, consumed);
+        auto& outRecord = til::at(outRecords, eventsRead);
+        outRecord = event;
+        ++eventsRead;
+
         // for stream reads we need to split any key events that have been coalesced
-        if (streamRead)
+        if (streamRead && event.EventType == KEY_EVENT && event.Event.KeyEvent.wRepeatCount > 1)
         {
-            if (_storage.front()->EventType() == InputEventType::KeyEvent)
+            outRecord.Event.KeyEvent.wRepeatCount = 1;
+            if (!peek)
             {
-                const auto pKeyEvent = static_cast<KeyEvent* const>(_storage.front().get());
-                if (pKeyEvent->GetRepeatCount() > 1)
-                {
-                    // split the key event
-                    auto streamKeyEvent = std::make_unique<KeyEvent>(*pKeyEvent);
-                    streamKeyEvent->SetRepeatCount(1);
-                    readEvents.push_back(std::move(streamKeyEvent));
-                    pKeyEvent->SetRepeatCount(pKeyEvent->GetRepeatCount() - 1);
-                    performNormalRead = false;
-                }
+                event.Event.KeyEvent.wRepeatCount--;
             }
         }
-
-        if (performNormalRead)
+        else
         {
-            readEvents.push_back(std::move(_storage.front()));
-            _storage.pop_front();
+            ++consumed;
         }
 
         ++virtualReadCount;
         if (!unicode)
         {
-            if (readEvents.back()->EventType() == InputEventType::KeyEvent)
+            if (outRecord.EventType == KEY_EVENT && IsGlyphFullWidth(outRecord.Event.KeyEvent.uChar.UnicodeChar))
             {
-                const auto pKeyEvent = static_cast<const KeyEvent* const>(readEvents.back().get());
-                if (IsGlyphFullWidth(pKeyEvent->GetCharData()))
-                {
-                    ++virtualReadCount;
-                }
+                ++virtualReadCount;
             }
         }
     }
 
-    // the amount of events that were actually read
-    eventsRead = readEvents.size();
-
-    // copy the events back if we were supposed to peek
-    if (peek)
+    // leave the events where they are if we were supposed to peek
+    if (!peek)
     {
-        if (streamRead)
-        {
-            // we need to check and see if the event was split from a coalesced key event
-            // or if it was unrelated to the current front event in storage
-            if (!readEvents.empty() &&
-                !_storage.empty() &&
-                readEvents.back()->EventType() == InputEventType::KeyEvent &&
-                _storage.front()->EventType() == InputEventType::KeyEvent &&
-                _CanCoalesce(static_cast<const KeyEvent&>(*readEvents.back()),
-                             static_cast<const KeyEvent&>(*_storage.front())))
-            {
-                auto& keyEvent = static_cast<KeyEvent&>(*_storage.front());
-                keyEvent.SetRepeatCount(keyEvent.GetRepeatCount() + 1);
-            }
-            else
-            {
-                _storage.push_front(IInputEvent::Create(readEvents.back()->ToInputRecord()));
-            }
-        }
-        else
-        {
-            for (auto it = readEvents.crbegin(); it != readEvents.crend(); ++it)
-            {
-                _storage.push_front(IInputEvent::Create((*it)->ToInputRecord()));
-            }
-        }
-    }
-
-    // move events read to proper deque
-    while (!readEvents.empty())
-    {
-        outEvents.push_back(std::move(readEvents.front()));
-        readEvents.pop_front();
+        _ConsumeEvents(consumed);
     }
 
     // signal if we emptied the buffer
-    if (_storage.empty())
+    if (_StoredEvents().empty())
     {
         resetWaitEvent = true;
     }
@@ -477,57 +477,74 @@ void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& ou
 // -  Writes events to the beginning of the input buffer.
 // Arguments:
 // - inEvents - events to write to buffer.
-// - eventsWritten - The number of events written to the buffer on exit.
 // Return Value:
-// S_OK if successful.
+// - The number of events that were written to input buffer.
 // Note:
 // - The console lock must be held when calling this routine.
 size_t InputBuffer::Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+{
+    const auto eventsWritten = _Prepend(inEvents);
+    inEvents.clear();
+    return eventsWritten;
+}
+
+// Routine Description:
+// -  Writes records to the beginning of the input buffer.
+// Arguments:
+// - inRecords - records to write to buffer.
+// Return Value:
+// - The number of records that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::Prepend(const std::span<const INPUT_RECORD> inRecords)
+{
+    return _Prepend(inRecords);
+}
+
+template<typename Events>
+size_t InputBuffer::_Prepend(const Events& inEvents)
 {
     try
     {
         _vtInputShouldSuppress = true;
         auto resetVtInputSuppress = wil::scope_exit([&]() { _vtInputShouldSuppress = false; });
-        _HandleConsoleSuspensionEvents(inEvents);
-        if (inEvents.empty())
-        {
-            return STATUS_SUCCESS;
-        }
+
         // read all of the records out of the buffer, then write the
         // prepend ones, then write the original set. We need to do it
         // this way to handle any coalescing that might occur.
 
         // get all of the existing records, "emptying" the buffer
-        std::deque<std::unique_ptr<IInputEvent>> existingStorage;
+        std::vector<INPUT_RECORD> existingStorage;
         existingStorage.swap(_storage);
+        const auto existingBegin = std::exchange(_storageBegin, 0);
 
         // We will need this variable to pass to _WriteBuffer so it can attempt to determine wait status.
-        // However, because we swapped the storage out from under it with an empty deque, it will always
-        // return true after the first one (as it is filling the newly emptied backing deque.)
+        // However, because we swapped the storage out from under it with an empty one, it will always
+        // return true after the first one (as it is filling the newly emptied backing storage.)
         // Then after the second one, because we've inserted some input, it will always say false.
         auto unusedWaitStatus = false;
 
         // write the prepend records
         size_t prependEventsWritten;
-        _WriteBuffer(inEvents, prependEventsWritten, unusedWaitStatus);
+        _WriteEvents(inEvents, true, prependEventsWritten, unusedWaitStatus);
+        if (prependEventsWritten == 0)
+        {
+            // Only events that suspend or resume the console were given. Leave the buffer as it was.
+            existingStorage.swap(_storage);
+            _storageBegin = existingBegin;
+            return 0;
+        }
         FAIL_FAST_IF(!(unusedWaitStatus));
 
         // write all previously existing records
         size_t existingEventsWritten;
-        _WriteBuffer(existingStorage, existingEventsWritten, unusedWaitStatus);
+        _WriteBuffer(std::span<const INPUT_RECORD>{ existingStorage }.subspan(existingBegin), existingEventsWritten, unusedWaitStatus);
         FAIL_FAST_IF(!(!unusedWaitStatus));
 
-        // We need to set the wait event if there were 0 events in the
-        // input queue when we started.
-        // Because we did interesting manipulation of the wait queue
-        // in order to prepend, we can't trust what _WriteBuffer said
-        // and instead need to set the event if the original backing
-        // buffer (the one we swapped out at the top) was empty
-        // when this whole thing started.
-        if (existingStorage.empty())
-        {
-            ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
-        }
+        // Because we did interesting manipulation of the storage
+        // in order to prepend, we can't trust what _WriteBuffer said.
+        // We know however that the buffer isn't empty anymore.
+        ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
         WakeUpReadersWaitingForData();
 
         return prependEventsWritten;
@@ -576,20 +593,93 @@ size_t InputBuffer::Write(_Inout_ std::unique_ptr<IInputEvent> inEvent)
 // - The console lock must be held when calling this routine.
 size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
 {
+    const auto eventsWritten = _Write(inEvents);
+    inEvents.clear();
+    return eventsWritten;
+}
+
+// Routine Description:
+// - Writes records to the input buffer. Wakes up any readers that are
+// waiting for additional input events.
+// - Unlike the other overloads this doesn't allocate anything per record.
+// Arguments:
+// - inRecords - input records to store in the buffer.
+// Return Value:
+// - The number of records that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::Write(const std::span<const INPUT_RECORD> inRecords)
+{
+    return _Write(inRecords);
+}
+
+// Routine Description:
+// - Writes text that is already VT encoded to the input buffer, for instance
+//   the contents of a bracketed paste. Wakes up any readers that are waiting
+//   for additional input events.
+// - Every character is stored as a key down event without a virtual key,
+//   just like the ones TerminalInput generates. The text doesn't pass through
+//   TerminalInput as it wouldn't change it anyways and doing so would cost an
+//   allocation per character.
+// Arguments:
+// - text - The text to store in the buffer.
+// Return Value:
+// - The number of events that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::WriteVtInput(const std::wstring_view text)
+{
+    if (text.empty())
+    {
+        return 0;
+    }
+
     try
     {
-        _vtInputShouldSuppress = true;
-        auto resetVtInputSuppress = wil::scope_exit([&]() { _vtInputShouldSuppress = false; });
-        _HandleConsoleSuspensionEvents(inEvents);
-        if (inEvents.empty())
+        const auto initiallyEmptyQueue = _StoredEvents().empty();
+
+        INPUT_RECORD record{};
+        record.EventType = KEY_EVENT;
+        record.Event.KeyEvent.bKeyDown = TRUE;
+        record.Event.KeyEvent.wRepeatCount = 1;
+
+        for (const auto wch : text)
         {
-            return 0;
+            record.Event.KeyEvent.uChar.UnicodeChar = wch;
+            _StoreEvent(record);
         }
 
+        if (initiallyEmptyQueue)
+        {
+            ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
+        }
+
+        WakeUpReadersWaitingForData();
+        return text.size();
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
+
+template<typename Events>
+size_t InputBuffer::_Write(const Events& inEvents)
+{
+    try
+    {
+        _vtInputShouldSuppress = true;
+        auto resetVtInputSuppress = wil::scope_exit([&]() { _vtInputShouldSuppress = false; });
+
         // Write to buffer.
         size_t EventsWritten;
         bool SetWaitEvent;
-        _WriteBuffer(inEvents, EventsWritten, SetWaitEvent);
+        _WriteEvents(inEvents, true, EventsWritten, SetWaitEvent);
+        if (EventsWritten == 0)
+        {
+            return 0;
+        }
 
         if (SetWaitEvent)
         {
@@ -608,9 +698,9 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
 }
 
 // Routine Description:
-// - Coalesces input events and transfers them to storage queue.
+// - Coalesces input events and transfers them to storage.
 // Arguments:
-// - inRecords - The events to store.
+// - inEvents - The events to store.
 // - eventsWritten - The number of events written since this function
 // was called.
 // - setWaitEvent - on exit, true if buffer became non-empty.
@@ -619,146 +709,148 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
 // Note:
 // - The console lock must be held when calling this routine.
 // - will throw on failure
-void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
+void InputBuffer::_WriteBuffer(const std::deque<std::unique_ptr<IInputEvent>>& inEvents,
+                               _Out_ size_t& eventsWritten,
+                               _Out_ bool& setWaitEvent)
+{
+    _WriteEvents(inEvents, false, eventsWritten, setWaitEvent);
+}
+
+void InputBuffer::_WriteBuffer(const std::span<const INPUT_RECORD> inRecords,
+                               _Out_ size_t& eventsWritten,
+                               _Out_ bool& setWaitEvent)
+{
+    _WriteEvents(inRecords, false, eventsWritten, setWaitEvent);
+}
+
+static const INPUT_RECORD& _ToInputRecord(const INPUT_RECORD& inEvent) noexcept
+{
+    return inEvent;
+}
+
+static INPUT_RECORD _ToInputRecord(const std::unique_ptr<IInputEvent>& inEvent)
+{
+    return inEvent->ToInputRecord();
+}
+
+// Routine Description:
+// - Implements _WriteBuffer for both events and records.
+// Arguments:
+// - inEvents - The events to store.
+// - handleSuspension - true if events that suspend or resume the console should be processed and dropped.
+// - eventsWritten - The number of events written since this function
+// was called.
+// - setWaitEvent - on exit, true if buffer became non-empty.
+template<typename Events>
+void InputBuffer::_WriteEvents(const Events& inEvents,
+                               const bool handleSuspension,
                                _Out_ size_t& eventsWritten,
                                _Out_ bool& setWaitEvent)
 {
     eventsWritten = 0;
     setWaitEvent = false;
-    const auto initiallyEmptyQueue = _storage.empty();
-    const auto initialInEventsSize = inEvents.size();
+    const auto initiallyEmptyQueue = _StoredEvents().empty();
     const auto vtInputMode = IsInVirtualTerminalInputMode();
 
-    while (!inEvents.empty())
+    // Whether the last event was stored, and whether there was an event in front of it.
+    auto storedLastEvent = false;
+    auto storedBehindEvent = false;
+
+    for (const auto& inEvent : inEvents)
     {
-        // Pop the next event.
+        const auto& record = _ToInputRecord(inEvent);
+        if (handleSuspension && _HandleConsoleSuspensionEvent(record))
+        {
+            continue;
+        }
+
+        ++eventsWritten;
+        storedLastEvent = false;
+
         // If we're in vt mode, try and handle it with the vt input module.
         // If it was handled, do nothing else for it.
-        // If there was one event passed in, try coalescing it with the previous event currently in the buffer.
-        // If it's not coalesced, append it to the buffer.
-        auto inEvent = std::move(inEvents.front());
-        inEvents.pop_front();
-        if (vtInputMode)
+        if (vtInputMode && _HandleVtInputEvent(inEvent))
         {
-            // GH#11682: TerminalInput::HandleKey can handle both KeyEvents and Focus events seamlessly
-            const auto handled = _termInput.HandleKey(inEvent.get());
-            if (handled)
-            {
-                eventsWritten++;
-                continue;
-            }
+            continue;
         }
 
-        // we only check for possible coalescing when storing one
-        // record at a time because this is the original behavior of
-        // the input buffer. Changing this behavior may break stuff
-        // that was depending on it.
-        if (initialInEventsSize == 1 && !_storage.empty())
+        storedBehindEvent = !_StoredEvents().empty();
+        _StoreEvent(record);
+        storedLastEvent = true;
+    }
+
+    // we only check for possible coalescing when storing one
+    // record at a time because this is the original behavior of
+    // the input buffer. Changing this behavior may break stuff
+    // that was depending on it.
+    //
+    // this looks kinda weird but we don't want to coalesce a
+    // mouse event and then try to coalesce a key event right after.
+    if (eventsWritten == 1 && storedLastEvent && storedBehindEvent)
+    {
+        const auto events = _StoredEvents();
+        auto& lastEvent = til::at(events, events.size() - 2);
+        const auto& inEvent = events.back();
+        if (_CoalesceMouseMovedEvents(lastEvent, inEvent) ||
+            _CoalesceRepeatedKeyPressEvents(lastEvent, inEvent))
         {
-            // coalescing requires a deque of events, so push it back onto the front.
-            inEvents.push_front(std::move(inEvent));
-
-            auto coalesced = false;
-            // this looks kinda weird but we don't want to coalesce a
-            // mouse event and then try to coalesce a key event right after.
-            //
-            // we also pass the whole deque to the coalescing methods
-            // even though they only want one event because it should
-            // be their responsibility to maintain the correct state
-            // of the deque if they process any records in it.
-            if (_CoalesceMouseMovedEvents(inEvents))
-            {
-                coalesced = true;
-            }
-            else if (_CoalesceRepeatedKeyPressEvents(inEvents))
-            {
-                coalesced = true;
-            }
-            if (coalesced)
-            {
-                eventsWritten = 1;
-                return;
-            }
-            else
-            {
-                // We didn't coalesce the event. pull it from the queue again,
-                //  to keep the state consistent with the start of this block.
-                inEvent = std::move(inEvents.front());
-                inEvents.pop_front();
-            }
+            _storage.pop_back();
         }
-        // At this point, the event was neither coalesced, nor processed by VT.
-        _storage.push_back(std::move(inEvent));
-        ++eventsWritten;
     }
-    if (initiallyEmptyQueue && !_storage.empty())
+
+    if (initiallyEmptyQueue && !_StoredEvents().empty())
     {
         setWaitEvent = true;
     }
 }
 
 // Routine Description:
-// - Checks if the last saved event and the first event of inRecords are
+// - Checks if the last saved event and the incoming event are
 // both MOUSE_MOVED events. If they are, the last saved event is
-// updated with the new mouse position and the first event of inRecords is
-// dropped.
+// updated with the new mouse position.
 // Arguments:
-// - inRecords - The incoming records to process.
+// - lastEvent - The last event in the buffer.
+// - inEvent - The incoming event.
 // Return Value:
 // true if events were coalesced, false if they were not.
 // Note:
-// - The size of inRecords must be 1.
 // - Coalescing here means updating a record that already exists in
 // the buffer with updated values from an incoming event, instead of
 // storing the incoming event (which would make the original one
 // redundant/out of date with the most current state).
-bool InputBuffer::_CoalesceMouseMovedEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+bool InputBuffer::_CoalesceMouseMovedEvents(_Inout_ INPUT_RECORD& lastEvent, const INPUT_RECORD& inEvent) noexcept
 {
-    FAIL_FAST_IF(!(inEvents.size() == 1));
-    FAIL_FAST_IF(_storage.empty());
-    const IInputEvent* const pFirstInEvent = inEvents.front().get();
-    const IInputEvent* const pLastStoredEvent = _storage.back().get();
-    if (pFirstInEvent->EventType() == InputEventType::MouseEvent &&
-        pLastStoredEvent->EventType() == InputEventType::MouseEvent)
+    if (inEvent.EventType == MOUSE_EVENT &&
+        lastEvent.EventType == MOUSE_EVENT &&
+        inEvent.Event.MouseEvent.dwEventFlags == MOUSE_MOVED &&
+        lastEvent.Event.MouseEvent.dwEventFlags == MOUSE_MOVED)
     {
-        const auto pInMouseEvent = static_cast<const MouseEvent* const>(pFirstInEvent);
-        const auto pLastMouseEvent = static_cast<const MouseEvent* const>(pLastStoredEvent);
-
-        if (pInMouseEvent->IsMouseMoveEvent() &&
-            pLastMouseEvent->IsMouseMoveEvent())
-        {
-            // update mouse moved position
-            const auto pMouseEvent = static_cast<MouseEvent* const>(_storage.back().release());
-            pMouseEvent->SetPosition(pInMouseEvent->GetPosition());
-            std::unique_ptr<IInputEvent> tempPtr(pMouseEvent);
-            tempPtr.swap(_storage.back());
-
-            inEvents.pop_front();
-            return true;
-        }
+        // update mouse moved position
+        lastEvent.Event.MouseEvent.dwMousePosition = inEvent.Event.MouseEvent.dwMousePosition;
+        return true;
     }
     return false;
 }
 
 // Routine Description:
-// - checks two KeyEvents to see if they're similar enough to be coalesced
+// - checks two key events to see if they're similar enough to be coalesced
 // Arguments:
-// - a - the first KeyEvent
-// - b - the other KeyEvent
+// - a - the first key event
+// - b - the other key event
 // Return Value:
 // - true if the events could be coalesced, false otherwise
-bool InputBuffer::_CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexcept
+bool InputBuffer::_CanCoalesce(const KEY_EVENT_RECORD& a, const KEY_EVENT_RECORD& b) const noexcept
 {
-    if (WI_IsFlagSet(a.GetActiveModifierKeys(), NLS_IME_CONVERSION) &&
-        a.GetCharData() == b.GetCharData() &&
-        a.GetActiveModifierKeys() == b.GetActiveModifierKeys())
+    if (WI_IsFlagSet(a.dwControlKeyState, NLS_IME_CONVERSION) &&
+        a.uChar.UnicodeChar == b.uChar.UnicodeChar &&
+        a.dwControlKeyState == b.dwControlKeyState)
     {
         return true;
     }
     // other key events check
-    else if (a.GetVirtualScanCode() == b.GetVirtualScanCode() &&
-             a.GetCharData() == b.GetCharData() &&
-             a.GetActiveModifierKeys() == b.GetActiveModifierKeys())
+    else if (a.wVirtualScanCode == b.wVirtualScanCode &&
+             a.uChar.UnicodeChar == b.uChar.UnicodeChar &&
+             a.dwControlKeyState == b.dwControlKeyState)
     {
         return true;
     }
@@ -766,44 +858,34 @@ bool InputBuffer::_CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexc
 }
 
 // Routine Description::
-// - If the last input event saved and the first input event in inRecords
-// are both a keypress down event for the same key, update the repeat
-// count of the saved event and drop the first from inRecords.
+// - If the last input event saved and the incoming event are both a
+// keypress down event for the same key, update the repeat count of
+// the saved event.
 // Arguments:
-// - inRecords - The incoming records to process.
+// - lastEvent - The last event in the buffer.
+// - inEvent - The incoming event.
 // Return Value:
 // true if events were coalesced, false if they were not.
 // Note:
-// - The size of inRecords must be 1.
 // - Coalescing here means updating a record that already exists in
 // the buffer with updated values from an incoming event, instead of
 // storing the incoming event (which would make the original one
 // redundant/out of date with the most current state).
-bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
-{
-    FAIL_FAST_IF(!(inEvents.size() == 1));
-    FAIL_FAST_IF(_storage.empty());
-    const IInputEvent* const pFirstInEvent = inEvents.front().get();
-    const IInputEvent* const pLastStoredEvent = _storage.back().get();
-    if (pFirstInEvent->EventType() == InputEventType::KeyEvent &&
-        pLastStoredEvent->EventType() == InputEventType::KeyEvent)
-    {
-        const auto pInKeyEvent = static_cast<const KeyEvent* const>(pFirstInEvent);
-        const auto pLastKeyEvent = static_cast<const KeyEvent* const>(pLastStoredEvent);
-
-        if (pInKeyEvent->IsKeyDown() &&
-            pLastKeyEvent->IsKeyDown() &&
-            !IsGlyphFullWidth(pInKeyEvent->GetCharData()) &&
-            _CanCoalesce(*pInKeyEvent, *pLastKeyEvent))
+bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ INPUT_RECORD& lastEvent, const INPUT_RECORD& inEvent) noexcept
+{
+    if (inEvent.EventType == KEY_EVENT &&
+        lastEvent.EventType == KEY_EVENT)
+    {
+        const auto& inKeyEvent = inEvent.Event.KeyEvent;
+        auto& lastKeyEvent = lastEvent.Event.KeyEvent;
+
+        if (inKeyEvent.bKeyDown &&
+            lastKeyEvent.bKeyDown &&
+            !IsGlyphFullWidth(inKeyEvent.uChar.UnicodeChar) &&
+            _CanCoalesce(inKeyEvent, lastKeyEvent))
         {
             // increment repeat count
-            const auto pKeyEvent = static_cast<KeyEvent* const>(_storage.back().release());
-            WORD repeatCount = pKeyEvent->GetRepeatCount() + pInKeyEvent->GetRepeatCount();
-            pKeyEvent->SetRepeatCount(repeatCount);
-            std::unique_ptr<IInputEvent> tempPtr(pKeyEvent);
-            tempPtr.swap(_storage.back());
-
-            inEvents.pop_front();
+            lastKeyEvent.wRepeatCount = gsl::narrow_cast<WORD>(lastKeyEvent.wRepeatCount + inKeyEvent.wRepeatCount);
             return true;
         }
     }
@@ -813,42 +895,64 @@ bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique
 // Routine Description:
 // - Handles records that suspend/resume the console.
 // Arguments:
-// - records - records to check for pause/unpause events
+// - inEvent - record to check for pause/unpause events
 // Return Value:
-// - None
+// - true if the record was handled and must not be stored.
 // Note:
 // - The console lock must be held when calling this routine.
-// - will throw exception on error
-void InputBuffer::_HandleConsoleSuspensionEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+bool InputBuffer::_HandleConsoleSuspensionEvent(const INPUT_RECORD& inEvent)
 {
-    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
-
-    std::deque<std::unique_ptr<IInputEvent>> outEvents;
-    while (!inEvents.empty())
+    if (inEvent.EventType == KEY_EVENT && inEvent.Event.KeyEvent.bKeyDown)
     {
-        auto currEvent = std::move(inEvents.front());
-        inEvents.pop_front();
-        if (currEvent->EventType() == InputEventType::KeyEvent)
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto virtualKeyCode = inEvent.Event.KeyEvent.wVirtualKeyCode;
+
+        if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) &&
+            !IsSystemKey(virtualKeyCode))
         {
-            const auto pKeyEvent = static_cast<const KeyEvent* const>(currEvent.get());
-            if (pKeyEvent->IsKeyDown())
-            {
-                if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) &&
-                    !IsSystemKey(pKeyEvent->GetVirtualKeyCode()))
-                {
-                    UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
-                    continue;
-                }
-                else if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && pKeyEvent->IsPauseKey())
-                {
-                    WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
-                    continue;
-                }
-            }
+            UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
+            return true;
+        }
+        else if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && virtualKeyCode == VK_PAUSE)
+        {
+            WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
+            return true;
         }
-        outEvents.push_back(std::move(currEvent));
     }
-    inEvents.swap(outEvents);
+    return false;
+}
+
+// Routine Description:
+// - Offers an event to the vt input module.
+// - Records are turned into temporary events on the stack, because only key
+//   and focus events are of interest to it.
+// Arguments:
+// - inEvent - the event to offer
+// Return Value:
+// - true if the event was translated and must not be stored.
+bool InputBuffer::_HandleVtInputEvent(const INPUT_RECORD& inEvent)
+{
+    switch (inEvent.EventType)
+    {
+    case KEY_EVENT:
+    {
+        const KeyEvent keyEvent{ inEvent.Event.KeyEvent };
+        return _termInput.HandleKey(&keyEvent);
+    }
+    case FOCUS_EVENT:
+    {
+        const FocusEvent focusEvent{ inEvent.Event.FocusEvent };
+        return _termInput.HandleKey(&focusEvent);
+    }
+    default:
+        return false;
+    }
+}
+
+bool InputBuffer::_HandleVtInputEvent(const std::unique_ptr<IInputEvent>& inEvent)
+{
+    // GH#11682: TerminalInput::HandleKey can handle both KeyEvents and Focus events seamlessly
+    return _termInput.HandleKey(inEvent.get());
 }
 
 // Routine Description:
@@ -874,12 +978,11 @@ void InputBuffer::_HandleTerminalInputCallback(std::deque<std::unique_ptr<IInput
     try
     {
         // add all input events to the storage queue
-        while (!inEvents.empty())
+        for (const auto& inEvent : inEvents)
         {
-            auto inEvent = std::move(inEvents.front());
-            inEvents.pop_front();
-            _storage.push_back(std::move(inEvent));
+            _StoreEvent(inEvent->ToInputRecord());
         }
+        inEvents.clear();
 
         if (!_vtInputShouldSuppress)
         {
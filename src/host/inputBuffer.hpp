@@ -60,23 +60,26 @@ public:
     void Flush();
     void FlushAllButKeys();
 
-    [[nodiscard]] NTSTATUS Read(_Out_ std::deque<std::unique_ptr<IInputEvent>>& OutEvents,
-                                const size_t AmountToRead,
+    [[nodiscard]] NTSTATUS Read(_Out_ std::unique_ptr<IInputEvent>& inEvent,
                                 const bool Peek,
                                 const bool WaitForData,
                                 const bool Unicode,
                                 const bool Stream);
 
-    [[nodiscard]] NTSTATUS Read(_Out_ std::unique_ptr<IInputEvent>& inEvent,
+    [[nodiscard]] NTSTATUS Read(const std::span<INPUT_RECORD> outRecords,
+                                _Out_ size_t& eventsRead,
                                 const bool Peek,
                                 const bool WaitForData,
                                 const bool Unicode,
                                 const bool Stream);
 
     size_t Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    size_t Prepend(const std::span<const INPUT_RECORD> inRecords);
 
     size_t Write(_Inout_ std::unique_ptr<IInputEvent> inEvent);
     size_t Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    size_t Write(const std::span<const INPUT_RECORD> inRecords);
+    size_t WriteVtInput(const std::wstring_view text);
 
     bool IsInVirtualTerminalInputMode() const;
     Microsoft::Console::VirtualTerminal::TerminalInput& GetTerminalInput();
@@ -84,7 +87,11 @@ public:
     void PassThroughWin32MouseRequest(bool enable);
 
 private:
-    std::deque<std::unique_ptr<IInputEvent>> _storage;
+    // The buffered events are the ones in [_storageBegin, _storage.size()). Reading only advances
+    // _storageBegin and the space in front of it is reclaimed once it makes up half of the vector.
+    // This way neither reading nor writing needs an allocation per event.
+    std::vector<INPUT_RECORD> _storage;
+    size_t _storageBegin = 0;
     std::unique_ptr<IInputEvent> _readPartialByteSequence;
     std::unique_ptr<IInputEvent> _writePartialByteSequence;
     Microsoft::Console::VirtualTerminal::TerminalInput _termInput;
@@ -96,7 +103,13 @@ private:
     // Otherwise, we should be calling them.
     bool _vtInputShouldSuppress{ false };
 
-    void _ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& outEvents,
+    std::span<INPUT_RECORD> _StoredEvents() noexcept;
+    std::span<const INPUT_RECORD> _StoredEvents() const noexcept;
+    void _StoreEvent(const INPUT_RECORD& record);
+    void _ConsumeEvents(const size_t count) noexcept;
+    void _ClearEvents() noexcept;
+
+    void _ReadBuffer(const std::span<INPUT_RECORD> outRecords,
                      const size_t readCount,
                      _Out_ size_t& eventsRead,
                      const bool peek,
@@ -104,14 +117,28 @@ private:
                      const bool unicode,
                      const bool streamRead);
 
-    void _WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inRecords,
+    void _WriteBuffer(const std::deque<std::unique_ptr<IInputEvent>>& inEvents,
                       _Out_ size_t& eventsWritten,
                       _Out_ bool& setWaitEvent);
-
-    bool _CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexcept;
-    bool _CoalesceMouseMovedEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    bool _CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
-    void _HandleConsoleSuspensionEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
+    void _WriteBuffer(const std::span<const INPUT_RECORD> inRecords,
+                      _Out_ size_t& eventsWritten,
+                      _Out_ bool& setWaitEvent);
+    template<typename Events>
+    void _WriteEvents(const Events& inEvents,
+                      const bool handleSuspension,
+                      _Out_ size_t& eventsWritten,
+                      _Out_ bool& setWaitEvent);
+    template<typename Events>
+    size_t _Write(const Events& inEvents);
+    template<typename Events>
+    size_t _Prepend(const Events& inEvents);
+
+    bool _CanCoalesce(const KEY_EVENT_RECORD& a, const KEY_EVENT_RECORD& b) const noexcept;
+    bool _CoalesceMouseMovedEvents(_Inout_ INPUT_RECORD& lastEvent, const INPUT_RECORD& inEvent) noexcept;
+    bool _CoalesceRepeatedKeyPressEvents(_Inout_ INPUT_RECORD& lastEvent, const INPUT_RECORD& inEvent) noexcept;
+    bool _HandleConsoleSuspensionEvent(const INPUT_RECORD& inEvent);
+    bool _HandleVtInputEvent(const INPUT_RECORD& inEvent);
+    bool _HandleVtInputEvent(const std::unique_ptr<IInputEvent>& inEvent);
 
     void _HandleTerminalInputCallback(_In_ std::deque<std::unique_ptr<IInputEvent>>& inEvents);
 
@@ -183,23 +183,34 @@ BOOL CheckBisectProcessW(const SCREEN_INFORMATION& ScreenInfo,
 }
 
 // Routine Description:
-// - Converts all key events in the deque to the oem char data and adds
-// them back to events.
+// - Converts all key events in the first count records to the oem char data
+// in place. Chars that convert to more than one byte are split into one key
+// event per byte, which moves the records after them back.
 // Arguments:
-// - events - on input the IInputEvents to convert. on output, the
-// converted input events
-// Note: may throw on error
-void SplitToOem(std::deque<std::unique_ptr<IInputEvent>>& events)
+// - records - on input, holds the records to convert in [0, count). on output,
+// the converted records.
+// - count - the number of records to convert
+// - partialEvent - on output, the converted key event that didn't fit into
+// records anymore, if any. There can be at most one, as long as the records
+// were read with dbcs chars counting for two.
+// Return Value:
+// - the number of converted records stored in records
+// Note: may throw on error, in which case records is left unchanged
+size_t SplitToOem(const std::span<INPUT_RECORD> records,
+                  const size_t count,
+                  _Out_ std::unique_ptr<IInputEvent>& partialEvent)
 {
     const auto cp = ServiceLocator::LocateGlobals().getConsoleInformation().CP;
-    std::deque<std::unique_ptr<IInputEvent>> convertedEvents;
+    partialEvent.reset();
+
+    std::vector<INPUT_RECORD> convertedRecords;
+    convertedRecords.reserve(count + 1);
 
-    for (auto& currentEvent : events)
+    for (const auto& record : records.first(count))
     {
-        if (currentEvent->EventType() == InputEventType::KeyEvent)
+        if (record.EventType == KEY_EVENT)
         {
-            const auto pKeyEvent = static_cast<const KeyEvent* const>(currentEvent.get());
-            const auto wch = pKeyEvent->GetCharData();
+            const auto wch = record.Event.KeyEvent.uChar.UnicodeChar;
 
             char buffer[8];
             const auto length = WideCharToMultiByte(cp, 0, &wch, 1, &buffer[0], sizeof(buffer), nullptr, nullptr);
@@ -209,18 +220,27 @@ void SplitToOem(std::deque<std::unique_ptr<IInputEvent>>& events)
 
             for (const auto& ch : str)
             {
-                auto tempEvent = std::make_unique<KeyEvent>(*pKeyEvent);
-                tempEvent->SetCharData(ch);
-                convertedEvents.push_back(std::move(tempEvent));
+                auto& converted = convertedRecords.emplace_back(record);
+                // See KeyEvent::SetCharData(char) for why the char is converted as unsigned.
+                converted.Event.KeyEvent.uChar.UnicodeChar = til::as_unsigned(ch);
             }
         }
         else
         {
-            convertedEvents.push_back(std::move(currentEvent));
+            convertedRecords.emplace_back(record);
         }
     }
 
-    events = std::move(convertedEvents);
+    const auto written = std::min(convertedRecords.size(), records.size());
+    std::copy_n(convertedRecords.begin(), written, records.begin());
+
+    if (convertedRecords.size() > written)
+    {
+        FAIL_FAST_IF(convertedRecords.size() - written > 1);
+        partialEvent = IInputEvent::Create(convertedRecords.back());
+    }
+
+    return written;
 }
 
 // Routine Description:
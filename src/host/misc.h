@@ -44,7 +44,9 @@ int ConvertToOem(const UINT uiCodePage,
                  _Out_writes_(cchTarget) CHAR* const pchTarget,
                  const UINT cchTarget) noexcept;
 
-void SplitToOem(std::deque<std::unique_ptr<IInputEvent>>& events);
+size_t SplitToOem(const std::span<INPUT_RECORD> records,
+                  const size_t count,
+                  _Out_ std::unique_ptr<IInputEvent>& partialEvent);
 
 int ConvertInputToUnicode(const UINT uiCodePage,
                           _In_reads_(cchSource) const CHAR* const pchSource,
@@ -282,6 +282,85 @@ void COOKED_READ_DATA::SetReportedByteCount(const size_t count) noexcept
     *_pdwNumBytes = count;
 }
 
+// Routine Description:
+// - Redraws the edit line after the characters from the given index onwards have changed.
+// - The characters in front of it are unchanged and still on the screen. Only the rest of the
+//   line is written, starting at the cursor, and any cells the previous line occupied beyond the
+//   end of the new one are blanked. An edit thus costs as much as the text behind it, instead of
+//   erasing and writing the whole line.
+// Arguments:
+// - changedBegin - The index of the first changed character. The cursor must be where it was displayed.
+// - dwFlags - The flags to write the rest of the line with. See WriteCharsLegacy.
+// - pScrollY - Optional. Incremented by the number of rows the screen buffer scrolled by.
+// Return Value:
+// - The status of writing the line.
+[[nodiscard]] NTSTATUS COOKED_READ_DATA::RedrawFrom(const size_t changedBegin, const DWORD dwFlags, til::CoordType* const pScrollY)
+{
+    const auto& cursor = _screenInfo.GetTextBuffer().GetCursor();
+    const auto cursorPosition = cursor.GetPosition();
+    const auto bufferWidth = _screenInfo.GetBufferSize().Width();
+    const auto cellsInFront = (cursorPosition.y - _originalCursorPosition.y) * bufferWidth + cursorPosition.x - _originalCursorPosition.x;
+
+    // If the line has scrolled off the top of the buffer or the cursor is waiting to wrap,
+    // we can't tell how many cells are in front of the cursor. Redraw the whole line then.
+    if (_originalCursorPosition.y < 0 || cursor.IsDelayedEOLWrap() || cellsInFront < 0)
+    {
+        DeleteCommandLine(*this, false);
+
+        auto NumToWrite = _bytesRead;
+        return WriteCharsLegacy(_screenInfo,
+                                _backupLimit,
+                                _backupLimit,
+                                _backupLimit,
+                                &NumToWrite,
+                                &_visibleCharCount,
+                                _originalCursorPosition.x,
+                                dwFlags,
+                                pScrollY);
+    }
+
+    const auto previousVisibleCharCount = _visibleCharCount;
+    til::CoordType ScrollY = 0;
+    size_t NumSpaces = 0;
+    auto NumToWrite = _bytesRead - changedBegin * sizeof(WCHAR);
+    const auto status = WriteCharsLegacy(_screenInfo,
+                                         _backupLimit,
+                                         _backupLimit + changedBegin,
+                                         _backupLimit + changedBegin,
+                                         &NumToWrite,
+                                         &NumSpaces,
+                                         _originalCursorPosition.x,
+                                         dwFlags,
+                                         &ScrollY);
+    if (!NT_SUCCESS(status))
+    {
+        return status;
+    }
+
+    if (pScrollY)
+    {
+        *pScrollY += ScrollY;
+    }
+
+    _visibleCharCount = gsl::narrow_cast<size_t>(cellsInFront) + NumSpaces;
+
+    // Blank the cells that erasing the previous line with DeleteCommandLine would have blanked
+    // and the new line doesn't cover, so that the screen ends up with the same contents.
+    if (const auto deleteLength = GetCommandLineDeleteLength(*this, previousVisibleCharCount); _visibleCharCount < deleteLength)
+    {
+        const auto end = _originalCursorPosition.x + gsl::narrow_cast<til::CoordType>(_visibleCharCount);
+        const til::point blankPosition{ end % bufferWidth, _originalCursorPosition.y + ScrollY + end / bufferWidth };
+
+        try
+        {
+            _screenInfo.Write(OutputCellIterator(UNICODE_SPACE, deleteLength - _visibleCharCount), blankPosition);
+        }
+        CATCH_LOG();
+    }
+
+    return status;
+}
+
 // Routine Description:
 // - resets the prompt to be as if it was erased
 void COOKED_READ_DATA::Erase() noexcept
@@ -580,6 +659,9 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
         auto CallWrite = true;
         const auto sScreenBufferSizeX = _screenInfo.GetBufferSize().Width();
 
+        // the index of the first character that changed
+        size_t changedBegin = 0;
+
         // processing in the middle of the line is more complex:
 
         // calculate new cursor position
@@ -643,6 +725,8 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
                         loop = true;
                     }
                 }
+
+                changedBegin = _currentPosition;
             }
             else
             {
@@ -684,6 +768,7 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
                             _bytesRead - (_currentPosition * sizeof(WCHAR)));
                     _bytesRead += sizeof(WCHAR);
                 }
+                changedBegin = _currentPosition;
                 *_bufPtr = wch;
                 _bufPtr += 1;
                 _currentPosition += 1;
@@ -708,29 +793,32 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
             CursorPosition = _screenInfo.GetTextBuffer().GetCursor().GetPosition();
             CursorPosition.x = (til::CoordType)(CursorPosition.x + NumSpaces);
 
-            // clear the current command line from the screen
-            // clang-format off
-#pragma prefast(suppress: __WARNING_BUFFER_OVERFLOW, "Not sure why prefast doesn't like this call.")
-            // clang-format on
-            DeleteCommandLine(*this, FALSE);
-
-            // write the new command line to the screen
-            NumToWrite = _bytesRead;
-
-            DWORD dwFlags = WC_DESTRUCTIVE_BACKSPACE | WC_PRINTABLE_CONTROL_CHARS;
             if (wch == UNICODE_CARRIAGERETURN)
             {
-                dwFlags |= WC_KEEP_CURSOR_VISIBLE;
+                // clear the current command line from the screen
+                // clang-format off
+#pragma prefast(suppress: __WARNING_BUFFER_OVERFLOW, "Not sure why prefast doesn't like this call.")
+                // clang-format on
+                DeleteCommandLine(*this, FALSE);
+
+                // write the new command line to the screen
+                NumToWrite = _bytesRead;
+                status = WriteCharsLegacy(_screenInfo,
+                                          _backupLimit,
+                                          _backupLimit,
+                                          _backupLimit,
+                                          &NumToWrite,
+                                          &_visibleCharCount,
+                                          _originalCursorPosition.x,
+                                          WC_DESTRUCTIVE_BACKSPACE | WC_PRINTABLE_CONTROL_CHARS | WC_KEEP_CURSOR_VISIBLE,
+                                          &ScrollY);
+            }
+            else
+            {
+                // The cursor is still where the first changed character was displayed.
+                // Everything in front of it is unchanged, so only the rest of the line needs to be written.
+                status = RedrawFrom(changedBegin, WC_DESTRUCTIVE_BACKSPACE | WC_PRINTABLE_CONTROL_CHARS, &ScrollY);
             }
-            status = WriteCharsLegacy(_screenInfo,
-                                      _backupLimit,
-                                      _backupLimit,
-                                      _backupLimit,
-                                      &NumToWrite,
-                                      &_visibleCharCount,
-                                      _originalCursorPosition.x,
-                                      dwFlags,
-                                      &ScrollY);
             if (!NT_SUCCESS(status))
             {
                 RIPMSG1(RIP_WARNING, "WriteCharsLegacy failed 0x%x", status);
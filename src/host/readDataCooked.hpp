@@ -105,6 +105,7 @@ public:
     void SetReportedByteCount(const size_t count) noexcept;
 
     void Erase() noexcept;
+    [[nodiscard]] NTSTATUS RedrawFrom(const size_t changedBegin, const DWORD dwFlags, til::CoordType* const pScrollY);
     size_t SavePromptToUserBuffer(const size_t cch);
     void SavePendingInput(const size_t cch, const bool multiline);
 
@@ -28,8 +28,7 @@ DirectReadData::DirectReadData(_In_ InputBuffer* const pInputBuffer,
                                _In_ std::deque<std::unique_ptr<IInputEvent>> partialEvents) :
     ReadData(pInputBuffer, pInputReadHandleData),
     _eventReadCount{ eventReadCount },
-    _partialEvents{ std::move(partialEvents) },
-    _outEvents{}
+    _partialEvents{ std::move(partialEvents) }
 {
 }
 
@@ -53,12 +52,11 @@ DirectReadData::~DirectReadData() = default;
 // - pReplyStatus - The status code to return to the client
 // application that originally called the API (before it was queued to
 // wait)
-// - pNumBytes - not used
+// - pNumBytes - on output, the number of bytes stored in the std::span pointed to by pOutputData
 // - pControlKeyState - For certain types of reads, this specifies
 // which modifier keys were held.
-// - pOutputData - a pointer to a
-// std::deque<std::unique_ptr<IInputEvent>> that is used to the read
-// input events back to the server
+// - pOutputData - a pointer to a std::span<INPUT_RECORD> wrapping the
+// client's buffer, into which the read input events are stored
 // Return Value:
 // - true if the wait is done and result buffer/status code can be sent back to the client.
 // - false if we need to continue to wait until more data is available.
@@ -80,7 +78,9 @@ bool DirectReadData::Notify(const WaitTerminationReason TerminationReason,
     *pControlKeyState = 0;
     *pNumBytes = 0;
     auto retVal = true;
-    std::deque<std::unique_ptr<IInputEvent>> readEvents;
+    const auto& clientRecords = *static_cast<std::span<INPUT_RECORD>*>(pOutputData);
+    const auto outRecords = clientRecords.first(std::min(_eventReadCount, clientRecords.size()));
+    size_t recordsRead = 0;
 
     // If ctrl-c or ctrl-break was seen, ignore it.
     if (WI_IsAnyFlagSet(TerminationReason, (WaitTerminationReason::CtrlC | WaitTerminationReason::CtrlBreak)))
@@ -116,22 +116,15 @@ bool DirectReadData::Notify(const WaitTerminationReason TerminationReason,
         // thread or a write routine.  both of these callers grab the
         // current console lock.
 
-        // calculate how many events we need to read
-        size_t amountAlreadyRead;
-        if (FAILED(SizeTAdd(_partialEvents.size(), _outEvents.size(), &amountAlreadyRead)))
-        {
-            *pReplyStatus = STATUS_INTEGER_OVERFLOW;
-            return retVal;
-        }
-        size_t amountToRead;
-        if (FAILED(SizeTSub(_eventReadCount, amountAlreadyRead, &amountToRead)))
+        // the partial events go first, the events read from the input buffer after them.
+        if (_partialEvents.size() > outRecords.size())
         {
             *pReplyStatus = STATUS_INTEGER_OVERFLOW;
             return retVal;
         }
 
-        *pReplyStatus = _pInputBuffer->Read(readEvents,
-                                            amountToRead,
+        *pReplyStatus = _pInputBuffer->Read(outRecords.subspan(_partialEvents.size()),
+                                            recordsRead,
                                             false,
                                             false,
                                             fIsUnicode,
@@ -150,41 +143,27 @@ bool DirectReadData::Notify(const WaitTerminationReason TerminationReason,
         {
             try
             {
-                SplitToOem(readEvents);
+                std::unique_ptr<IInputEvent> partialEvent;
+                recordsRead = SplitToOem(outRecords.subspan(_partialEvents.size()), recordsRead, partialEvent);
+
+                // store partial event if necessary
+                if (partialEvent)
+                {
+                    _pInputBuffer->StoreReadPartialByteSequence(std::move(partialEvent));
+                }
             }
             CATCH_LOG();
         }
 
-        // combine partial and whole events
-        while (!_partialEvents.empty())
-        {
-            readEvents.push_front(std::move(_partialEvents.back()));
-            _partialEvents.pop_back();
-        }
-
-        // move read events to out storage
-        for (size_t i = 0; i < _eventReadCount; ++i)
-        {
-            if (readEvents.empty())
-            {
-                break;
-            }
-            _outEvents.push_back(std::move(readEvents.front()));
-            readEvents.pop_front();
-        }
-
-        // store partial event if necessary
-        if (!readEvents.empty())
+        // the partial events are stored in front of the read ones
+        const auto partialCount = std::min(_partialEvents.size(), outRecords.size());
+        for (size_t i = 0; i < partialCount; ++i)
         {
-            _pInputBuffer->StoreReadPartialByteSequence(std::move(readEvents.front()));
-            readEvents.pop_front();
-            FAIL_FAST_IF(!(readEvents.empty()));
+            til::at(outRecords, i) = _partialEvents[i]->ToInputRecord();
         }
+        _partialEvents.clear();
 
-        // move events to pOutputData
-        const auto pOutputDeque = reinterpret_cast<std::deque<std::unique_ptr<IInputEvent>>* const>(pOutputData);
-        *pNumBytes = _outEvents.size() * sizeof(INPUT_RECORD);
-        pOutputDeque->swap(_outEvents);
+        *pNumBytes = (partialCount + recordsRead) * sizeof(INPUT_RECORD);
     }
     return retVal;
 }
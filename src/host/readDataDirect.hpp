@@ -51,5 +51,4 @@ public:
 private:
     const size_t _eventReadCount;
     std::deque<std::unique_ptr<IInputEvent>> _partialEvents;
-    std::deque<std::unique_ptr<IInputEvent>> _outEvents;
 };
@@ -58,6 +58,29 @@ class AliasTests
         expected = targetExpectedPair.Mid(sepIndex + 1);
     }
 
+    void _AddAlias(const std::wstring_view target)
+    {
+        std::wstring exe(L"test.exe");
+        std::wstring alias(L"alias");
+        std::wstring targetString(target);
+        Alias::s_TestAddAlias(exe, alias, targetString);
+    }
+
+    // Expands the given target as the target of the alias "alias" for the given command line,
+    // the same way s_MatchAndCopyAlias does.
+    std::wstring _ExpandCompiled(const std::wstring_view target, const std::wstring_view commandLine)
+    {
+        _AddAlias(target);
+
+        Alias::Arguments arguments;
+        const auto compiled = Alias::s_FindCompiledTarget(commandLine, L"test.exe", arguments);
+        VERIFY_IS_NOT_NULL(compiled);
+
+        std::wstring actual(Alias::s_ExpandedLength(*compiled, arguments), L'\0');
+        Alias::s_Expand(*compiled, arguments, actual.data());
+        return actual;
+    }
+
     TEST_METHOD(TestMatchAndCopy)
     {
         BEGIN_TEST_METHOD_PROPERTIES()
@@ -365,6 +388,44 @@ class AliasTests
         VERIFY_ARE_EQUAL(dwLinesBefore, dwLines, L"Line count should pass through.");
     }
 
+    TEST_METHOD(TestMatchAndCopyRedefinedAlias)
+    {
+        std::wstring exe(L"exe.exe");
+        std::wstring source(L"Source");
+        std::wstring target(L"first $1");
+        Alias::s_TestAddAlias(exe, source, target);
+
+        size_t lineCount = 0;
+        auto actual = Alias::s_MatchAndCopyAlias(L"source one two", exe, lineCount);
+        VERIFY_ARE_EQUAL(String(L"first one\r\n"), String(actual.c_str()));
+        VERIFY_ARE_EQUAL(1u, lineCount);
+
+        // Redefining the alias must replace its compiled expansion as well.
+        target = L"second $2$t$*";
+        Alias::s_TestAddAlias(exe, source, target);
+
+        actual = Alias::s_MatchAndCopyAlias(L"SOURCE one two", exe, lineCount);
+        VERIFY_ARE_EQUAL(String(L"second two\r\none two\r\n"), String(actual.c_str()));
+        VERIFY_ARE_EQUAL(2u, lineCount);
+    }
+
+    TEST_METHOD(CompileTarget)
+    {
+        const auto compiled = Alias::s_CompileTarget(L"a$1b$*$Tc$Gd$$");
+
+        // Everything but the argument references is expanded right away.
+        VERIFY_ARE_EQUAL(String(L"ab\r\nc>d$$\r\n"), String(compiled.literals.c_str()));
+        VERIFY_ARE_EQUAL(2u, compiled.lineCount);
+
+        VERIFY_ARE_EQUAL(3u, compiled.segments.size());
+        VERIFY_ARE_EQUAL(1u, compiled.segments[0].literalLength);
+        VERIFY_ARE_EQUAL(1u, compiled.segments[0].argument);
+        VERIFY_ARE_EQUAL(1u, compiled.segments[1].literalLength);
+        VERIFY_ARE_EQUAL(Alias::CompiledTarget::AllArguments, compiled.segments[1].argument);
+        VERIFY_ARE_EQUAL(9u, compiled.segments[2].literalLength);
+        VERIFY_ARE_EQUAL(0u, compiled.segments[2].argument);
+    }
+
     TEST_METHOD(TrimTrailing)
     {
         BEGIN_TEST_METHOD_PROPERTIES()
@@ -383,42 +444,39 @@ class AliasTests
         _ReplacePercentWithCRLF(target);
         _ReplacePercentWithCRLF(expected);
 
-        Alias::s_TrimTrailingCrLf(target);
+        // The trailing \r\n of the command line must not end up in the arguments.
+        const auto actual = _ExpandCompiled(L"$*", L"alias " + target);
 
-        VERIFY_ARE_EQUAL(String(expected.data()), String(target.data()));
+        VERIFY_ARE_EQUAL(String((expected + L"\r\n").data()), String(actual.data()));
     }
 
     TEST_METHOD(Tokenize)
     {
-        std::wstring tokenStr(L"one two three");
-        std::deque<std::wstring> tokensExpected;
-        tokensExpected.emplace_back(L"one");
-        tokensExpected.emplace_back(L"two");
-        tokensExpected.emplace_back(L"three");
+        _AddAlias(L"$*");
 
-        auto tokensActual = Alias::s_Tokenize(tokenStr);
+        Alias::Arguments arguments;
+        VERIFY_IS_NOT_NULL(Alias::s_FindCompiledTarget(L"alias one two three", L"test.exe", arguments));
 
-        VERIFY_ARE_EQUAL(tokensExpected.size(), tokensActual.size());
+        VERIFY_ARE_EQUAL(String(L"one"), String(std::wstring(arguments[1]).data()));
+        VERIFY_ARE_EQUAL(String(L"two"), String(std::wstring(arguments[2]).data()));
+        VERIFY_ARE_EQUAL(String(L"three"), String(std::wstring(arguments[3]).data()));
 
-        for (size_t i = 0; i < tokensExpected.size(); i++)
+        for (size_t i = 4; i < Alias::CompiledTarget::AllArguments; i++)
         {
-            VERIFY_ARE_EQUAL(String(tokensExpected[i].data()), String(tokensActual[i].data()));
+            VERIFY_IS_TRUE(arguments[i].empty());
         }
     }
 
     TEST_METHOD(TokenizeNothing)
     {
-        std::wstring tokenStr(L"alias");
-        std::deque<std::wstring> tokensExpected;
-        tokensExpected.emplace_back(tokenStr);
+        _AddAlias(L"$*");
 
-        auto tokensActual = Alias::s_Tokenize(tokenStr);
+        Alias::Arguments arguments;
+        VERIFY_IS_NOT_NULL(Alias::s_FindCompiledTarget(L"alias", L"test.exe", arguments));
 
-        VERIFY_ARE_EQUAL(tokensExpected.size(), tokensActual.size());
-
-        for (size_t i = 0; i < tokensExpected.size(); i++)
+        for (const auto& argument : arguments)
         {
-            VERIFY_ARE_EQUAL(String(tokensExpected[i].data()), String(tokensActual[i].data()));
+            VERIFY_IS_TRUE(argument.empty());
         }
     }
 
@@ -428,7 +486,7 @@ class AliasTests
             TEST_METHOD_PROPERTY(L"Data:targetExpectedPair",
                                  L"{"
                                  L"alias arg1 arg2 arg3=arg1 arg2 arg3,"
-                                 L"aliasOnly="
+                                 L"alias="
                                  L"}")
         END_TEST_METHOD_PROPERTIES()
 
@@ -436,8 +494,12 @@ class AliasTests
         std::wstring expected;
         _RetrieveTargetExpectedPair(target, expected);
 
-        auto actual = Alias::s_GetArgString(target);
+        _AddAlias(L"$*");
+
+        Alias::Arguments arguments;
+        VERIFY_IS_NOT_NULL(Alias::s_FindCompiledTarget(target, L"test.exe", arguments));
 
+        const std::wstring actual(arguments[Alias::CompiledTarget::AllArguments]);
         VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
     }
 
@@ -455,8 +517,8 @@ class AliasTests
                                  L"7=seven,"
                                  L"8=eight,"
                                  L"9=nine,"
-                                 L"A=,"
-                                 L"0=,"
+                                 L"A=$A," // Anything else isn't a macro and is copied through.
+                                 L"0=$0,"
                                  L"}")
         END_TEST_METHOD_PROPERTIES()
 
@@ -464,27 +526,16 @@ class AliasTests
         std::wstring expected;
         _RetrieveTargetExpectedPair(target, expected);
 
-        std::deque<std::wstring> tokens;
-        tokens.emplace_back(L"alias");
-        tokens.emplace_back(L"one");
-        tokens.emplace_back(L"two");
-        tokens.emplace_back(L"three");
-        tokens.emplace_back(L"four");
-        tokens.emplace_back(L"five");
-        tokens.emplace_back(L"six");
-        tokens.emplace_back(L"seven");
-        tokens.emplace_back(L"eight");
-        tokens.emplace_back(L"nine");
-        tokens.emplace_back(L"ten");
+        const auto actual = _ExpandCompiled(L"$" + target, L"alias one two three four five six seven eight nine ten");
 
-        // if we expect non-empty results, then we should get a bool back saying it was processed
-        const auto returnExpected = !expected.empty();
+        VERIFY_ARE_EQUAL(String((expected + L"\r\n").data()), String(actual.data()));
+    }
 
-        std::wstring actual;
-        const auto returnActual = Alias::s_TryReplaceNumberedArgMacro(target[0], actual, tokens);
+    TEST_METHOD(NumberedArgMacroWithoutArgument)
+    {
+        const auto actual = _ExpandCompiled(L"[$1][$2][$3]", L"alias one");
 
-        VERIFY_ARE_EQUAL(returnExpected, returnActual);
-        VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
+        VERIFY_ARE_EQUAL(String(L"[one][][]\r\n"), String(actual.data()));
     }
 
     TEST_METHOD(WildcardArgMacro)
@@ -493,8 +544,8 @@ class AliasTests
             TEST_METHOD_PROPERTY(L"Data:targetExpectedPair",
                                  L"{"
                                  L"*=one two three,"
-                                 L"A=,"
-                                 L"0=,"
+                                 L"A=$A,"
+                                 L"0=$0,"
                                  L"}")
         END_TEST_METHOD_PROPERTIES()
 
@@ -502,16 +553,9 @@ class AliasTests
         std::wstring expected;
         _RetrieveTargetExpectedPair(target, expected);
 
-        std::wstring fullArgString(L"one two three");
-
-        // if we expect non-empty results, then we should get a bool back saying it was processed
-        const auto returnExpected = !expected.empty();
-
-        std::wstring actual;
-        const auto returnActual = Alias::s_TryReplaceWildcardArgMacro(target[0], actual, fullArgString);
+        const auto actual = _ExpandCompiled(L"$" + target, L"alias one two three");
 
-        VERIFY_ARE_EQUAL(returnExpected, returnActual);
-        VERIFY_ARE_EQUAL(String(expected.data()), String(actual.data()));
+        VERIFY_ARE_EQUAL(String((expected + L"\r\n").data()), String(actual.data()));
     }
 
     TEST_METHOD(InputRedirMacro)
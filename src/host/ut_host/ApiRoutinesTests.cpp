@@ -866,4 +866,80 @@ class ApiRoutinesTests
 
         ValidateComplexScreen(si, background, fill, scrollRect, Viewport::FromInclusive(scroll), destination, clipViewport);
     }
+
+    TEST_METHOD(ApiWriteAndReadConsoleOutputW)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& si = gci.GetActiveOutputBuffer();
+
+        VERIFY_SUCCEEDED(si.GetTextBuffer().ResizeTraditional({ 5, 5 }), L"Make the buffer small so this doesn't take forever.");
+
+        // A 4x2 block of cells with two attribute runs per row,
+        // the first column of which hangs off the left edge of the buffer.
+        std::array<CHAR_INFO, 8> cells{};
+        for (size_t i = 0; i < cells.size(); ++i)
+        {
+            til::at(cells, i).Char.UnicodeChar = gsl::narrow_cast<wchar_t>(L'A' + i);
+            til::at(cells, i).Attributes = gsl::narrow_cast<WORD>(i % 4 < 2 ? FOREGROUND_RED : FOREGROUND_GREEN | BACKGROUND_BLUE);
+        }
+        const auto request = Viewport::FromDimensions({ -1, 1 }, { 4, 2 });
+
+        Viewport written;
+        VERIFY_SUCCEEDED(_pApiRoutines->WriteConsoleOutputWImpl(si, cells, request, written));
+        VERIFY_ARE_EQUAL(0, written.Left());
+        VERIFY_ARE_EQUAL(1, written.Top());
+        VERIFY_ARE_EQUAL(3, written.Width());
+        VERIFY_ARE_EQUAL(2, written.Height());
+
+        CHAR_INFO untouched{};
+        untouched.Char.UnicodeChar = L'?';
+        untouched.Attributes = FOREGROUND_INTENSITY;
+        std::array<CHAR_INFO, 8> read{};
+        read.fill(untouched);
+
+        Viewport readRectangle;
+        VERIFY_SUCCEEDED(_pApiRoutines->ReadConsoleOutputWImpl(si, read, request, readRectangle));
+        VERIFY_ARE_EQUAL(0, readRectangle.Left());
+        VERIFY_ARE_EQUAL(1, readRectangle.Top());
+        VERIFY_ARE_EQUAL(3, readRectangle.Width());
+        VERIFY_ARE_EQUAL(2, readRectangle.Height());
+
+        // The clipped column isn't touched, everything else round trips.
+        for (size_t i = 0; i < read.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(i % 4 == 0 ? untouched : til::at(cells, i), til::at(read, i));
+        }
+    }
+
+    TEST_METHOD(ApiFillConsoleOutputAcrossRows)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& si = gci.GetActiveOutputBuffer();
+        auto& textBuffer = si.GetTextBuffer();
+
+        VERIFY_SUCCEEDED(textBuffer.ResizeTraditional({ 5, 5 }), L"Make the buffer small so this doesn't take forever.");
+        textBuffer.GetRowByOffset(1).SetWrapForced(true);
+
+        // Fill the end of the first row, all of the second and the start of the third.
+        size_t cellsModified = 0;
+        VERIFY_SUCCEEDED(_pApiRoutines->FillConsoleOutputCharacterWImpl(si, L'x', 8, { 3, 0 }, cellsModified));
+        VERIFY_ARE_EQUAL(8u, cellsModified);
+        VERIFY_ARE_EQUAL(L"   xx", textBuffer.GetRowByOffset(0).GetText());
+        VERIFY_ARE_EQUAL(L"xxxxx", textBuffer.GetRowByOffset(1).GetText());
+        VERIFY_ARE_EQUAL(L"x    ", textBuffer.GetRowByOffset(2).GetText());
+        VERIFY_IS_FALSE(textBuffer.GetRowByOffset(1).WasWrapForced(), L"Filling the last column unsets the wrap flag.");
+
+        // A fill that runs past the end of the buffer stops there.
+        const auto& lastRow = textBuffer.GetRowByOffset(4);
+        const auto previousAttribute = lastRow.GetAttrByColumn(0);
+        const auto attribute = gsl::narrow_cast<WORD>(FOREGROUND_RED | BACKGROUND_GREEN);
+        VERIFY_SUCCEEDED(_pApiRoutines->FillConsoleOutputAttributeImpl(si, attribute, 10, { 2, 4 }, cellsModified));
+        VERIFY_ARE_EQUAL(3u, cellsModified);
+
+        for (til::CoordType x = 0; x < 5; ++x)
+        {
+            const auto expected = x < 2 ? previousAttribute : TextAttribute{ attribute };
+            VERIFY_ARE_EQUAL(expected, lastRow.GetAttrByColumn(x));
+        }
+    }
 };
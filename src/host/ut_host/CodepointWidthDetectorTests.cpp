@@ -50,6 +50,60 @@ class CodepointWidthDetectorTests
         }
     }
 
+    TEST_METHOD(CanGetWidthsAtBlockBoundaries)
+    {
+        // The width lookup table is split into blocks of 256 codepoints.
+        // These ranges start or end right at (or close to) such a boundary.
+        static constexpr std::array<std::tuple<char32_t, CodepointWidth>, 8> data{ {
+            { 0x10ff, CodepointWidth::Narrow },
+            { 0x1100, CodepointWidth::Wide }, // U+1100 hangul choseong kiyeok
+            { 0x115f, CodepointWidth::Wide },
+            { 0x1160, CodepointWidth::Narrow },
+            { 0x2fffd, CodepointWidth::Wide },
+            { 0x2fffe, CodepointWidth::Narrow },
+            { 0x30000, CodepointWidth::Wide },
+            { 0x10ffff, CodepointWidth::Narrow },
+        } };
+
+        CodepointWidthDetector widthDetector;
+        for (const auto& [codepoint, expected] : data)
+        {
+            std::wstring glyph;
+            if (codepoint < 0x10000)
+            {
+                glyph.push_back(gsl::narrow_cast<wchar_t>(codepoint));
+            }
+            else
+            {
+                const auto offset = codepoint - 0x10000;
+                glyph.push_back(gsl::narrow_cast<wchar_t>(0xD800 | (offset >> 10)));
+                glyph.push_back(gsl::narrow_cast<wchar_t>(0xDC00 | (offset & 0x3FF)));
+            }
+
+            const auto result = widthDetector.GetWidth(glyph);
+            VERIFY_ARE_EQUAL(expected, result, NoThrowString().Format(L"U+%X", codepoint));
+        }
+    }
+
+    TEST_METHOD(CanDetectNarrowRuns)
+    {
+        VERIFY_IS_TRUE(CodepointWidthDetector::IsNarrowRun(L""));
+        VERIFY_IS_TRUE(CodepointWidthDetector::IsNarrowRun(L"short"));
+        VERIFY_IS_TRUE(CodepointWidthDetector::IsNarrowRun(L"a line of ASCII text longer than a vector register\r\n"));
+
+        // Wide and ambiguous characters must be found no matter where they are,
+        // in the vectorized part as well as in the remainder at the end.
+        for (const auto ch : { L'\x72D7', L'\x414', L'\xA1', emoji[0] })
+        {
+            for (size_t i = 0; i < 19; ++i)
+            {
+                std::wstring text(19, L'x');
+                text[i] = ch;
+                VERIFY_IS_FALSE(CodepointWidthDetector::IsNarrowRun(text));
+            }
+        }
+    }
+
     static bool FallbackMethod(const std::wstring_view glyph)
     {
         if (glyph.size() < 1)
@@ -536,4 +536,98 @@ class CommandLineTests
             }
         }
     }
+
+    std::wstring ReadScreen(const SCREEN_INFORMATION& screenInfo, const til::point position, const size_t cells)
+    {
+        std::wstring text;
+        auto cellIterator = screenInfo.GetCellDataAt(position);
+        for (size_t i = 0; i < cells; i++, cellIterator++)
+        {
+            text.append(cellIterator->Chars());
+        }
+        return text;
+    }
+
+    TEST_METHOD(EditingInTheMiddleRedrawsTheRestOfTheLine)
+    {
+        auto buffer = std::make_unique<wchar_t[]>(PROMPT_SIZE);
+        VERIFY_IS_NOT_NULL(buffer.get());
+        auto& consoleInfo = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& screenInfo = consoleInfo.GetActiveOutputBuffer();
+        auto& cookedReadData = consoleInfo.CookedReadData();
+        InitCookedReadData(cookedReadData, m_pHistory, buffer.get(), PROMPT_SIZE);
+        cookedReadData.SetInsertMode(true);
+
+        const til::point origin;
+        auto& commandLine = CommandLine::Instance();
+        NTSTATUS status;
+
+        cookedReadData.Write(L"hello world");
+        for (auto i = 0; i < 5; i++)
+        {
+            VERIFY_NT_SUCCESS(commandLine.ProcessCommandLine(cookedReadData, VK_LEFT, 0));
+        }
+
+        Log::Comment(L"Inserting a character shifts the rest of the line to the right.");
+        VERIFY_IS_FALSE(cookedReadData.ProcessInput(L'X', 0, status));
+        VerifyPromptText(cookedReadData, L"hello Xworld");
+        VERIFY_ARE_EQUAL(std::wstring{ L"hello Xworld " }, ReadScreen(screenInfo, origin, 13));
+        VERIFY_ARE_EQUAL(til::point(7, 0), screenInfo.GetTextBuffer().GetCursor().GetPosition());
+        VERIFY_ARE_EQUAL(12u, cookedReadData.VisibleCharCount());
+
+        Log::Comment(L"Backspace shifts it back and blanks the cell the line no longer occupies.");
+        VERIFY_IS_FALSE(cookedReadData.ProcessInput(UNICODE_BACKSPACE, 0, status));
+        VerifyPromptText(cookedReadData, L"hello world");
+        VERIFY_ARE_EQUAL(std::wstring{ L"hello world  " }, ReadScreen(screenInfo, origin, 13));
+        VERIFY_ARE_EQUAL(til::point(6, 0), screenInfo.GetTextBuffer().GetCursor().GetPosition());
+        VERIFY_ARE_EQUAL(11u, cookedReadData.VisibleCharCount());
+
+        Log::Comment(L"So does deleting the character under the cursor.");
+        VERIFY_NT_SUCCESS(commandLine.ProcessCommandLine(cookedReadData, VK_DELETE, 0));
+        VerifyPromptText(cookedReadData, L"hello orld");
+        VERIFY_ARE_EQUAL(std::wstring{ L"hello orld  " }, ReadScreen(screenInfo, origin, 12));
+        VERIFY_ARE_EQUAL(til::point(6, 0), screenInfo.GetTextBuffer().GetCursor().GetPosition());
+        VERIFY_ARE_EQUAL(10u, cookedReadData.VisibleCharCount());
+    }
+
+    TEST_METHOD(ShorteningTheLineBlanksTheSameCellsAsDeleteCommandLine)
+    {
+        auto buffer = std::make_unique<wchar_t[]>(PROMPT_SIZE);
+        VERIFY_IS_NOT_NULL(buffer.get());
+        auto& consoleInfo = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& screenInfo = consoleInfo.GetActiveOutputBuffer();
+        auto& cookedReadData = consoleInfo.CookedReadData();
+        InitCookedReadData(cookedReadData, m_pHistory, buffer.get(), PROMPT_SIZE);
+        cookedReadData.SetInsertMode(true);
+
+        const til::point origin;
+        auto& commandLine = CommandLine::Instance();
+        NTSTATUS status;
+
+        cookedReadData.Write(L"hello world");
+        VERIFY_ARE_EQUAL(11u, cookedReadData.VisibleCharCount());
+        for (auto i = 0; i < 5; i++)
+        {
+            VERIFY_NT_SUCCESS(commandLine.ProcessCommandLine(cookedReadData, VK_LEFT, 0));
+        }
+
+        // Fill the cells behind the line with something that isn't whitespace,
+        // so that we can tell which of them get blanked.
+        screenInfo.Write(OutputCellIterator(L'Z', 5), til::point{ 11, 0 });
+
+        Log::Comment(L"Erasing the line blanks one cell past its end. Backspacing in the middle has to blank exactly the same cells.");
+        VERIFY_ARE_EQUAL(12u, GetCommandLineDeleteLength(cookedReadData, 11));
+        VERIFY_IS_FALSE(cookedReadData.ProcessInput(UNICODE_BACKSPACE, 0, status));
+        VerifyPromptText(cookedReadData, L"helloworld");
+        VERIFY_ARE_EQUAL(10u, cookedReadData.VisibleCharCount());
+        VERIFY_ARE_EQUAL(std::wstring{ L"helloworld  ZZZZ" }, ReadScreen(screenInfo, origin, 16));
+        VERIFY_ARE_EQUAL(til::point(5, 0), screenInfo.GetTextBuffer().GetCursor().GetPosition());
+
+        Log::Comment(L"The same is true for deleting the character under the cursor.");
+        VERIFY_NT_SUCCESS(commandLine.ProcessCommandLine(cookedReadData, VK_DELETE, 0));
+        VerifyPromptText(cookedReadData, L"helloorld");
+        VERIFY_ARE_EQUAL(9u, cookedReadData.VisibleCharCount());
+        VERIFY_ARE_EQUAL(std::wstring{ L"helloorld   ZZZZ" }, ReadScreen(screenInfo, origin, 16));
+        VERIFY_ARE_EQUAL(til::point(5, 0), screenInfo.GetTextBuffer().GetCursor().GetPosition());
+    }
 };
@@ -242,6 +242,69 @@ class HistoryTests
         VERIFY_ARE_EQUAL(2ul, history->GetNumberOfCommands());
     }
 
+    TEST_METHOD(AddDuplicateWhenFull)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+        for (size_t i = 0; i < s_BufferSize; i++)
+        {
+            VERIFY_SUCCEEDED(history->Add(_manyHistoryItems[i], true));
+        }
+
+        // The duplicate moves to the end instead of pushing out the oldest command.
+        VERIFY_SUCCEEDED(history->Add(_manyHistoryItems[3], true));
+        VERIFY_ARE_EQUAL(s_BufferSize, history->GetNumberOfCommands());
+        VERIFY_ARE_EQUAL(_manyHistoryItems[0], history->GetNth(0));
+        VERIFY_ARE_EQUAL(_manyHistoryItems[2], history->GetNth(2));
+        VERIFY_ARE_EQUAL(_manyHistoryItems[4], history->GetNth(3));
+        VERIFY_ARE_EQUAL(_manyHistoryItems[3], history->GetNth(s_BufferSize - 1));
+
+        // A new command pushes out the oldest one.
+        VERIFY_SUCCEEDED(history->Add(_manyHistoryItems[11], true));
+        VERIFY_ARE_EQUAL(s_BufferSize, history->GetNumberOfCommands());
+        VERIFY_ARE_EQUAL(_manyHistoryItems[1], history->GetNth(0));
+        VERIFY_ARE_EQUAL(_manyHistoryItems[11], history->GetNth(s_BufferSize - 1));
+    }
+
+    TEST_METHOD(FindMatchingCommandByPrefix)
+    {
+        auto history = CommandHistory::s_Allocate(_manyApps[0], _MakeHandle(0));
+        VERIFY_IS_NOT_NULL(history);
+        VERIFY_SUCCEEDED(history->Add(L"dir", false));
+        VERIFY_SUCCEEDED(history->Add(L"cd ..", false));
+        VERIFY_SUCCEEDED(history->Add(L"dir /w", false));
+        VERIFY_SUCCEEDED(history->Add(L"git push", false));
+        VERIFY_SUCCEEDED(history->Add(L"dir /p", false));
+
+        // Like F8 we cycle backwards through all commands starting with "dir", beginning with the most recent one.
+        SHORT index = 0;
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"dir", history->LastDisplayed, index, CommandHistory::MatchOptions::None));
+        VERIFY_ARE_EQUAL(4, index);
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"dir", index, index, CommandHistory::MatchOptions::None));
+        VERIFY_ARE_EQUAL(2, index);
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"dir", index, index, CommandHistory::MatchOptions::None));
+        VERIFY_ARE_EQUAL(0, index);
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"dir", index, index, CommandHistory::MatchOptions::None));
+        VERIFY_ARE_EQUAL(4, index, L"The search wraps around.");
+
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"dir", 4, index, CommandHistory::MatchOptions::ExactMatch | CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(0, index);
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"dirt", 4, index, CommandHistory::MatchOptions::JustLooking));
+
+        // Reordering commands keeps the index in sync.
+        history->Swap(0, 3);
+        VERIFY_ARE_EQUAL(L"git push", history->GetNth(0));
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"git", 4, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(0, index);
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"dir", 4, index, CommandHistory::MatchOptions::ExactMatch | CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(3, index);
+
+        history->Remove(3);
+        VERIFY_IS_FALSE(history->FindMatchingCommand(L"dir", 3, index, CommandHistory::MatchOptions::ExactMatch | CommandHistory::MatchOptions::JustLooking));
+        VERIFY_IS_TRUE(history->FindMatchingCommand(L"dir /", 3, index, CommandHistory::MatchOptions::JustLooking));
+        VERIFY_ARE_EQUAL(2, index);
+    }
+
 private:
     const std::array<std::wstring, 5> _manyApps = {
         L"foo.exe",
@@ -78,7 +78,7 @@ class InputBufferTests
             INPUT_RECORD record;
             record.EventType = MENU_EVENT;
             VERIFY_IS_GREATER_THAN(inputBuffer.Write(IInputEvent::Create(record)), 0u);
-            VERIFY_ARE_EQUAL(record, inputBuffer._storage.back()->ToInputRecord());
+            VERIFY_ARE_EQUAL(record, inputBuffer._StoredEvents().back());
         }
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
     }
@@ -98,7 +98,7 @@ class InputBufferTests
         // verify that the events are the same in storage
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i]->ToInputRecord(), record);
+            VERIFY_ARE_EQUAL(til::at(inputBuffer._StoredEvents(), i), record);
         }
     }
 
@@ -121,10 +121,9 @@ class InputBufferTests
         // check that they coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 1u);
         // check that the mouse position is being updated correctly
-        const IInputEvent* const pOutEvent = inputBuffer._storage.front().get();
-        const auto pMouseEvent = static_cast<const MouseEvent* const>(pOutEvent);
-        VERIFY_ARE_EQUAL(pMouseEvent->GetPosition().x, static_cast<SHORT>(RECORD_INSERT_COUNT));
-        VERIFY_ARE_EQUAL(pMouseEvent->GetPosition().y, static_cast<SHORT>(RECORD_INSERT_COUNT * 2));
+        const auto& outPosition = inputBuffer._StoredEvents().front().Event.MouseEvent.dwMousePosition;
+        VERIFY_ARE_EQUAL(outPosition.X, static_cast<SHORT>(RECORD_INSERT_COUNT));
+        VERIFY_ARE_EQUAL(outPosition.Y, static_cast<SHORT>(RECORD_INSERT_COUNT * 2));
 
         // add a key event and another mouse event to make sure that
         // an event between two mouse events stopped the coalescing.
@@ -162,10 +161,10 @@ class InputBufferTests
         // no events should have been coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT + 1);
         // check that the events stored match those inserted
-        VERIFY_ARE_EQUAL(inputBuffer._storage.front()->ToInputRecord(), mouseRecords[0]);
+        VERIFY_ARE_EQUAL(inputBuffer._StoredEvents().front(), mouseRecords[0]);
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1]->ToInputRecord(), mouseRecords[i]);
+            VERIFY_ARE_EQUAL(til::at(inputBuffer._StoredEvents(), i + 1), mouseRecords[i]);
         }
     }
 
@@ -221,10 +220,10 @@ class InputBufferTests
         // no events should have been coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT + 1);
         // check that the events stored match those inserted
-        VERIFY_ARE_EQUAL(inputBuffer._storage.front()->ToInputRecord(), keyRecords[0]);
+        VERIFY_ARE_EQUAL(inputBuffer._StoredEvents().front(), keyRecords[0]);
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1]->ToInputRecord(), keyRecords[i]);
+            VERIFY_ARE_EQUAL(til::at(inputBuffer._StoredEvents(), i + 1), keyRecords[i]);
         }
     }
 
@@ -239,7 +238,7 @@ class InputBufferTests
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
             VERIFY_IS_GREATER_THAN(inputBuffer.Write(IInputEvent::Create(record)), 0u);
-            VERIFY_ARE_EQUAL(inputBuffer._storage.back()->ToInputRecord(), record);
+            VERIFY_ARE_EQUAL(inputBuffer._StoredEvents().back(), record);
         }
 
         // The events shouldn't be coalesced
@@ -286,19 +285,19 @@ class InputBufferTests
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT / 2);
 
         // make sure that the non key events were the ones removed
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
-        auto amountToRead = RECORD_INSERT_COUNT / 2;
-        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents,
-                                                 amountToRead,
+        INPUT_RECORD outRecords[RECORD_INSERT_COUNT / 2];
+        size_t eventsRead;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords,
+                                                 eventsRead,
                                                  false,
                                                  false,
                                                  false,
                                                  false));
-        VERIFY_ARE_EQUAL(amountToRead, outEvents.size());
+        VERIFY_ARE_EQUAL(RECORD_INSERT_COUNT / 2, eventsRead);
 
-        for (size_t i = 0; i < outEvents.size(); ++i)
+        for (size_t i = 0; i < eventsRead; ++i)
         {
-            VERIFY_ARE_EQUAL(outEvents[i]->EventType(), InputEventType::KeyEvent);
+            VERIFY_ARE_EQUAL(outRecords[i].EventType, KEY_EVENT);
         }
     }
 
@@ -317,19 +316,19 @@ class InputBufferTests
         VERIFY_IS_GREATER_THAN(inputBuffer.Write(inEvents), 0u);
 
         // read them back out
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
-        auto amountToRead = RECORD_INSERT_COUNT;
-        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents,
-                                                 amountToRead,
+        INPUT_RECORD outRecords[RECORD_INSERT_COUNT];
+        size_t eventsRead;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords,
+                                                 eventsRead,
                                                  false,
                                                  false,
                                                  false,
                                                  false));
-        VERIFY_ARE_EQUAL(amountToRead, outEvents.size());
+        VERIFY_ARE_EQUAL(RECORD_INSERT_COUNT, eventsRead);
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(records[i], outEvents[i]->ToInputRecord());
+            VERIFY_ARE_EQUAL(records[i], outRecords[i]);
         }
     }
 
@@ -348,20 +347,20 @@ class InputBufferTests
         VERIFY_IS_GREATER_THAN(inputBuffer.Write(inEvents), 0u);
 
         // peek at events
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
-        auto amountToRead = RECORD_INSERT_COUNT;
-        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents,
-                                                 amountToRead,
+        INPUT_RECORD outRecords[RECORD_INSERT_COUNT];
+        size_t eventsRead;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords,
+                                                 eventsRead,
                                                  true,
                                                  false,
                                                  false,
                                                  false));
 
-        VERIFY_ARE_EQUAL(amountToRead, outEvents.size());
+        VERIFY_ARE_EQUAL(RECORD_INSERT_COUNT, eventsRead);
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
         for (unsigned int i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(records[i], outEvents[i]->ToInputRecord());
+            VERIFY_ARE_EQUAL(records[i], outRecords[i]);
         }
     }
 
@@ -382,10 +381,10 @@ class InputBufferTests
         VERIFY_IS_GREATER_THAN(inputBuffer.Write(inEvents), 0u);
 
         // read one record, make sure ResetWaitEvent isn't set
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        INPUT_RECORD outRecords[RECORD_INSERT_COUNT];
         size_t eventsRead = 0;
         auto resetWaitEvent = false;
-        inputBuffer._ReadBuffer(outEvents,
+        inputBuffer._ReadBuffer(outRecords,
                                 1,
                                 eventsRead,
                                 false,
@@ -396,8 +395,7 @@ class InputBufferTests
         VERIFY_IS_FALSE(!!resetWaitEvent);
 
         // read the rest, resetWaitEvent should be set to true
-        outEvents.clear();
-        inputBuffer._ReadBuffer(outEvents,
+        inputBuffer._ReadBuffer(outRecords,
                                 RECORD_INSERT_COUNT - 1,
                                 eventsRead,
                                 false,
@@ -431,10 +429,10 @@ class InputBufferTests
         VERIFY_IS_GREATER_THAN(inputBuffer.Write(inEvents), 0u);
 
         // read them out non-unicode style and compare
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        INPUT_RECORD outRecords[recordInsertCount];
         size_t eventsRead = 0;
         auto resetWaitEvent = false;
-        inputBuffer._ReadBuffer(outEvents,
+        inputBuffer._ReadBuffer(outRecords,
                                 recordInsertCount,
                                 eventsRead,
                                 false,
@@ -444,10 +442,9 @@ class InputBufferTests
         // the dbcs record should have counted for two elements in
         // the array, making it so that we get less events read
         VERIFY_ARE_EQUAL(eventsRead, recordInsertCount - 1);
-        VERIFY_ARE_EQUAL(eventsRead, outEvents.size());
         for (size_t i = 0; i < eventsRead; ++i)
         {
-            VERIFY_ARE_EQUAL(outEvents[i]->ToInputRecord(), inRecords[i]);
+            VERIFY_ARE_EQUAL(outRecords[i], inRecords[i]);
         }
     }
 
@@ -477,34 +474,33 @@ class InputBufferTests
         VERIFY_ARE_EQUAL(eventsWritten, RECORD_INSERT_COUNT);
 
         // grab the first set of events and ensure they match prependRecords
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
-        auto amountToRead = RECORD_INSERT_COUNT;
-        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents,
-                                                 amountToRead,
+        INPUT_RECORD outRecords[RECORD_INSERT_COUNT];
+        size_t eventsRead;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords,
+                                                 eventsRead,
                                                  false,
                                                  false,
                                                  false,
                                                  false));
-        VERIFY_ARE_EQUAL(amountToRead, outEvents.size());
+        VERIFY_ARE_EQUAL(RECORD_INSERT_COUNT, eventsRead);
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
         for (unsigned int i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(prependRecords[i], outEvents[i]->ToInputRecord());
+            VERIFY_ARE_EQUAL(prependRecords[i], outRecords[i]);
         }
 
-        outEvents.clear();
         // verify the rest of the records
-        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents,
-                                                 amountToRead,
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords,
+                                                 eventsRead,
                                                  false,
                                                  false,
                                                  false,
                                                  false));
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
-        VERIFY_ARE_EQUAL(amountToRead, outEvents.size());
+        VERIFY_ARE_EQUAL(RECORD_INSERT_COUNT, eventsRead);
         for (unsigned int i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(records[i], outEvents[i]->ToInputRecord());
+            VERIFY_ARE_EQUAL(records[i], outRecords[i]);
         }
     }
 
@@ -575,10 +571,10 @@ class InputBufferTests
         VERIFY_IS_TRUE(WI_IsFlagSet(gci.Flags, CONSOLE_OUTPUT_SUSPENDED));
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 1u);
 
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
-        size_t amountToRead = 2;
-        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents,
-                                                 amountToRead,
+        INPUT_RECORD outRecords[2];
+        size_t eventsRead;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords,
+                                                 eventsRead,
                                                  true,
                                                  false,
                                                  false,
@@ -588,23 +584,18 @@ class InputBufferTests
     TEST_METHOD(WritingToEmptyBufferSignalsWaitEvent)
     {
         InputBuffer inputBuffer;
-        auto record = MakeKeyEvent(true, 1, L'a', 0, L'a', 0);
-        auto inputEvent = IInputEvent::Create(record);
+        const auto record = MakeKeyEvent(true, 1, L'a', 0, L'a', 0);
         size_t eventsWritten;
         auto waitEvent = false;
         inputBuffer.Flush();
         // write one event to an empty buffer
-        std::deque<std::unique_ptr<IInputEvent>> storage;
-        storage.push_back(std::move(inputEvent));
-        inputBuffer._WriteBuffer(storage, eventsWritten, waitEvent);
+        inputBuffer._WriteBuffer({ &record, 1 }, eventsWritten, waitEvent);
         VERIFY_IS_TRUE(waitEvent);
         // write another, it shouldn't signal this time
-        auto record2 = MakeKeyEvent(true, 1, L'b', 0, L'b', 0);
-        auto inputEvent2 = IInputEvent::Create(record2);
+        const auto record2 = MakeKeyEvent(true, 1, L'b', 0, L'b', 0);
         // write another event to a non-empty buffer
         waitEvent = false;
-        storage.push_back(std::move(inputEvent2));
-        inputBuffer._WriteBuffer(storage, eventsWritten, waitEvent);
+        inputBuffer._WriteBuffer({ &record2, 1 }, eventsWritten, waitEvent);
 
         VERIFY_IS_FALSE(waitEvent);
     }
@@ -614,19 +605,20 @@ class InputBufferTests
         InputBuffer inputBuffer;
         const WORD repeatCount = 5;
         auto record = MakeKeyEvent(true, repeatCount, L'a', 0, L'a', 0);
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        INPUT_RECORD outRecord;
+        size_t eventsRead;
 
         VERIFY_ARE_EQUAL(inputBuffer.Write(IInputEvent::Create(record)), 1u);
-        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents,
-                                                 1,
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read({ &outRecord, 1 },
+                                                 eventsRead,
                                                  false,
                                                  false,
                                                  true,
                                                  true));
-        VERIFY_ARE_EQUAL(outEvents.size(), 1u);
-        VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
-        VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*inputBuffer._storage.front()).GetRepeatCount(), repeatCount - 1);
-        VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*outEvents.front()).GetRepeatCount(), 1u);
+        VERIFY_ARE_EQUAL(eventsRead, 1u);
+        VERIFY_ARE_EQUAL(inputBuffer._StoredEvents().size(), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer._StoredEvents().front().Event.KeyEvent.wRepeatCount, repeatCount - 1);
+        VERIFY_ARE_EQUAL(outRecord.Event.KeyEvent.wRepeatCount, 1u);
     }
 
     TEST_METHOD(StreamPeekingDeCoalesces)
@@ -634,18 +626,67 @@ class InputBufferTests
         InputBuffer inputBuffer;
         const WORD repeatCount = 5;
         auto record = MakeKeyEvent(true, repeatCount, L'a', 0, L'a', 0);
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        INPUT_RECORD outRecord;
+        size_t eventsRead;
 
         VERIFY_ARE_EQUAL(inputBuffer.Write(IInputEvent::Create(record)), 1u);
-        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents,
-                                                 1,
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read({ &outRecord, 1 },
+                                                 eventsRead,
                                                  true,
                                                  false,
                                                  true,
                                                  true));
-        VERIFY_ARE_EQUAL(outEvents.size(), 1u);
-        VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
-        VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*inputBuffer._storage.front()).GetRepeatCount(), repeatCount);
-        VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*outEvents.front()).GetRepeatCount(), 1u);
+        VERIFY_ARE_EQUAL(eventsRead, 1u);
+        VERIFY_ARE_EQUAL(inputBuffer._StoredEvents().size(), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer._StoredEvents().front().Event.KeyEvent.wRepeatCount, repeatCount);
+        VERIFY_ARE_EQUAL(outRecord.Event.KeyEvent.wRepeatCount, 1u);
+    }
+
+    TEST_METHOD(CanWriteAndReadRecordSpans)
+    {
+        Log::Comment(L"The span overloads should behave like the event based ones, including prepending and compaction");
+
+        InputBuffer inputBuffer;
+
+        INPUT_RECORD records[RECORD_INSERT_COUNT];
+        for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
+        {
+            records[i] = MakeKeyEvent(TRUE, 1, static_cast<WCHAR>(L'A' + i), 0, static_cast<WCHAR>(L'A' + i), 0);
+        }
+
+        const std::span<const INPUT_RECORD> allRecords{ records };
+        const auto half = RECORD_INSERT_COUNT / 2;
+
+        // write the second half, then prepend the first half
+        VERIFY_ARE_EQUAL(inputBuffer.Write(allRecords.subspan(half)), RECORD_INSERT_COUNT - half);
+        VERIFY_ARE_EQUAL(inputBuffer.Prepend(allRecords.first(half)), half);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
+
+        // read them back one at a time, interleaved with writes, so that the
+        // consumed space at the front of the storage has to be reclaimed
+        for (size_t round = 0; round < 4; ++round)
+        {
+            for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
+            {
+                INPUT_RECORD outRecord;
+                size_t eventsRead = 0;
+                VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read({ &outRecord, 1 }, eventsRead, false, false, true, false));
+                VERIFY_ARE_EQUAL(eventsRead, 1u);
+                VERIFY_ARE_EQUAL(outRecord, records[i]);
+                VERIFY_ARE_EQUAL(inputBuffer.Write({ &records[i], 1 }), 1u);
+            }
+            VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
+        }
+
+        // a bulk read returns everything that's left
+        INPUT_RECORD outRecords[RECORD_INSERT_COUNT + 1];
+        size_t eventsRead = 0;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords, eventsRead, false, false, true, false));
+        VERIFY_ARE_EQUAL(eventsRead, RECORD_INSERT_COUNT);
+        for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
+        {
+            VERIFY_ARE_EQUAL(outRecords[i], records[i]);
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
     }
 };
@@ -11,7 +11,6 @@
 
 #include "../interactivity/inc/ServiceLocator.hpp"
 
-#include <deque>
 #include <memory>
 
 using namespace WEX::Logging;
@@ -45,22 +44,23 @@ class InputRecordConversionTests
     {
         Log::Comment(L"nothing should happen to input events that aren't key events");
 
-        std::deque<std::unique_ptr<IInputEvent>> inEvents;
         INPUT_RECORD inRecords[INPUT_RECORD_COUNT] = { 0 };
         for (size_t i = 0; i < INPUT_RECORD_COUNT; ++i)
         {
             inRecords[i].EventType = MOUSE_EVENT;
             inRecords[i].Event.MouseEvent.dwMousePosition.X = static_cast<SHORT>(i);
             inRecords[i].Event.MouseEvent.dwMousePosition.Y = static_cast<SHORT>(i * 2);
-            inEvents.push_back(IInputEvent::Create(inRecords[i]));
         }
 
-        SplitToOem(inEvents);
-        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT, inEvents.size());
+        INPUT_RECORD outRecords[INPUT_RECORD_COUNT];
+        std::copy_n(&inRecords[0], INPUT_RECORD_COUNT, &outRecords[0]);
+        std::unique_ptr<IInputEvent> partialEvent;
+        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT, SplitToOem(outRecords, INPUT_RECORD_COUNT, partialEvent));
+        VERIFY_IS_NULL(partialEvent.get());
 
         for (size_t i = 0; i < INPUT_RECORD_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inRecords[i], inEvents[i]->ToInputRecord());
+            VERIFY_ARE_EQUAL(inRecords[i], outRecords[i]);
         }
     }
 
@@ -68,21 +68,22 @@ class InputRecordConversionTests
     {
         Log::Comment(L"non-dbcs chars shouldn't be split");
 
-        std::deque<std::unique_ptr<IInputEvent>> inEvents;
         INPUT_RECORD inRecords[INPUT_RECORD_COUNT] = { 0 };
         for (size_t i = 0; i < INPUT_RECORD_COUNT; ++i)
         {
             inRecords[i].EventType = KEY_EVENT;
             inRecords[i].Event.KeyEvent.uChar.UnicodeChar = static_cast<wchar_t>(L'a' + i);
-            inEvents.push_back(IInputEvent::Create(inRecords[i]));
         }
 
-        SplitToOem(inEvents);
-        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT, inEvents.size());
+        INPUT_RECORD outRecords[INPUT_RECORD_COUNT];
+        std::copy_n(&inRecords[0], INPUT_RECORD_COUNT, &outRecords[0]);
+        std::unique_ptr<IInputEvent> partialEvent;
+        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT, SplitToOem(outRecords, INPUT_RECORD_COUNT, partialEvent));
+        VERIFY_IS_NULL(partialEvent.get());
 
         for (size_t i = 0; i < INPUT_RECORD_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inRecords[i], inEvents[i]->ToInputRecord());
+            VERIFY_ARE_EQUAL(inRecords[i], outRecords[i]);
         }
     }
 
@@ -93,7 +94,6 @@ class InputRecordConversionTests
         const auto codepage = ServiceLocator::LocateGlobals().getConsoleInformation().CP;
 
         INPUT_RECORD inRecords[INPUT_RECORD_COUNT * 2] = { 0 };
-        std::deque<std::unique_ptr<IInputEvent>> inEvents;
         // U+3042 hiragana letter A
         wchar_t hiraganaA = 0x3042;
         wchar_t inChars[INPUT_RECORD_COUNT];
@@ -103,11 +103,11 @@ class InputRecordConversionTests
             inRecords[i].EventType = KEY_EVENT;
             inRecords[i].Event.KeyEvent.uChar.UnicodeChar = currentChar;
             inChars[i] = currentChar;
-            inEvents.push_back(IInputEvent::Create(inRecords[i]));
         }
 
-        SplitToOem(inEvents);
-        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT * 2, inEvents.size());
+        std::unique_ptr<IInputEvent> partialEvent;
+        VERIFY_ARE_EQUAL(INPUT_RECORD_COUNT * 2, SplitToOem(inRecords, INPUT_RECORD_COUNT, partialEvent));
+        VERIFY_IS_NULL(partialEvent.get());
 
         // create the data to compare the output to
         char dbcsChars[INPUT_RECORD_COUNT * 2] = { 0 };
@@ -122,8 +122,31 @@ class InputRecordConversionTests
         VERIFY_ARE_EQUAL(writtenBytes, static_cast<int>(INPUT_RECORD_COUNT * 2));
         for (size_t i = 0; i < INPUT_RECORD_COUNT * 2; ++i)
         {
-            const auto pKeyEvent = static_cast<const KeyEvent* const>(inEvents[i].get());
-            VERIFY_ARE_EQUAL(static_cast<char>(pKeyEvent->GetCharData()), dbcsChars[i]);
+            VERIFY_ARE_EQUAL(static_cast<char>(inRecords[i].Event.KeyEvent.uChar.UnicodeChar), dbcsChars[i]);
         }
     }
+
+    TEST_METHOD(SplitToOemReturnsTrailingByteAsPartialEvent)
+    {
+        Log::Comment(L"the byte of a dbcs char that doesn't fit anymore should be returned as a partial event");
+
+        const auto codepage = ServiceLocator::LocateGlobals().getConsoleInformation().CP;
+
+        INPUT_RECORD record = { 0 };
+        // U+3042 hiragana letter A
+        const wchar_t hiraganaA = 0x3042;
+        record.EventType = KEY_EVENT;
+        record.Event.KeyEvent.uChar.UnicodeChar = hiraganaA;
+
+        std::unique_ptr<IInputEvent> partialEvent;
+        VERIFY_ARE_EQUAL(1u, SplitToOem({ &record, 1 }, 1, partialEvent));
+        VERIFY_IS_NOT_NULL(partialEvent.get());
+
+        char dbcsChars[2] = { 0 };
+        VERIFY_ARE_EQUAL(2, WideCharToMultiByte(codepage, 0, &hiraganaA, 1, dbcsChars, 2, nullptr, FALSE));
+        VERIFY_ARE_EQUAL(static_cast<char>(record.Event.KeyEvent.uChar.UnicodeChar), dbcsChars[0]);
+
+        const auto pKeyEvent = static_cast<const KeyEvent* const>(partialEvent.get());
+        VERIFY_ARE_EQUAL(static_cast<char>(pKeyEvent->GetCharData()), dbcsChars[1]);
+    }
 };
@@ -162,6 +162,7 @@ class ScreenBufferTests
 
     TEST_METHOD(BackspaceDefaultAttrs);
     TEST_METHOD(BackspaceDefaultAttrsWriteCharsLegacy);
+    TEST_METHOD(WriteCharsLegacyMixedPlainAndControlChars);
 
     TEST_METHOD(BackspaceDefaultAttrsInPrompt);
 
@@ -2879,6 +2880,32 @@ void ScreenBufferTests::BackspaceDefaultAttrsWriteCharsLegacy()
     VERIFY_ARE_EQUAL(magenta, renderSettings.GetAttributeColors(attrB).second);
 }
 
+void ScreenBufferTests::WriteCharsLegacyMixedPlainAndControlChars()
+{
+    // WriteCharsLegacy copies runs of printable ASCII in bulk and only looks
+    // at the remaining characters individually. Make sure both interleave properly.
+
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+    const auto& tbi = si.GetTextBuffer();
+    auto& cursor = si.GetTextBuffer().GetCursor();
+
+    WI_ClearFlag(si.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    cursor.SetPosition({ 0, 0 });
+
+    const std::wstring_view str{ L"0123456789abcdef\tZ\u00e9z\r\nsecond line" };
+    auto seqCb = str.size() * sizeof(wchar_t);
+    VERIFY_SUCCESS_NTSTATUS(WriteCharsLegacy(si, str.data(), str.data(), str.data(), &seqCb, nullptr, cursor.GetPosition().x, 0, nullptr));
+    VERIFY_ARE_EQUAL(str.size() * sizeof(wchar_t), seqCb);
+
+    // The tab advances to the next multiple of 8 columns.
+    const std::wstring_view expectedRow0{ L"0123456789abcdef        Z\u00e9z " };
+    const std::wstring_view expectedRow1{ L"second line " };
+    VERIFY_ARE_EQUAL(expectedRow0, tbi.GetRowByOffset(0).GetText().substr(0, expectedRow0.size()));
+    VERIFY_ARE_EQUAL(expectedRow1, tbi.GetRowByOffset(1).GetText().substr(0, expectedRow1.size()));
+    VERIFY_ARE_EQUAL(til::point(11, 1), cursor.GetPosition());
+}
+
 void ScreenBufferTests::BackspaceDefaultAttrsInPrompt()
 {
     // Tests MSFT:19853701 - when you edit the prompt line at a bash prompt,
@@ -141,6 +141,7 @@ class TextBufferTests
 
     TEST_METHOD(ResizeTraditionalRotationPreservesHighUnicode);
     TEST_METHOD(ScrollBufferRotationPreservesHighUnicode);
+    TEST_METHOD(ScrollRowsAcrossCircularBufferWrap);
 
     TEST_METHOD(ResizeTraditionalHighUnicodeRowRemoval);
     TEST_METHOD(ResizeTraditionalHighUnicodeColumnRemoval);
@@ -160,6 +161,11 @@ class TextBufferTests
 
     TEST_METHOD(HyperlinkTrim);
     TEST_METHOD(NoHyperlinkTrim);
+    TEST_METHOD(HyperlinkRefCountsAndIdReuse);
+    TEST_METHOD(AttributeTableSharesAndRecyclesEntries);
+    TEST_METHOD(AttributeTableHoldsMoreThan65535Entries);
+    TEST_METHOD(OverflowCharsAreRecycledByThePool);
+    TEST_METHOD(ResetRowsAreClearedLazily);
 };
 
 void TextBufferTests::TestBufferCreate()
@@ -1909,6 +1915,55 @@ void TextBufferTests::ScrollBufferRotationPreservesHighUnicode()
     VERIFY_ARE_EQUAL(String(fire), String(shouldBeFireText.data(), gsl::narrow<int>(shouldBeFireText.size())));
 }
 
+// This tests that scrolling a region of rows works the same whether or not the
+// region wraps around the end of the circular buffer.
+void TextBufferTests::ScrollRowsAcrossCircularBufferWrap()
+{
+    const til::size bufferSize{ 10, 8 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    // Put the top row near the end of the storage, so that it wraps around after 2 rows.
+    _buffer->_SetFirstRowIndex(6);
+
+    // Mark each row with a letter and keep track of the order we expect them in.
+    std::wstring expected;
+    for (til::CoordType y = 0; y < bufferSize.height; ++y)
+    {
+        const wchar_t ch = L'A' + gsl::narrow_cast<wchar_t>(y);
+        _buffer->GetRowByOffset(y).ReplaceCharacters(0, 1, { &ch, 1 });
+        expected.push_back(ch);
+    }
+
+    const auto verifyRows = [&]() {
+        std::wstring actual;
+        for (til::CoordType y = 0; y < bufferSize.height; ++y)
+        {
+            actual.push_back(_buffer->GetRowByOffset(y).GetText().front());
+        }
+        VERIFY_ARE_EQUAL(String(expected.c_str()), String(actual.c_str()));
+    };
+
+    // Scroll rows 1 to 4 up by one. This region wraps around.
+    _buffer->ScrollRows(1, 4, -1);
+    std::rotate(expected.begin(), expected.begin() + 1, expected.begin() + 5);
+    verifyRows();
+
+    // Scroll rows 0 to 2 down by 3. This region wraps around as well.
+    _buffer->ScrollRows(0, 3, 3);
+    std::rotate(expected.begin(), expected.begin() + 3, expected.begin() + 6);
+    verifyRows();
+
+    // Scroll rows 3 to 6 up by one. This region doesn't wrap.
+    _buffer->ScrollRows(3, 4, -1);
+    std::rotate(expected.begin() + 2, expected.begin() + 3, expected.begin() + 7);
+    verifyRows();
+
+    // Scrolling must not have moved the top row.
+    VERIFY_ARE_EQUAL(6, _buffer->GetFirstRowIndex());
+}
+
 // This tests that rows removed from the buffer while resizing traditionally will also drop the high unicode
 // characters from the Unicode Storage buffer
 void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
@@ -2737,3 +2792,220 @@ void TextBufferTests::NoHyperlinkTrim()
     VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(id), url);
     VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap[finalCustomId], id);
 }
+
+// This tests that the hyperlink reference counts follow the attributes that are written and erased,
+// and that the IDs of obsolete hyperlinks get reused instead of running out of IDs.
+void TextBufferTests::HyperlinkRefCountsAndIdReuse()
+{
+    // Set up a text buffer for us
+    const til::size bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    static constexpr std::wstring_view url{ L"test.url" };
+    static constexpr std::wstring_view otherUrl{ L"other.url" };
+
+    const auto refCount = [&](const uint16_t id) {
+        return _buffer->_attrTable.HyperlinkRefCount(id);
+    };
+
+    const auto id = _buffer->GetHyperlinkId(url, {});
+    _buffer->AddHyperlinkToMap(url, id);
+    TextAttribute linkAttr{ 0x7f };
+    linkAttr.SetHyperlinkId(id);
+
+    // 10 cells at the end of the first row and 4 cells in row 5.
+    _buffer->GetRowByOffset(0).SetAttrToEnd(70, linkAttr);
+    _buffer->GetRowByOffset(5).ReplaceAttributes(0, 4, linkAttr);
+    VERIFY_ARE_EQUAL(14u, refCount(id));
+
+    // Overwriting parts of a hyperlink only removes the overwritten cells.
+    _buffer->GetRowByOffset(0).ReplaceAttributes(70, 75, attr);
+    VERIFY_ARE_EQUAL(9u, refCount(id));
+
+    // Scrolling the first row out of the buffer removes its references, but the hyperlink
+    // is still in use in row 5 (now row 4) and must not be pruned.
+    _buffer->IncrementCircularBuffer();
+    VERIFY_ARE_EQUAL(4u, refCount(id));
+    VERIFY_ARE_EQUAL(url, _buffer->GetHyperlinkUriFromId(id));
+
+    // Scroll the remaining references out of the buffer. The hyperlink gets pruned
+    // and the next hyperlink gets its ID.
+    for (auto i = 0; i < 5; ++i)
+    {
+        _buffer->IncrementCircularBuffer();
+    }
+    VERIFY_ARE_EQUAL(0u, refCount(id));
+    VERIFY_ARE_EQUAL(_buffer->_hyperlinkMap.end(), _buffer->_hyperlinkMap.find(id));
+    VERIFY_ARE_EQUAL(id, _buffer->GetHyperlinkId(otherUrl, {}));
+    _buffer->AddHyperlinkToMap(otherUrl, id);
+
+    // Hyperlinks that are overwritten in place are never pruned while scrolling. Once we
+    // run out of new IDs, they are reclaimed, unless they are in the current attributes.
+    const auto otherId = _buffer->GetHyperlinkId(otherUrl, L"CustomId");
+    _buffer->AddHyperlinkToMap(otherUrl, otherId);
+    linkAttr.SetHyperlinkId(otherId);
+    _buffer->GetRowByOffset(3).SetAttrToEnd(0, linkAttr);
+    _buffer->GetRowByOffset(3).Reset(attr);
+    VERIFY_ARE_EQUAL(0u, refCount(otherId));
+
+    linkAttr.SetHyperlinkId(id);
+    _buffer->SetCurrentAttributes(linkAttr);
+    _buffer->_currentHyperlinkId = 0;
+    VERIFY_ARE_EQUAL(otherId, _buffer->GetHyperlinkId(url, {}));
+    VERIFY_IS_TRUE(_buffer->_hyperlinkCustomIdMap.empty());
+    VERIFY_ARE_EQUAL(otherUrl, _buffer->GetHyperlinkUriFromId(id));
+
+    // With every ID in use, new hyperlinks don't get an ID at all, instead of sharing one.
+    VERIFY_ARE_EQUAL(uint16_t{ 0 }, _buffer->GetHyperlinkId(url, {}));
+}
+
+void TextBufferTests::AttributeTableSharesAndRecyclesEntries()
+{
+    const til::size bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    const auto& table = _buffer->GetAttributeTable();
+
+    // The pinned default attribute and the fill attribute shared by every row.
+    VERIFY_ARE_EQUAL(2u, table.size());
+
+    // Every row uses the same 8 colors, one per cell. The rows share the entries
+    // and the fill attribute is released once no cell uses it anymore.
+    for (til::CoordType y = 0; y < bufferSize.height; ++y)
+    {
+        auto& row = _buffer->GetRowByOffset(y);
+        for (til::CoordType x = 0; x < bufferSize.width; ++x)
+        {
+            row.ReplaceAttributes(x, x + 1, TextAttribute{ gsl::narrow_cast<WORD>(0x10 + x % 8) });
+        }
+    }
+    VERIFY_ARE_EQUAL(9u, table.size());
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x13 }, _buffer->GetRowByOffset(9).GetAttrByColumn(75));
+
+    // Resetting the rows releases the colors again and their entries get reused.
+    for (til::CoordType y = 0; y < bufferSize.height; ++y)
+    {
+        _buffer->GetRowByOffset(y).Reset(attr);
+    }
+    VERIFY_ARE_EQUAL(2u, table.size());
+
+    _buffer->GetRowByOffset(0).ReplaceAttributes(0, 40, TextAttribute{ 0x2e });
+    VERIFY_ARE_EQUAL(3u, table.size());
+    VERIFY_ARE_EQUAL(TextAttribute{ 0x2e }, _buffer->GetRowByOffset(0).GetAttrByColumn(39));
+    VERIFY_ARE_EQUAL(attr, _buffer->GetRowByOffset(0).GetAttrByColumn(40));
+}
+
+void TextBufferTests::AttributeTableHoldsMoreThan65535Entries()
+{
+    const til::size bufferSize{ 400, 200 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    const auto& table = _buffer->GetAttributeTable();
+
+    // Like truecolor image output, every cell gets a color of its own.
+    const auto cellAttr = [&](const til::CoordType x, const til::CoordType y) {
+        TextAttribute cell;
+        cell.SetForeground(RGB(x % 256, y, x / 256));
+        return cell;
+    };
+
+    for (til::CoordType y = 0; y < bufferSize.height; ++y)
+    {
+        auto& row = _buffer->GetRowByOffset(y);
+        for (til::CoordType x = 0; x < bufferSize.width; ++x)
+        {
+            row.ReplaceAttributes(x, x + 1, cellAttr(x, y));
+        }
+    }
+
+    // The pinned default attribute and one entry per cell. The fill attribute got released.
+    VERIFY_ARE_EQUAL(bufferSize.area<size_t>() + 1, table.size());
+
+    for (til::CoordType y = 0; y < bufferSize.height; ++y)
+    {
+        const auto& row = _buffer->GetRowByOffset(y);
+        for (til::CoordType x = 0; x < bufferSize.width; ++x)
+        {
+            if (row.GetAttrByColumn(x) != cellAttr(x, y))
+            {
+                VERIFY_FAIL(NoThrowString().Format(L"wrong attributes at %d,%d", x, y));
+            }
+        }
+    }
+}
+
+void TextBufferTests::OverflowCharsAreRecycledByThePool()
+{
+    const til::size bufferSize{ 80, 10 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    const auto& pool = _buffer->GetCharsPool();
+
+    static constexpr std::wstring_view cluster{ L"a\u0301\u0302\u0303" };
+    const auto fillRow = [&](ROW& row) {
+        for (til::CoordType x = 0; x < bufferSize.width; ++x)
+        {
+            row.ReplaceCharacters(x, 1, cluster);
+        }
+    };
+
+    // Rows that fit into the buffer's chars don't need the pool.
+    VERIFY_ARE_EQUAL(0u, pool.SlabCount());
+
+    // 4 characters per column don't fit anymore.
+    fillRow(_buffer->GetRowByOffset(0));
+    VERIFY_ARE_EQUAL(1u, pool.SlabCount());
+    VERIFY_ARE_EQUAL(cluster, _buffer->GetRowByOffset(0).GlyphAt(79));
+
+    // Rows that scroll out of the buffer return their chars to the pool,
+    // where the next row that needs them picks them up again.
+    for (auto i = 0; i < 100; ++i)
+    {
+        _buffer->IncrementCircularBuffer();
+        fillRow(_buffer->GetRowByOffset(bufferSize.height - 1));
+    }
+    VERIFY_ARE_EQUAL(1u, pool.SlabCount());
+    VERIFY_ARE_EQUAL(cluster, _buffer->GetRowByOffset(bufferSize.height - 1).GlyphAt(0));
+}
+
+void TextBufferTests::ResetRowsAreClearedLazily()
+{
+    const til::size bufferSize{ 20, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    auto& row = _buffer->GetRowByOffset(0);
+
+    // Fill the row, including a wide and a combining glyph, and clear it again.
+    for (til::CoordType x = 0; x < bufferSize.width; ++x)
+    {
+        row.ReplaceCharacters(x, 1, L"x");
+    }
+    row.ReplaceCharacters(4, 2, L"\u3042");
+    row.ReplaceCharacters(10, 1, L"e\u0301");
+    row.Reset(attr);
+
+    VERIFY_IS_FALSE(row.ContainsText());
+    VERIFY_ARE_EQUAL(0, row.MeasureRight());
+    VERIFY_ARE_EQUAL(bufferSize.width, row.MeasureLeft());
+
+    // Partial writes only need the columns up to where they end to be cleared,
+    // but the rest of the row must still read back as whitespace.
+    row.ReplaceCharacters(2, 1, L"a");
+    VERIFY_ARE_EQUAL(3, row.MeasureRight());
+    VERIFY_ARE_EQUAL(2, row.MeasureLeft());
+    VERIFY_ARE_EQUAL(L" ", row.GlyphAt(15));
+    VERIFY_ARE_EQUAL(DbcsAttribute::Single, row.DbcsAttrAt(4));
+
+    row.ReplaceCharacters(6, 2, L"\u3042");
+    row.ReplaceCharacters(8, 1, L"e\u0301");
+    VERIFY_ARE_EQUAL(9, row.MeasureRight());
+    VERIFY_ARE_EQUAL(DbcsAttribute::Trailing, row.DbcsAttrAt(7));
+    VERIFY_ARE_EQUAL(L"e\u0301", row.GlyphAt(8));
+    VERIFY_ARE_EQUAL(L"  a   \u3042e\u0301           ", row.GetText());
+}
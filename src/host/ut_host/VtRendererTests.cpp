@@ -69,6 +69,8 @@ class Microsoft::Console::Render::VtRendererTest
     TEST_METHOD(Xterm256TestCursor);
     TEST_METHOD(Xterm256TestExtendedAttributes);
     TEST_METHOD(Xterm256TestAttributesAcrossReset);
+    TEST_METHOD(Xterm256TestMinimalDiff);
+    TEST_METHOD(Xterm256TestCompactGraphicsRendition);
 
     TEST_METHOD(XtermTestInvalidate);
     TEST_METHOD(XtermTestColors);
@@ -83,6 +85,8 @@ class Microsoft::Console::Render::VtRendererTest
 
     TEST_METHOD(TestCursorVisibility);
 
+    TEST_METHOD(TestAsyncPipeWriter);
+
     void Test16Colors(VtEngine* engine);
 
     std::deque<std::string> qExpectedInput;
@@ -1563,6 +1567,162 @@ void VtRendererTest::TestCursorVisibility()
     VERIFY_IS_FALSE(engine->_needToDisableCursor);
 }
 
+void VtRendererTest::Xterm256TestMinimalDiff()
+{
+    auto hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+    engine->SetMinimalDiffMode(true);
+
+    VerifyFirstPaint(*engine);
+
+    const auto toClusters = [](const std::wstring_view text) {
+        std::vector<Cluster> clusters;
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            clusters.emplace_back(text.substr(i, 1), 1);
+        }
+        return clusters;
+    };
+
+    const auto line = toClusters(L"abcdefghijklmnopqrst");
+    const auto changed = toClusters(L"abcdefghijKlmnopqrst");
+    const auto rule = toClusters(std::wstring(40, L'='));
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"The first time a row is painted, it's printed in full.");
+        qExpectedInput.push_back("\x1b[H");
+        qExpectedInput.push_back("abcdefghijklmnopqrst");
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line.data(), line.size() }, { 0, 0 }, false, false));
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Painting the same row again doesn't print anything.");
+        qExpectedInput.push_back(EMPTY_CALLBACK_SENTINEL);
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ line.data(), line.size() }, { 0, 0 }, false, false));
+        WriteCallback(EMPTY_CALLBACK_SENTINEL, 1);
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Changing a single cell only prints that cell.");
+        qExpectedInput.push_back("\x1b[1;11H");
+        qExpectedInput.push_back("K");
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ changed.data(), changed.size() }, { 0, 0 }, false, false));
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Repeated glyphs are compressed with REP.");
+        qExpectedInput.push_back("\r\n");
+        qExpectedInput.push_back("=");
+        qExpectedInput.push_back("\x1b[39b");
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ rule.data(), rule.size() }, { 0, 1 }, false, false));
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Scrolling moves the shadow copy along with the terminal's contents.");
+        const til::point scrollDelta{ 0, 1 };
+        VERIFY_SUCCEEDED(engine->InvalidateScroll(&scrollDelta));
+        qExpectedInput.push_back("\x1b[H");
+        qExpectedInput.push_back("\x1b[L");
+        VERIFY_SUCCEEDED(engine->ScrollFrame());
+
+        qExpectedInput.push_back(EMPTY_CALLBACK_SENTINEL);
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ changed.data(), changed.size() }, { 0, 1 }, false, false));
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ rule.data(), rule.size() }, { 0, 2 }, false, false));
+        WriteCallback(EMPTY_CALLBACK_SENTINEL, 1);
+    });
+}
+
+void VtRendererTest::Xterm256TestCompactGraphicsRendition()
+{
+    auto hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+    engine->SetMinimalDiffMode(true);
+    RenderSettings renderSettings;
+    RenderData renderData;
+
+    VerifyFirstPaint(*engine);
+
+    TextAttribute attr{};
+    TestPaint(*engine, [&]() {
+        Log::Comment(L"Resetting everything at once is cheaper than resetting each color.");
+        qExpectedInput.push_back("\x1b[m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(attr, renderSettings, &renderData, false, false));
+
+        Log::Comment(L"A single change results in a single parameter.");
+        attr.SetIndexedForeground(TextColor::DARK_YELLOW);
+        qExpectedInput.push_back("\x1b[33m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(attr, renderSettings, &renderData, false, false));
+
+        Log::Comment(L"Multiple changes are combined into a single sequence.");
+        attr.SetIndexedForeground(TextColor::DARK_RED);
+        attr.SetIntense(true);
+        qExpectedInput.push_back("\x1b[31;1m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(attr, renderSettings, &renderData, false, false));
+
+        Log::Comment(L"Unchanged attributes don't emit anything.");
+        qExpectedInput.push_back(EMPTY_CALLBACK_SENTINEL);
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(attr, renderSettings, &renderData, false, false));
+        WriteCallback(EMPTY_CALLBACK_SENTINEL, 1);
+
+        Log::Comment(L"Going back to the defaults uses a reset.");
+        qExpectedInput.push_back("\x1b[m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes({}, renderSettings, &renderData, false, false));
+
+        Log::Comment(L"Turning off one of many attributes doesn't use a reset.");
+        attr = TextAttribute{ 0x00030201, 0x00070605 };
+        attr.SetItalic(true);
+        qExpectedInput.push_back("\x1b[38;2;1;2;3;48;2;5;6;7;3m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(attr, renderSettings, &renderData, false, false));
+        attr.SetItalic(false);
+        qExpectedInput.push_back("\x1b[23m");
+        VERIFY_SUCCEEDED(engine->UpdateDrawingBrushes(attr, renderSettings, &renderData, false, false));
+    });
+
+    Log::Comment(L"Compare the number of bytes written for the attribute changes of `git log --graph --color`.");
+    std::vector<TextAttribute> gitLog;
+    {
+        TextAttribute graph{};
+        graph.SetIndexedForeground(TextColor::DARK_RED);
+        TextAttribute hash{};
+        hash.SetIndexedForeground(TextColor::DARK_YELLOW);
+        TextAttribute head{};
+        head.SetIndexedForeground(TextColor::BRIGHT_CYAN);
+        head.SetIntense(true);
+        TextAttribute branch{};
+        branch.SetIndexedForeground(TextColor::BRIGHT_GREEN);
+        branch.SetIntense(true);
+        for (auto i = 0; i < 1000; ++i)
+        {
+            gitLog.insert(gitLog.end(), { graph, {}, hash, {}, head, hash, branch, hash, {} });
+        }
+    }
+
+    const auto countBytes = [&](const bool compact) {
+        auto hCounterFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+        Xterm256Engine counter{ std::move(hCounterFile), SetUpViewport() };
+        size_t bytes = 0;
+        counter.SetTestCallback([&](const char* const, const size_t cch) {
+            bytes += cch;
+            return true;
+        });
+        counter.SetMinimalDiffMode(compact);
+        for (const auto& next : gitLog)
+        {
+            VERIFY_SUCCEEDED(counter.UpdateDrawingBrushes(next, renderSettings, &renderData, false, false));
+        }
+        return bytes;
+    };
+
+    const auto legacyBytes = countBytes(false);
+    const auto compactBytes = countBytes(true);
+    Log::Comment(NoThrowString().Format(L"Separate sequences: %zu bytes, combined sequences: %zu bytes", legacyBytes, compactBytes));
+    VERIFY_IS_LESS_THAN(compactBytes, legacyBytes);
+}
+
 void VtRendererTest::FormattedString()
 {
     // This test works with a static cache variable that
@@ -1594,3 +1754,45 @@ void VtRendererTest::FormattedString()
     qExpectedInput.push_back("\x1b[28;3;500;500;500m");
     VERIFY_SUCCEEDED(engine->_WriteFormatted(bigFormat, bigValue, bigValue, bigValue));
 }
+
+void VtRendererTest::TestAsyncPipeWriter()
+{
+    Log::Comment(NoThrowString().Format(
+        L"Output is written to the pipe by a separate thread. Make sure it arrives complete and in order."));
+
+    wil::unique_hfile readPipe;
+    wil::unique_hfile writePipe;
+    VERIFY_WIN32_BOOL_SUCCEEDED(CreatePipe(readPipe.addressof(), writePipe.addressof(), nullptr, 0));
+
+    // No test callback this time: the engine writes to the actual pipe.
+    auto engine = std::make_unique<Xterm256Engine>(std::move(writePipe), SetUpViewport());
+
+    std::string expected;
+    for (auto i = 0; i < 100; ++i)
+    {
+        const auto str = fmt::format("frame {}\r\n", i);
+        expected.append(str);
+        VERIFY_SUCCEEDED(engine->WriteTerminalUtf8(str));
+        VERIFY_SUCCEEDED(engine->_Flush());
+    }
+
+    std::string actual(expected.size(), '\0');
+    size_t offset = 0;
+    while (offset < actual.size())
+    {
+        DWORD read = 0;
+        VERIFY_WIN32_BOOL_SUCCEEDED(ReadFile(readPipe.get(), actual.data() + offset, gsl::narrow_cast<DWORD>(actual.size() - offset), &read, nullptr));
+        offset += read;
+    }
+    VERIFY_ARE_EQUAL(expected, actual);
+
+    Log::Comment(NoThrowString().Format(
+        L"During teardown, flushing waits until everything has been written."));
+    auto forcePaint = false;
+    VERIFY_SUCCEEDED(engine->PrepareForTeardown(&forcePaint));
+
+    const auto counters = engine->GetOutputCounters();
+    VERIFY_ARE_EQUAL(gsl::narrow_cast<uint64_t>(expected.size()), counters.bytes);
+    VERIFY_IS_GREATER_THAN_OR_EQUAL(counters.writes, uint64_t{ 1 });
+    VERIFY_ARE_EQUAL(uint64_t{ 100 }, counters.writes + counters.coalesced);
+}
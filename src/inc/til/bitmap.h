@@ -4,6 +4,7 @@
 #pragma once
 
 #include "rect.h"
+#include <bit>
 
 #ifdef UNIT_TESTING
 class BitmapTests;
@@ -13,6 +14,18 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 {
     namespace details
     {
+        // The bitmap stores its bits row by row in words of this many bits.
+        inline constexpr size_t _bitmap_word_bits = CHAR_BIT * sizeof(unsigned long long);
+
+#pragma warning(push)
+        // we can't depend on GSL here, so we use static_cast for explicit narrowing
+#pragma warning(disable : 26472)
+        constexpr size_t _bitmap_index(const ptrdiff_t value) noexcept
+        {
+            return static_cast<size_t>(value);
+        }
+#pragma warning(pop)
+
         template<typename Allocator>
         class _bitmap_const_iterator
         {
@@ -23,11 +36,16 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             using pointer = const til::rect*;
             using reference = const til::rect&;
 
-            _bitmap_const_iterator(const dynamic_bitset<unsigned long long, Allocator>& values, til::rect rc, ptrdiff_t pos) :
+            _bitmap_const_iterator(const std::vector<unsigned long long, Allocator>& values, size_t stride, til::rect rc, ptrdiff_t pos) :
                 _values(values),
+                _stride(stride),
                 _rc(rc),
+                _width(rc.narrow_width<size_t>()),
+                _height(rc.narrow_height<size_t>()),
                 _pos(pos),
-                _end(rc.size().area())
+                _end(rc.size().area()),
+                _row(_width ? _pos / _width : _height),
+                _col(_width ? _pos % _width : 0)
             {
                 _calculateArea();
             }
@@ -48,7 +66,9 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             constexpr bool operator==(const _bitmap_const_iterator& other) const noexcept
             {
-                return _pos == other._pos && _values == other._values;
+                // Iterators into the same bitmap share its storage. Comparing it by address
+                // instead of by value keeps this O(1), as runs() compares against end() after every run.
+                return _pos == other._pos && &_values == &other._values;
             }
 
             constexpr bool operator!=(const _bitmap_const_iterator& other) const noexcept
@@ -77,59 +97,77 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             }
 
         private:
-            const dynamic_bitset<unsigned long long, Allocator>& _values;
+            const std::vector<unsigned long long, Allocator>& _values;
+            const size_t _stride;
             const til::rect _rc;
+            const size_t _width;
+            const size_t _height;
             size_t _pos;
             size_t _nextPos;
             const size_t _end;
+            // The position past which _calculateArea() continues looking for runs.
+            // Tracking it separately from _pos avoids dividing by the width for every run.
+            size_t _row;
+            size_t _col;
             til::rect _run;
 
             // Update _run to contain the next rectangle of consecutively set bits within this bitmap.
             // _calculateArea may be called repeatedly to yield all those rectangles.
-            void _calculateArea()
+            void _calculateArea() noexcept
             {
-                // The following logic first finds the next set bit in this bitmap and the next unset bit past that.
-                // The area in between those positions are thus all set bits and will end up being the next _run.
-
-                // dynamic_bitset allows you to quickly find the next set bit using find_next(prev),
-                // where "prev" is the position _past_ which should be searched (i.e. excluding position "prev").
-                // If _pos is still 0, we thus need to use the counterpart find_first().
-                _nextPos = _pos == 0 ? _values.find_first() : _values.find_next(_pos - 1);
-
-                // If we haven't reached the end yet...
-                if (_nextPos < _end)
+                // A run can be a max of one row tall. Since every row starts on a new word,
+                // we can scan a row 64 cells at a time: first for the next set bit
+                // (which is where the run starts) and then for the next unset one past it.
+                if (!_values.empty())
                 {
-                    // pos is now at the first on bit.
-                    // If no next set bit can be found, npos is returned, which is SIZE_T_MAX.
-                    // saturated_cast can ensure that this will be converted to CoordType's max (which is greater than _end).
-                    const auto runStart = _rc.point_at(base::saturated_cast<CoordType>(_nextPos));
+                    for (; _row < _height; ++_row, _col = 0)
+                    {
+                        const auto row = _values.data() + _row * _stride;
+                        const auto runStart = _col < _width ? _find(row, _col, 0) : _width;
 
-                    // We'll only count up until the end of this row.
-                    // a run can be a max of one row tall.
-                    const size_t rowEndIndex = _rc.index_of<size_t>(til::point(_rc.right - 1, runStart.y)) + 1;
+                        if (runStart < _width)
+                        {
+                            // The row's padding bits are always unset, so this will stop at the end of the row.
+                            const auto runEnd = _find(row, runStart, ~0ull);
+
+                            // Assemble and store that run.
+                            _col = runEnd;
+                            _nextPos = _row * _width + runEnd;
+                            _run = til::rect{
+                                _rc.left + base::saturated_cast<CoordType>(runStart),
+                                _rc.top + base::saturated_cast<CoordType>(_row),
+                                _rc.left + base::saturated_cast<CoordType>(runEnd),
+                                _rc.top + base::saturated_cast<CoordType>(_row + 1),
+                            };
+                            return;
+                        }
+                    }
+                }
 
-                    // Find the length for the rectangle.
-                    size_t runLength = 0;
+                // If we reached the end, mark the end of the iterator by updating the state with _end.
+                _pos = _end;
+                _nextPos = _end;
+                _run = til::rect{};
+            }
 
-                    // We have at least 1 so start with a do/while.
-                    do
-                    {
-                        ++_nextPos;
-                        ++runLength;
-                    } while (_nextPos < rowEndIndex && _values[_nextPos]);
-                    // Keep going until we reach end of row, end of the buffer, or the next bit is off.
+            // Returns the index of the first bit at or past `col` in the given row that is set,
+            // or unset if `invert` is all ones. Returns _width if there's no such bit.
+            size_t _find(const unsigned long long* row, const size_t col, const unsigned long long invert) const noexcept
+            {
+                auto i = col / _bitmap_word_bits;
+                // Mask out the bits before `col` in the first word.
+                auto word = (row[i] ^ invert) & (~0ull << (col % _bitmap_word_bits));
 
-                    // Assemble and store that run.
-                    _run = til::rect{ runStart, til::size{ base::saturated_cast<CoordType>(runLength), 1 } };
-                }
-                else
+                while (word == 0)
                 {
-                    // If we reached the end _nextPos may be >= _end (potentially even PTRDIFF_T_MAX).
-                    // ---> Mark the end of the iterator by updating the state with _end.
-                    _pos = _end;
-                    _nextPos = _end;
-                    _run = til::rect{};
+                    if (++i == _stride)
+                    {
+                        return _width;
+                    }
+                    word = row[i] ^ invert;
                 }
+
+                return std::min(i * _bitmap_word_bits + _bitmap_index(std::countr_zero(word)), _width);
             }
         };
 
@@ -148,6 +186,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _alloc{ allocator },
                 _sz{},
                 _rc{},
+                _stride{},
                 _bits{ _alloc },
                 _runs{ _alloc }
             {
@@ -172,9 +211,14 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _alloc{ allocator },
                 _sz(sz),
                 _rc(sz),
-                _bits(_sz.area(), fill ? std::numeric_limits<unsigned long long>::max() : 0, _alloc),
+                _stride(_strideOf(sz)),
+                _bits(_stride * _sz.narrow_height<size_t>(), 0, _alloc),
                 _runs{ _alloc }
             {
+                if (fill)
+                {
+                    _fillRows(0, _sz.narrow_height<size_t>(), true);
+                }
             }
 
             bitmap(til::size sz, bool fill) :
@@ -186,6 +230,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _alloc{ std::allocator_traits<allocator_type>::select_on_container_copy_construction(other._alloc) },
                 _sz{ other._sz },
                 _rc{ other._rc },
+                _stride{ other._stride },
                 _bits{ other._bits },
                 _runs{ other._runs }
             {
@@ -200,6 +245,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 }
                 _sz = other._sz;
                 _rc = other._rc;
+                _stride = other._stride;
                 _bits = other._bits;
                 _runs = other._runs;
                 return *this;
@@ -209,6 +255,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _alloc{ std::move(other._alloc) },
                 _sz{ std::move(other._sz) },
                 _rc{ std::move(other._rc) },
+                _stride{ other._stride },
                 _bits{ std::move(other._bits) },
                 _runs{ std::move(other._runs) }
             {
@@ -224,6 +271,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 _runs = std::move(other._runs);
                 _sz = std::move(other._sz);
                 _rc = std::move(other._rc);
+                _stride = other._stride;
                 return *this;
             }
 
@@ -239,6 +287,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 std::swap(_runs, other._runs);
                 std::swap(_sz, other._sz);
                 std::swap(_rc, other._rc);
+                std::swap(_stride, other._stride);
             }
 
             constexpr bool operator==(const bitmap& other) const noexcept
@@ -256,12 +305,12 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             const_iterator begin() const
             {
-                return const_iterator(_bits, til::rect{ _sz }, 0);
+                return const_iterator(_bits, _stride, til::rect{ _sz }, 0);
             }
 
             const_iterator end() const
             {
-                return const_iterator(_bits, til::rect{ _sz }, _sz.area());
+                return const_iterator(_bits, _stride, til::rect{ _sz }, _sz.area());
             }
 
             const std::span<const til::rect> runs() const
@@ -279,74 +328,20 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // optional fill the uncovered area with bits.
             void translate(const til::point delta, bool fill = false)
             {
-                if (delta.x == 0)
-                {
-                    // fast path by using bit shifting
-                    translate_y(delta.y, fill);
-                    return;
-                }
-
-                // FUTURE: PERF: GH #4015: This could use in-place walk semantics instead of a temporary.
-                bitmap<allocator_type> other{ _sz, _alloc };
-
-                for (auto run : *this)
-                {
-                    // Offset by the delta
-                    run += delta;
-
-                    // Intersect with the bounds of our bitmap area
-                    // as part of it could have slid out of bounds.
-                    run &= _rc;
-
-                    // Set it into the new bitmap.
-                    other.set(run);
-                }
-
-                // If we were asked to fill... find the uncovered region.
-                if (fill)
-                {
-                    // Original Rect of As.
-                    //
-                    // X <-- origin
-                    // A A A A
-                    // A A A A
-                    // A A A A
-                    // A A A A
-                    const auto originalRect = _rc;
-
-                    // If Delta = (2, 2)
-                    // Translated Rect of Bs.
-                    //
-                    // X <-- origin
-                    //
-                    //
-                    //     B B B B
-                    //     B B B B
-                    //     B B B B
-                    //     B B B B
-                    const auto translatedRect = _rc + delta;
-
-                    // Subtract the B from the A one to see what wasn't filled by the move.
-                    // C is the overlap of A and B:
-                    //
-                    // X <-- origin
-                    // A A A A                     1 1 1 1
-                    // A A A A                     1 1 1 1
-                    // A A C C B B     subtract    2 2
-                    // A A C C B B    --------->   2 2
-                    //     B B B B      A - B
-                    //     B B B B
-                    //
-                    // 1 and 2 are the spaces to fill that are "uncovered".
-                    const auto fillRects = originalRect - translatedRect;
-                    for (const auto& f : fillRects)
-                    {
-                        other.set(f);
-                    }
-                }
-
-                // Swap us with the temporary one.
-                std::swap(other, *this);
+                // Since every row starts on a new word, we can translate in place: vertically by
+                // moving whole rows and horizontally by shifting the words within each row.
+                // Each step fills the area it uncovered, if asked to, which adds up to
+                // filling the original area minus the translated one:
+                //
+                // X <-- origin
+                // A A A A                     1 1 1 1
+                // A A A A                     1 1 1 1
+                // A A C C B B     subtract    2 2
+                // A A C C B B    --------->   2 2
+                //     B B B B      A - B
+                //     B B B B
+                translate_y(delta.y, fill);
+                translate_x(delta.x, fill);
             }
 
             void set(const til::point pt)
@@ -354,7 +349,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                 THROW_HR_IF(E_INVALIDARG, !_rc.contains(pt));
                 _runs.reset(); // reset cached runs on any non-const method
 
-                _bits.set(_rc.index_of(pt));
+                const auto x = _bitmap_index(pt.x);
+                _bits[_bitmap_index(pt.y) * _stride + x / _bitmap_word_bits] |= 1ull << (x % _bitmap_word_bits);
             }
 
             void set(const til::rect& rc)
@@ -364,20 +360,20 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
                 for (auto row = rc.top; row < rc.bottom; ++row)
                 {
-                    _bits.set(_rc.index_of(til::point{ rc.left, row }), rc.width(), true);
+                    _fillRow(_bitmap_index(row) * _stride, _bitmap_index(rc.left), _bitmap_index(rc.right), true);
                 }
             }
 
             void set_all() noexcept
             {
                 _runs.reset(); // reset cached runs on any non-const method
-                _bits.set();
+                _fillRows(0, _bitmap_index(_sz.height), true);
             }
 
             void reset_all() noexcept
             {
                 _runs.reset(); // reset cached runs on any non-const method
-                _bits.reset();
+                std::fill(_bits.begin(), _bits.end(), 0ull);
             }
 
             // True if we resized. False if it was the same size as before.
@@ -435,7 +431,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             constexpr bool one() const noexcept
             {
-                return _bits.count() == 1;
+                return _count() == 1;
             }
 
             constexpr bool any() const noexcept
@@ -445,12 +441,13 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             constexpr bool none() const noexcept
             {
-                return _bits.none();
+                return std::all_of(_bits.begin(), _bits.end(), [](const auto word) { return word == 0; });
             }
 
             constexpr bool all() const noexcept
             {
-                return _bits.all();
+                // The padding bits are never set, so every cell is set if the count matches the area.
+                return _count() == _bitmap_index(_sz.width) * _bitmap_index(_sz.height);
             }
 
             constexpr til::size size() const noexcept
@@ -474,6 +471,64 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             }
 
         private:
+            static size_t _strideOf(const til::size sz)
+            {
+                return (sz.narrow_width<size_t>() + _bitmap_word_bits - 1) / _bitmap_word_bits;
+            }
+
+            constexpr size_t _count() const noexcept
+            {
+                size_t count = 0;
+                for (const auto word : _bits)
+                {
+                    count += _bitmap_index(std::popcount(word));
+                }
+                return count;
+            }
+
+            bool _test(const til::point pt) const
+            {
+                const auto x = _bitmap_index(pt.x);
+                return ((_bits.at(_bitmap_index(pt.y) * _stride + x / _bitmap_word_bits) >> (x % _bitmap_word_bits)) & 1) != 0;
+            }
+
+            // Sets (or clears) the bits [beg, end) of the row starting at _bits[offset].
+            void _fillRow(const size_t offset, const size_t beg, const size_t end, const bool value) noexcept
+            {
+                if (beg >= end)
+                {
+                    return;
+                }
+
+                const auto first = offset + beg / _bitmap_word_bits;
+                const auto last = offset + (end - 1) / _bitmap_word_bits;
+                const auto firstMask = ~0ull << (beg % _bitmap_word_bits);
+                const auto lastMask = ~0ull >> (_bitmap_word_bits - 1 - (end - 1) % _bitmap_word_bits);
+                const auto apply = [value](unsigned long long& word, const unsigned long long mask) noexcept {
+                    word = value ? word | mask : word & ~mask;
+                };
+
+                if (first == last)
+                {
+                    apply(_bits[first], firstMask & lastMask);
+                    return;
+                }
+
+                apply(_bits[first], firstMask);
+                std::fill(_bits.begin() + first + 1, _bits.begin() + last, value ? ~0ull : 0ull);
+                apply(_bits[last], lastMask);
+            }
+
+            // Sets (or clears) all bits within the rows [beg, end).
+            void _fillRows(const size_t beg, const size_t end, const bool value) noexcept
+            {
+                const auto width = _bitmap_index(_sz.width);
+                for (auto row = beg; row < end; ++row)
+                {
+                    _fillRow(row * _stride, 0, width, value);
+                }
+            }
+
             void translate_y(ptrdiff_t delta_y, bool fill)
             {
                 if (delta_y == 0)
@@ -481,16 +536,10 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     return;
                 }
 
-                const auto bitShift = delta_y * _sz.width;
+                const auto height = _bitmap_index(_sz.height);
+                const auto rows = _bitmap_index(std::abs(delta_y));
 
-#pragma warning(push)
-                // we can't depend on GSL here, so we use static_cast for explicit narrowing
-#pragma warning(disable : 26472)
-                const auto newBits = static_cast<size_t>(std::abs(bitShift));
-#pragma warning(pop)
-                const bool isLeftShift = bitShift > 0;
-
-                if (newBits >= _bits.size())
+                if (rows >= height)
                 {
                     if (fill)
                     {
@@ -503,26 +552,95 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
                     return;
                 }
 
-                if (isLeftShift)
+                // Rows are word aligned, so moving them is a plain move of whole words.
+                const auto words = rows * _stride;
+                if (delta_y > 0)
                 {
-                    // This operator doesn't modify the size of `_bits`: the
-                    // new bits are set to 0.
-                    _bits <<= newBits;
+                    std::move_backward(_bits.begin(), _bits.end() - words, _bits.end());
+                    _fillRows(0, rows, fill);
                 }
                 else
                 {
-                    _bits >>= newBits;
+                    std::move(_bits.begin() + words, _bits.end(), _bits.begin());
+                    _fillRows(height - rows, height, fill);
                 }
 
-                if (fill)
+                _runs.reset(); // reset cached runs on any non-const method
+            }
+
+            void translate_x(ptrdiff_t delta_x, bool fill)
+            {
+                if (delta_x == 0)
+                {
+                    return;
+                }
+
+                const auto width = _bitmap_index(_sz.width);
+                const auto cols = _bitmap_index(std::abs(delta_x));
+
+                if (cols >= width)
                 {
-                    if (isLeftShift)
+                    if (fill)
                     {
-                        _bits.set(0, newBits, true);
+                        set_all();
                     }
                     else
                     {
-                        _bits.set(_bits.size() - newBits, newBits, true);
+                        reset_all();
+                    }
+                    return;
+                }
+
+                // Shift each row as if it was a single _stride words wide integer.
+                // Moving to the right means shifting towards the more significant bits.
+                const auto wordShift = cols / _bitmap_word_bits;
+                const auto bitShift = cols % _bitmap_word_bits;
+                const auto paddingMask = ~0ull >> ((_bitmap_word_bits - width % _bitmap_word_bits) % _bitmap_word_bits);
+
+                for (size_t offset = 0; offset < _bits.size(); offset += _stride)
+                {
+                    const auto row = _bits.begin() + offset;
+
+                    if (delta_x > 0)
+                    {
+                        // Walk backwards, so that we don't overwrite words we still need to read.
+                        for (auto i = _stride; i-- > wordShift;)
+                        {
+                            auto word = row[i - wordShift] << bitShift;
+                            if (bitShift != 0 && i > wordShift)
+                            {
+                                word |= row[i - wordShift - 1] >> (_bitmap_word_bits - bitShift);
+                            }
+                            row[i] = word;
+                        }
+                        std::fill(row, row + wordShift, 0ull);
+
+                        // Bits that got shifted past the end of the row ended up in the padding.
+                        row[_stride - 1] &= paddingMask;
+
+                        if (fill)
+                        {
+                            _fillRow(offset, 0, cols, true);
+                        }
+                    }
+                    else
+                    {
+                        // The padding bits are unset, so they'll shift in zeros at the end of the row.
+                        for (size_t i = 0; i + wordShift < _stride; ++i)
+                        {
+                            auto word = row[i + wordShift] >> bitShift;
+                            if (bitShift != 0 && i + wordShift + 1 < _stride)
+                            {
+                                word |= row[i + wordShift + 1] << (_bitmap_word_bits - bitShift);
+                            }
+                            row[i] = word;
+                        }
+                        std::fill(row + (_stride - wordShift), row + _stride, 0ull);
+
+                        if (fill)
+                        {
+                            _fillRow(offset, width - cols, width, true);
+                        }
                     }
                 }
 
@@ -532,7 +650,12 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             allocator_type _alloc;
             til::size _sz;
             til::rect _rc;
-            dynamic_bitset<unsigned long long, allocator_type> _bits;
+            // The bits of each row start on a new word and any bits past the width of the bitmap are
+            // kept unset. This wastes up to 63 bits per row, but in exchange no run ever crosses a word
+            // that belongs to another row, moving rows vertically is a plain move of whole words and
+            // the padding acts as a sentinel when looking for the end of a run.
+            size_t _stride;
+            std::vector<unsigned long long, allocator_type> _bits;
 
             mutable std::optional<std::vector<til::rect, run_allocator_type>> _runs;
 
@@ -405,18 +405,12 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         // Get the value at the position
         const_reference at(size_type position) const
         {
-            const auto begin = _runs.begin();
-            const auto end = _runs.end();
-
-            rle_scanner scanner(begin, end);
-            auto it = scanner.scan(position).first;
-
-            if (it == end)
+            if (position >= _total_length)
             {
                 throw std::out_of_range("position out of range");
             }
 
-            return it->value;
+            return _scan_range(_runs.begin(), _runs.end(), position, position).begin->value;
         }
 
         // Returns the range [start_index, end_index) as a new vector.
@@ -440,9 +434,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             //
             // --> It's safe to subtract 1 from end_index
 
-            rle_scanner scanner(_runs.begin(), _runs.end());
-            auto [begin_run, start_run_pos] = scanner.scan(start_index);
-            auto [end_run, end_run_pos] = scanner.scan(end_index - 1);
+            auto [begin_run, start_run_pos, end_run, end_run_pos] = _scan_range(_runs.begin(), _runs.end(), start_index, static_cast<size_type>(end_index - 1));
 
             container slice{ begin_run, end_run + 1 };
             slice.back().length = end_run_pos + 1;
@@ -504,10 +496,11 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             }
             else if (new_size < _total_length)
             {
-                rle_scanner scanner(_runs.begin(), _runs.end());
-                auto [run, pos] = scanner.scan(new_size - 1);
+                const auto last_index = static_cast<size_type>(new_size - 1);
+                const auto range = _scan_range(_runs.begin(), _runs.end(), last_index, last_index);
+                auto run = range.begin;
 
-                run->length = ++pos;
+                run->length = static_cast<size_type>(range.begin_pos + 1);
 
                 _runs.erase(++run, _runs.end());
             }
@@ -637,6 +630,63 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             size_type total = 0;
         };
 
+        // The counterpart to rle_scanner, which walks from the end of the runs towards their beginning.
+        // Consecutive calls to scan() must pass monotonically decreasing indices.
+        template<typename It>
+        struct rle_reverse_scanner
+        {
+            explicit rle_reverse_scanner(It begin, It end, size_type total) noexcept :
+                begin(std::move(begin)), it(std::move(end)), total(total) {}
+
+            std::pair<It, size_type> scan(size_type index) noexcept
+            {
+                // total is the index at which the run "it" starts.
+                while (total > index && it != begin)
+                {
+                    --it;
+                    total -= it->length;
+                }
+
+                return { it, static_cast<size_type>(index - total) };
+            }
+
+        private:
+            const It begin;
+            It it;
+            size_type total = 0;
+        };
+
+        template<typename It>
+        struct rle_range
+        {
+            It begin;
+            size_type begin_pos;
+            It end;
+            size_type end_pos;
+        };
+
+        // Returns the runs containing start_index and end_index (or end() for an index of _total_length),
+        // as well as the offsets within them, just like 2 calls to rle_scanner::scan() would.
+        // Most modifications happen near either end of a row (writing at the cursor and
+        // erasing to the end of the line for instance), so instead of always walking forward,
+        // we walk from whichever end is closer to the range we're looking for.
+        template<typename It>
+        rle_range<It> _scan_range(It begin, It end, size_type start_index, size_type end_index) const noexcept
+        {
+            if (_total_length - start_index < end_index)
+            {
+                rle_reverse_scanner<It> scanner{ std::move(begin), std::move(end), _total_length };
+                const auto [end_run, end_pos] = scanner.scan(end_index);
+                const auto [begin_run, begin_pos] = scanner.scan(start_index);
+                return { begin_run, begin_pos, end_run, end_pos };
+            }
+
+            rle_scanner scanner{ std::move(begin), std::move(end) };
+            const auto [begin_run, begin_pos] = scanner.scan(start_index);
+            const auto [end_run, end_pos] = scanner.scan(end_index);
+            return { begin_run, begin_pos, end_run, end_pos };
+        }
+
         basic_rle(container&& runs, size_type size) :
             _runs(std::forward<container>(runs)),
             _total_length(size)
@@ -854,9 +904,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             // TODO GH#10135: Ensure replacements contains no runs with .length == 0.
 
-            rle_scanner scanner{ _runs.begin(), _runs.end() };
-            auto [begin, begin_pos] = scanner.scan(start_index);
-            auto [end, end_pos] = scanner.scan(end_index);
+            auto [begin, begin_pos, end, end_pos] = _scan_range(_runs.begin(), _runs.end(), start_index, end_index);
 
             // This condition handles pure removals, where replacements.size() == 0.
             //
@@ -34,7 +34,16 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
 {
     RETURN_HR_IF(S_FALSE, _passthrough && isSettingDefaultBrushes);
 
-    RETURN_IF_FAILED(VtEngine::_RgbUpdateDrawingBrushes(textAttributes));
+    // When we're trying to keep the output minimal, all the color and
+    // rendition changes are combined into a single SGR sequence instead.
+    if (_minimalDiff)
+    {
+        RETURN_IF_FAILED(_UpdateGraphicsRendition(textAttributes));
+    }
+    else
+    {
+        RETURN_IF_FAILED(VtEngine::_RgbUpdateDrawingBrushes(textAttributes));
+    }
 
     RETURN_IF_FAILED(_UpdateHyperlinkAttr(textAttributes, pData));
 
@@ -50,8 +59,154 @@ Xterm256Engine::Xterm256Engine(_In_ wil::unique_hfile hPipe,
     }
 
     // Only do extended attributes in xterm-256color, as to not break telnet.exe.
-    return _UpdateExtendedAttrs(textAttributes);
+    return _minimalDiff ? S_OK : _UpdateExtendedAttrs(textAttributes);
+}
+
+// Appends the SGR parameters for the given color to the buffer.
+static void appendColorParameters(fmt::memory_buffer& params, const TextColor& color, const bool isForeground)
+{
+    if (color.IsDefault())
+    {
+        fmt::format_to(std::back_inserter(params), FMT_COMPILE("{};"), isForeground ? 39 : 49);
+    }
+    else if (color.IsIndex16())
+    {
+        const auto index = color.GetIndex();
+        const auto base = WI_IsFlagSet(index, FOREGROUND_INTENSITY) ? (isForeground ? 90 : 100) : (isForeground ? 30 : 40);
+        fmt::format_to(std::back_inserter(params), FMT_COMPILE("{};"), base + (index & 7));
+    }
+    else if (color.IsIndex256())
+    {
+        fmt::format_to(std::back_inserter(params), FMT_COMPILE("{}8;5;{};"), isForeground ? '3' : '4', color.GetIndex());
+    }
+    else if (color.IsRgb())
+    {
+        const auto rgb = color.GetRGB();
+        fmt::format_to(std::back_inserter(params), FMT_COMPILE("{}8;2;{};{};{};"), isForeground ? '3' : '4', GetRValue(rgb), GetGValue(rgb), GetBValue(rgb));
+    }
+}
+
+// Appends the SGR parameters required to get from the "from" attributes to the
+// "to" attributes to the buffer. Every parameter is followed by a semicolon.
+static void appendRenditionChanges(fmt::memory_buffer& params, const TextAttribute& from, const TextAttribute& to)
+{
+    const auto append = [&](const std::string_view param) {
+        params.append(param.data(), param.data() + param.size());
+        params.push_back(';');
+    };
+
+    if (to.GetForeground() != from.GetForeground())
+    {
+        appendColorParameters(params, to.GetForeground(), true);
+    }
+    if (to.GetBackground() != from.GetBackground())
+    {
+        appendColorParameters(params, to.GetBackground(), false);
+    }
+
+    // Intense and faint, as well as the two underline styles, share a single
+    // parameter for turning them off. See _UpdateExtendedAttrs.
+    auto intense = from.IsIntense();
+    auto faint = from.IsFaint();
+    if ((intense && !to.IsIntense()) || (faint && !to.IsFaint()))
+    {
+        append("22");
+        intense = faint = false;
+    }
+    if (to.IsIntense() && !intense)
+    {
+        append("1");
+    }
+    if (to.IsFaint() && !faint)
+    {
+        append("2");
+    }
+
+    auto underlined = from.IsUnderlined();
+    auto doublyUnderlined = from.IsDoublyUnderlined();
+    if ((underlined && !to.IsUnderlined()) || (doublyUnderlined && !to.IsDoublyUnderlined()))
+    {
+        append("24");
+        underlined = doublyUnderlined = false;
+    }
+    if (to.IsUnderlined() && !underlined)
+    {
+        append("4");
+    }
+    if (to.IsDoublyUnderlined() && !doublyUnderlined)
+    {
+        append("21");
+    }
+
+    if (to.IsOverlined() != from.IsOverlined())
+    {
+        append(to.IsOverlined() ? "53" : "55");
+    }
+    if (to.IsItalic() != from.IsItalic())
+    {
+        append(to.IsItalic() ? "3" : "23");
+    }
+    if (to.IsBlinking() != from.IsBlinking())
+    {
+        append(to.IsBlinking() ? "5" : "25");
+    }
+    if (to.IsInvisible() != from.IsInvisible())
+    {
+        append(to.IsInvisible() ? "8" : "28");
+    }
+    if (to.IsCrossedOut() != from.IsCrossedOut())
+    {
+        append(to.IsCrossedOut() ? "9" : "29");
+    }
+    if (to.IsReverseVideo() != from.IsReverseVideo())
+    {
+        append(to.IsReverseVideo() ? "7" : "27");
+    }
+}
+
+// Routine Description:
+// - Write a single SGR sequence that changes the colors and the character
+//      rendition from the last attributes we sent to the given ones. We either
+//      send just the differences, or a reset followed by every attribute that
+//      isn't the default, whichever is shorter.
+// Arguments:
+// - textAttributes - Text attributes to use for the colors and character rendition
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]] HRESULT Xterm256Engine::_UpdateGraphicsRendition(const TextAttribute& textAttributes) noexcept
+try
+{
+    fmt::memory_buffer delta;
+    appendRenditionChanges(delta, _lastTextAttributes, textAttributes);
+    if (delta.size() == 0)
+    {
+        return S_OK;
+    }
+
+    // SGR 0 resets everything but the hyperlink, just like our default attributes.
+    static constexpr TextAttribute defaultAttributes{};
+    fmt::memory_buffer reset;
+    reset.push_back('0');
+    reset.push_back(';');
+    appendRenditionChanges(reset, defaultAttributes, textAttributes);
+
+    const auto& params = reset.size() < delta.size() ? reset : delta;
+    if (params.size() == 2 && &params == &reset)
+    {
+        RETURN_IF_FAILED(_SetGraphicsDefault());
+    }
+    else
+    {
+        // Drop the trailing semicolon.
+        RETURN_IF_FAILED(_WriteFormatted(FMT_COMPILE("\x1b[{}m"), std::string_view{ params.data(), params.size() - 1 }));
+    }
+
+    const auto hyperlinkId = _lastTextAttributes.GetHyperlinkId();
+    _lastTextAttributes = textAttributes;
+    _lastTextAttributes.SetHyperlinkId(hyperlinkId);
+    return S_OK;
 }
+CATCH_RETURN();
 
 // Routine Description:
 // - Write a VT sequence to update the character rendition attributes.
@@ -42,6 +42,7 @@ namespace Microsoft::Console::Render
 
     private:
         [[nodiscard]] HRESULT _UpdateExtendedAttrs(const TextAttribute& textAttributes) noexcept;
+        [[nodiscard]] HRESULT _UpdateGraphicsRendition(const TextAttribute& textAttributes) noexcept;
         [[nodiscard]] HRESULT _UpdateHyperlinkAttr(const TextAttribute& textAttributes,
                                                    const gsl::not_null<IRenderData*> pData) noexcept;
 
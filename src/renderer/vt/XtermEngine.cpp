@@ -64,6 +64,7 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
         //      the screen on the first paint, just to make sure that the
         //      terminal's state is consistent with what we'll be rendering.
         RETURN_IF_FAILED(_ClearScreen());
+        _InvalidateShadowFrame();
         _clearedAllThisFrame = true;
         _firstPaint = false;
     }
@@ -398,6 +399,9 @@ try
         RETURN_IF_FAILED(_InsertLine(absDy));
     }
 
+    // The terminal just moved its contents around. Do the same with our copy.
+    _ScrollShadowFrame(dy);
+
     // Restore our wrap state.
     _wrappedRow = oldWrappedRow;
     _delayedEolWrap = oldDelayedEolWrap;
@@ -523,6 +527,9 @@ CATCH_RETURN();
 // - S_OK or suitable HRESULT error from either conversion or writing pipe.
 [[nodiscard]] HRESULT XtermEngine::WriteTerminalW(const std::wstring_view wstr) noexcept
 {
+    // We have no idea what this string will do to the terminal's contents.
+    _InvalidateShadowFrame();
+
     RETURN_IF_FAILED(_fUseAsciiOnly ?
                          VtEngine::_WriteTerminalAscii(wstr) :
                          VtEngine::_WriteTerminalUtf8(wstr));
@@ -135,6 +135,11 @@ CATCH_RETURN();
 // - S_OK
 [[nodiscard]] HRESULT VtEngine::PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept
 {
+    // From now on, _Flush waits until the output has been written, because
+    // the host is about to exit and would take the writer thread with it.
+    // The final frame might not have anything to flush, so drain right away.
+    _teardown = true;
+    LOG_IF_FAILED(_Flush());
     *pForcePaint = true;
     return S_OK;
 }
@@ -127,6 +127,12 @@ using namespace Microsoft::Console::Types;
     // used anymore (we check that at the end of any fullscreen paint).
     if (lineRendition != LineRendition::SingleWidth)
     {
+        // Double width lines don't map cells to columns the way our shadow
+        // frame does, so we have to forget what the terminal displays.
+        if (!_usingLineRenditions)
+        {
+            _InvalidateShadowFrame();
+        }
         _stopUsingLineRenditions = false;
         _usingLineRenditions = true;
     }
@@ -419,20 +425,110 @@ using namespace Microsoft::Console::Types;
 // Routine Description:
 // - Draws one line of the buffer to the screen. Writes the characters to the
 //      pipe, encoded in UTF-8.
+// - If we're tracking what the terminal currently displays (see
+//      SetMinimalDiffMode), the run is split up into the segments that actually
+//      changed, and unchanged cells are skipped over with cursor movements
+//      whenever that's cheaper than printing them again.
 // Arguments:
 // - clusters - text and column widths to be written
 // - coord - character coordinate target to render within viewport
+// - lineWrapped: true if this run we're painting is the end of a line that
+//   wrapped.
 // Return Value:
 // - S_OK or suitable HRESULT error from writing pipe.
 [[nodiscard]] HRESULT VtEngine::_PaintUtf8BufferLine(const std::span<const Cluster> clusters,
                                                      const til::point coord,
                                                      const bool lineWrapped) noexcept
+try
 {
     if (coord.y < _virtualTop)
     {
         return S_OK;
     }
 
+    if (!_UsingShadowFrame() || clusters.empty())
+    {
+        return _PaintUtf8BufferRun(clusters, coord, lineWrapped);
+    }
+
+    const auto row = _GetShadowRow(coord.y);
+
+    // The last cluster of a wrapped line always needs to be printed, so that
+    // the terminal marks its row as wrapped as well. Likewise, the first
+    // cluster of the row following a wrapped one needs to be printed, because
+    // that's what makes the terminal actually perform the wrap. (GH#5113)
+    const auto continuesWrappedRow = coord.x == 0 && _wrappedRow.has_value() && coord.y == _wrappedRow.value() + 1;
+    const auto end = lineWrapped ? clusters.size() - 1 : clusters.size();
+
+    auto x = coord.x;
+    size_t i = 0;
+    if (continuesWrappedRow)
+    {
+        x += til::at(clusters, 0).GetColumns();
+        i = 1;
+    }
+
+    auto segmentBegin = size_t{ 0 };
+    auto segmentX = coord.x;
+
+    while (i < end)
+    {
+        if (!_ShadowMatches(row, x, til::at(clusters, i)))
+        {
+            x += til::at(clusters, i).GetColumns();
+            ++i;
+            continue;
+        }
+
+        const auto gapBegin = i;
+        const auto gapX = x;
+        do
+        {
+            x += til::at(clusters, i).GetColumns();
+            ++i;
+        } while (i < end && _ShadowMatches(row, x, til::at(clusters, i)));
+        const auto gapColumns = x - gapX;
+
+        // Skipping over unchanged cells at the end of the run is free. At the
+        // start of the run it's free as well, unless the cursor is already in
+        // the right place. Anywhere else it costs us a CUF, which only pays
+        // off if that's shorter than reprinting the cells.
+        const auto atEnd = i == clusters.size();
+        const auto atBegin = gapBegin == 0 && _lastText != coord;
+        if (atEnd || atBegin || gsl::narrow_cast<size_t>(gapColumns) > fmt::formatted_size(FMT_COMPILE("\x1b[{}C"), gapColumns))
+        {
+            if (gapBegin > segmentBegin)
+            {
+                RETURN_IF_FAILED(_PaintUtf8BufferRun(clusters.subspan(segmentBegin, gapBegin - segmentBegin), { segmentX, coord.y }, false));
+            }
+            segmentBegin = i;
+            segmentX = x;
+        }
+    }
+
+    if (segmentBegin < clusters.size())
+    {
+        RETURN_IF_FAILED(_PaintUtf8BufferRun(clusters.subspan(segmentBegin), { segmentX, coord.y }, lineWrapped));
+    }
+
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Draws a run of cells of one line of the buffer to the screen. Writes the
+//      characters to the pipe, encoded in UTF-8.
+// Arguments:
+// - clusters - text and column widths to be written
+// - coord - character coordinate target to render within viewport
+// - lineWrapped: true if this run we're painting is the end of a line that
+//   wrapped.
+// Return Value:
+// - S_OK or suitable HRESULT error from writing pipe.
+[[nodiscard]] HRESULT VtEngine::_PaintUtf8BufferRun(const std::span<const Cluster> clusters,
+                                                    const til::point coord,
+                                                    const bool lineWrapped) noexcept
+{
     _bufferLine.clear();
     _bufferLine.reserve(clusters.size());
     til::CoordType totalWidth = 0;
@@ -542,11 +638,20 @@ using namespace Microsoft::Console::Types;
     {
         RETURN_IF_FAILED(VtEngine::_WriteTerminalDrcs({ _bufferLine.data(), cchActual }));
     }
+    else if (_minimalDiff)
+    {
+        RETURN_IF_FAILED(VtEngine::_WriteTerminalUtf8Repeated({ _bufferLine.data(), cchActual }, clusters));
+    }
     else
     {
         RETURN_IF_FAILED(VtEngine::_WriteTerminalUtf8({ _bufferLine.data(), cchActual }));
     }
 
+    if (_minimalDiff)
+    {
+        _UpdateShadowFrame(clusters, coord, cchActual, useEraseChar);
+    }
+
     // GH#4415, GH#5181
     // If the renderer told us that this was a wrapped line, then mark
     // that we've wrapped this line. The next time we attempt to move the
@@ -67,6 +67,11 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
 #endif
 }
 
+VtEngine::~VtEngine()
+{
+    _StopWriter();
+}
+
 // Method Description:
 // - Writes a fill of characters to our file handle (repeat of same character over and over)
 [[nodiscard]] HRESULT VtEngine::_WriteFill(const size_t n, const char c) noexcept
@@ -136,15 +141,26 @@ CATCH_RETURN();
     CATCH_RETURN();
 }
 
+// Method Description:
+// - Hands the contents of _buffer over to the writer thread, which writes them
+//      to the pipe asynchronously. Only blocks if the terminal has fallen behind
+//      by more than OUTPUT_HARD_LIMIT bytes, or during teardown, where we wait
+//      for all output to reach the pipe before the process exits.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or suitable HRESULT error from writing pipe.
 [[nodiscard]] HRESULT VtEngine::_Flush() noexcept
 {
-    if (_hFile)
+    if (_hFile && (!_buffer.empty() || _teardown))
     {
-        auto fSuccess = !!WriteFile(_hFile.get(), _buffer.data(), gsl::narrow_cast<DWORD>(_buffer.size()), nullptr, nullptr);
-        _buffer.clear();
-        if (!fSuccess)
+        const auto hr = _HandOffToWriter();
+        if (FAILED(hr))
         {
-            _exitResult = HRESULT_FROM_WIN32(GetLastError());
+            // The writer thread exits on failure. It needs to be gone
+            // before we can close the handle it's been writing to.
+            _StopWriter();
+            _exitResult = hr;
             _hFile.reset();
             if (_terminalOwner)
             {
@@ -157,13 +173,203 @@ CATCH_RETURN();
     return S_OK;
 }
 
+// Method Description:
+// - Moves the contents of _buffer to the writer thread's pending output.
+//      If the writer thread is idle, the two buffers are simply swapped.
+//      Otherwise the output is appended to what's still pending, which
+//      coalesces multiple frames into a single WriteFile call.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK or the error that the writer thread encountered.
+[[nodiscard]] HRESULT VtEngine::_HandOffToWriter() noexcept
+try
+{
+    std::unique_lock lock{ _writer.mutex };
+    RETURN_IF_FAILED(_writer.result);
+
+    if (!_buffer.empty())
+    {
+        if (!_writer.thread.joinable())
+        {
+            _writer.thread = std::thread{ [this]() { _WriterThread(); } };
+        }
+
+        if (_writer.pending.empty())
+        {
+            _writer.pending.swap(_buffer);
+        }
+        else
+        {
+            _writer.pending.append(_buffer);
+            _writer.counters.coalesced++;
+        }
+        _buffer.clear();
+        _writer.wake.notify_one();
+    }
+
+    _WaitForWriter(lock, _teardown ? 0 : OUTPUT_HARD_LIMIT);
+    return _writer.result;
+}
+CATCH_RETURN();
+
+// Method Description:
+// - Blocks until the writer thread has no more than `limit` bytes left to
+//      write, or until it failed. The time spent waiting is recorded in the
+//      stall time counter.
+// Arguments:
+// - lock - a lock held on _writer.mutex
+// - limit - the maximum number of bytes that may remain unwritten
+// Return Value:
+// - <none>
+void VtEngine::_WaitForWriter(std::unique_lock<std::mutex>& lock, const size_t limit) noexcept
+{
+    const auto caughtUp = [&]() noexcept {
+        return _writer.pending.size() + _writer.inflight <= limit || FAILED(_writer.result) || !_writer.thread.joinable();
+    };
+
+    if (!caughtUp())
+    {
+        const auto start = std::chrono::steady_clock::now();
+        _writer.drained.wait(lock, caughtUp);
+        _writer.counters.stallTime += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+}
+
+// Method Description:
+// - The body of the writer thread. Writes whatever output is pending, until
+//      _StopWriter asks it to exit or writing to the pipe fails.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_WriterThread() noexcept
+{
+    std::string chunk;
+    std::unique_lock lock{ _writer.mutex };
+
+    for (;;)
+    {
+        _writer.wake.wait(lock, [&]() noexcept { return !_writer.pending.empty() || _writer.exit; });
+
+        // Even when asked to exit we write out what's left,
+        // because that's the last frame before the host exits.
+        if (_writer.pending.empty())
+        {
+            return;
+        }
+
+        chunk.clear();
+        chunk.swap(_writer.pending);
+        _writer.inflight = chunk.size();
+
+        lock.unlock();
+        const auto fSuccess = !!WriteFile(_hFile.get(), chunk.data(), gsl::narrow_cast<DWORD>(chunk.size()), nullptr, nullptr);
+        const auto hr = fSuccess ? S_OK : HRESULT_FROM_WIN32(GetLastError());
+        lock.lock();
+
+        _writer.inflight = 0;
+        _writer.counters.bytes += chunk.size();
+        _writer.counters.writes++;
+
+        if (FAILED(hr))
+        {
+            _writer.result = hr;
+            _writer.pending.clear();
+        }
+
+        _writer.drained.notify_all();
+
+        if (FAILED(hr))
+        {
+            return;
+        }
+    }
+}
+
+// Method Description:
+// - Waits for the writer thread to write out any pending output and exit.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::_StopWriter() noexcept
+{
+    if (_writer.thread.joinable())
+    {
+        {
+            const std::lock_guard lock{ _writer.mutex };
+            _writer.exit = true;
+        }
+        _writer.wake.notify_one();
+        _writer.thread.join();
+    }
+}
+
+// Method Description:
+// - Blocks the render thread while the writer thread is more than
+//      OUTPUT_HIGH_WATER_MARK bytes behind. Invalidations keep accumulating in
+//      the meantime, so that a terminal which can't keep up receives fewer,
+//      larger frames instead of an ever growing backlog of stale ones.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtEngine::WaitUntilCanRender() noexcept
+{
+    RenderEngineBase::WaitUntilCanRender();
+
+    std::unique_lock lock{ _writer.mutex };
+    _WaitForWriter(lock, OUTPUT_HIGH_WATER_MARK);
+}
+
+// Method Description:
+// - Returns statistics about the output written to the pipe so far.
+VtEngine::OutputCounters VtEngine::GetOutputCounters() const noexcept
+{
+    const std::lock_guard lock{ _writer.mutex };
+    return _writer.counters;
+}
+
 // Method Description:
 // - Wrapper for _Write.
 [[nodiscard]] HRESULT VtEngine::WriteTerminalUtf8(const std::string_view str) noexcept
 {
+    _InvalidateShadowFrame();
     return _Write(str);
 }
 
+// Method Description:
+// - Queues output of a VT client that we trust to be well-formed for the
+//      terminal, unmodified. It's handed to the writer thread right away,
+//      without running a frame, which would move the cursor and hide it in
+//      the middle of the client's output. While the writer thread is busy,
+//      the output of consecutive calls piles up in its pending buffer and
+//      goes out in a single WriteFile, which batches chatty clients.
+// Arguments:
+// - str - the UTF-8 output of the client
+// Return Value:
+// - S_OK or suitable HRESULT error from writing pipe.
+[[nodiscard]] HRESULT VtEngine::QueueTerminalUtf8(const std::string_view str) noexcept
+{
+    _InvalidateShadowFrame();
+    RETURN_IF_FAILED(_Write(str));
+    return _Flush();
+}
+
+// Method Description:
+// - Same as QueueTerminalUtf8, but for UTF-16 output.
+// Arguments:
+// - wstr - the UTF-16 output of the client
+// Return Value:
+// - S_OK or suitable HRESULT error from either conversion or writing pipe.
+[[nodiscard]] HRESULT VtEngine::QueueTerminalW(const std::wstring_view wstr) noexcept
+{
+    _InvalidateShadowFrame();
+    RETURN_IF_FAILED(_WriteTerminalUtf8(wstr));
+    return _Flush();
+}
+
 // Method Description:
 // - Writes a wstring to the tty, encoded as full utf-8. This is one
 //      implementation of the WriteTerminalW method.
@@ -177,6 +383,63 @@ CATCH_RETURN();
     return _Write(_conversionBuffer);
 }
 
+// Method Description:
+// - Writes a wstring to the tty, encoded as full utf-8, just like
+//      _WriteTerminalUtf8. Runs of the same glyph are compressed into a single
+//      glyph followed by a REP sequence, whenever that's shorter.
+// Arguments:
+// - wstr - wstring of text to be written. Must be the concatenated text of a
+//      prefix of the given clusters.
+// - clusters - the clusters the text consists of
+// Return Value:
+// - S_OK or suitable HRESULT error from either conversion or writing pipe.
+[[nodiscard]] HRESULT VtEngine::_WriteTerminalUtf8Repeated(const std::wstring_view wstr, const std::span<const Cluster> clusters) noexcept
+try
+{
+    size_t pending = 0;
+    size_t offset = 0;
+
+    for (size_t i = 0; i < clusters.size() && offset < wstr.size();)
+    {
+        const auto glyph = til::at(clusters, i).GetText();
+        size_t count = 1;
+
+        // Only clusters consisting of a single code unit can be repeated. Anything
+        // else might be a combining sequence, which REP doesn't reproduce faithfully.
+        if (glyph.size() == 1 && !til::is_surrogate(til::at(glyph, 0)))
+        {
+            while (i + count < clusters.size() && offset + count < wstr.size() && til::at(clusters, i + count).GetText() == glyph)
+            {
+                ++count;
+            }
+
+            if (count > 1)
+            {
+                const auto wch = til::at(glyph, 0);
+                const auto repeats = gsl::narrow_cast<til::CoordType>(count - 1);
+                const size_t glyphLength = wch < 0x80 ? 1 : wch < 0x800 ? 2 : 3;
+                if (repeats * glyphLength > fmt::formatted_size(FMT_COMPILE("\x1b[{}b"), repeats))
+                {
+                    RETURN_IF_FAILED(_WriteTerminalUtf8(wstr.substr(pending, offset + 1 - pending)));
+                    RETURN_IF_FAILED(_RepeatCharacter(repeats));
+                    pending = offset + count;
+                }
+            }
+        }
+
+        offset += glyph.size() * count;
+        i += count;
+    }
+
+    if (pending < wstr.size())
+    {
+        RETURN_IF_FAILED(_WriteTerminalUtf8(wstr.substr(pending)));
+    }
+
+    return S_OK;
+}
+CATCH_RETURN();
+
 // Method Description:
 // - Writes a wstring to the tty, encoded as "utf-8" where characters that are
 //      outside the ASCII range are encoded as '?'
@@ -311,6 +574,13 @@ CATCH_RETURN();
     _suppressResizeRepaint = false;
     _lastViewport = newView;
 
+    // The terminal might reflow its contents on a resize, so we can't make any
+    // assumptions about what it displays anymore.
+    if (oldSize != newSize)
+    {
+        _InvalidateShadowFrame();
+    }
+
     return hr;
 }
 
@@ -503,6 +773,180 @@ void VtEngine::SetPassthroughMode(const bool passthrough) noexcept
     _passthrough = passthrough;
 }
 
+// Method Description:
+// - Configure the renderer to keep track of what the connected terminal
+//   currently displays. Invalidated cells are then only sent to the terminal
+//   if they actually changed, and repeated glyphs are compressed with REP.
+// Arguments:
+// - minimalDiff - True to turn on minimal diff rendering. False otherwise.
+// Return Value:
+// - <none>
+void VtEngine::SetMinimalDiffMode(const bool minimalDiff) noexcept
+{
+    _minimalDiff = minimalDiff;
+    _InvalidateShadowFrame();
+}
+
+// Method Description:
+// - Returns true if the cells we paint can be compared against our shadow copy
+//   of the terminal's contents. Soft fonts and line renditions change the way
+//   characters map to cells, so we don't bother tracking them.
+bool VtEngine::_UsingShadowFrame() const noexcept
+{
+    return _minimalDiff && !_passthrough && !_usingLineRenditions && !_usingSoftFont && !_shadowFrame.empty();
+}
+
+// Method Description:
+// - Forgets everything we know about the contents of the terminal, for
+//   instance because we wrote something to it that we can't reason about.
+void VtEngine::_InvalidateShadowFrame() noexcept
+{
+    if (!_minimalDiff)
+    {
+        _shadowFrame.clear();
+        _shadowSize = {};
+        return;
+    }
+
+    try
+    {
+        _shadowSize = _lastViewport.Dimensions();
+        _shadowFrame.assign(gsl::narrow_cast<size_t>(_shadowSize.area()), ShadowCell{ SHADOW_UNKNOWN, {} });
+    }
+    catch (...)
+    {
+        LOG_CAUGHT_EXCEPTION();
+        _shadowFrame.clear();
+        _shadowSize = {};
+    }
+}
+
+// Method Description:
+// - Scrolls our shadow copy of the terminal's contents the same way we just
+//   scrolled the terminal. Newly revealed rows are unknown.
+// Arguments:
+// - dy - the scroll delta. Negative values scroll the contents upwards.
+void VtEngine::_ScrollShadowFrame(const til::CoordType dy) noexcept
+{
+    if (_shadowFrame.empty() || dy == 0)
+    {
+        return;
+    }
+
+    const auto rows = std::min(std::abs(dy), _shadowSize.height);
+    const auto shift = gsl::narrow_cast<size_t>(rows) * gsl::narrow_cast<size_t>(_shadowSize.width);
+    const auto beg = _shadowFrame.begin();
+    const auto end = _shadowFrame.end();
+    const ShadowCell unknown{ SHADOW_UNKNOWN, {} };
+
+    if (dy < 0)
+    {
+        std::move(beg + shift, end, beg);
+        std::fill(end - shift, end, unknown);
+    }
+    else
+    {
+        std::move_backward(beg, end - shift, end);
+        std::fill(beg, beg + shift, unknown);
+    }
+}
+
+// Method Description:
+// - Returns the cells of the given viewport row in our shadow copy of the
+//   terminal's contents, or an empty span if the row is out of bounds.
+std::span<VtEngine::ShadowCell> VtEngine::_GetShadowRow(const til::CoordType y) noexcept
+{
+    if (y < 0 || y >= _shadowSize.height || _shadowFrame.empty())
+    {
+        return {};
+    }
+
+    const auto width = gsl::narrow_cast<size_t>(_shadowSize.width);
+    return std::span{ _shadowFrame }.subspan(gsl::narrow_cast<size_t>(y) * width, width);
+}
+
+// Method Description:
+// - Returns true if painting the given cluster at the given column with the
+//   current attributes wouldn't change what the terminal displays.
+bool VtEngine::_ShadowMatches(const std::span<const ShadowCell> row, const til::CoordType x, const Cluster& cluster) const noexcept
+{
+    const auto text = cluster.GetText();
+    const auto columns = cluster.GetColumns();
+    if (text.size() != 1 || x < 0 || columns < 1 || gsl::narrow_cast<size_t>(x + columns) > row.size())
+    {
+        return false;
+    }
+
+    const auto& head = til::at(row, x);
+    if (head.ch == SHADOW_UNKNOWN || head.ch != til::at(text, 0) || head.attr != _lastTextAttributes)
+    {
+        return false;
+    }
+
+    for (auto i = x + 1; i < x + columns; ++i)
+    {
+        const auto& trailer = til::at(row, i);
+        if (trailer.ch != SHADOW_TRAILING || trailer.attr != _lastTextAttributes)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Method Description:
+// - Records the cells we just painted in our shadow copy of the terminal's contents.
+// Arguments:
+// - clusters - the clusters of the run we painted
+// - coord - the position the run was painted at
+// - cchWritten - the number of code units we actually printed. The cells past
+//   that point were either erased (see erasedSpaces) or left untouched.
+// - erasedSpaces - true if the unprinted cells were erased with ECH or EL
+void VtEngine::_UpdateShadowFrame(const std::span<const Cluster> clusters, const til::point coord, const size_t cchWritten, const bool erasedSpaces) noexcept
+{
+    const auto row = _GetShadowRow(coord.y);
+    const auto track = _UsingShadowFrame();
+    const ShadowCell unknown{ SHADOW_UNKNOWN, {} };
+
+    auto x = coord.x;
+    size_t cch = 0;
+    for (const auto& cluster : clusters)
+    {
+        const auto text = cluster.GetText();
+        const auto columns = cluster.GetColumns();
+        const auto written = cch < cchWritten;
+        cch += text.size();
+
+        for (auto i = 0; i < columns; ++i, ++x)
+        {
+            if (x < 0 || gsl::narrow_cast<size_t>(x) >= row.size())
+            {
+                continue;
+            }
+
+            auto& cell = til::at(row, x);
+            if (!track)
+            {
+                cell = unknown;
+            }
+            else if (written)
+            {
+                const auto ch = text.size() == 1 ? til::at(text, 0) : SHADOW_UNKNOWN;
+                cell = { i == 0 ? ch : SHADOW_TRAILING, _lastTextAttributes };
+            }
+            else if (erasedSpaces)
+            {
+                cell = { L' ', _lastTextAttributes };
+            }
+            else
+            {
+                cell = unknown;
+            }
+        }
+    }
+}
+
 void VtEngine::SetLookingForDSRCallback(std::function<void(bool)> pfnLooking) noexcept
 {
     _pfnSetLookingForDSR = pfnLooking;
@@ -549,6 +993,7 @@ HRESULT VtEngine::RequestWin32Input() noexcept
 
 HRESULT VtEngine::SwitchScreenBuffer(const bool useAltBuffer) noexcept
 {
+    _InvalidateShadowFrame();
     RETURN_IF_FAILED(_SwitchScreenBuffer(useAltBuffer));
     RETURN_IF_FAILED(_Flush());
     return S_OK;
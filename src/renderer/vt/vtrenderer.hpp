@@ -20,6 +20,7 @@ Author(s):
 #include "tracing.hpp"
 #include <string>
 #include <functional>
+#include <condition_variable>
 
 // fwdecl unittest classes
 #ifdef UNIT_TESTING
@@ -42,14 +43,27 @@ namespace Microsoft::Console::Render
     public:
         // See _PaintUtf8BufferLine for explanation of this value.
         static const size_t ERASE_CHARACTER_STRING_LENGTH = 8;
+        // See WaitUntilCanRender and _Flush for explanation of these values.
+        static const size_t OUTPUT_HIGH_WATER_MARK = 256 * 1024;
+        static const size_t OUTPUT_HARD_LIMIT = 4 * OUTPUT_HIGH_WATER_MARK;
         static const til::point INVALID_COORDS;
 
+        struct OutputCounters
+        {
+            uint64_t bytes = 0; // bytes written to the pipe
+            uint64_t writes = 0; // calls to WriteFile
+            uint64_t coalesced = 0; // flushes that were merged into a pending write
+            std::chrono::microseconds stallTime{}; // time spent waiting for the pipe to drain
+        };
+
         VtEngine(_In_ wil::unique_hfile hPipe,
                  const Microsoft::Console::Types::Viewport initialViewport);
+        ~VtEngine() override;
 
         // IRenderEngine
         [[nodiscard]] HRESULT StartPaint() noexcept override;
         [[nodiscard]] HRESULT EndPaint() noexcept override;
+        void WaitUntilCanRender() noexcept override;
         [[nodiscard]] HRESULT Present() noexcept override;
         [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* pForcePaint) noexcept override;
         [[nodiscard]] HRESULT Invalidate(const til::rect* psrRegion) noexcept override;
@@ -78,12 +92,16 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT RequestCursor() noexcept;
         [[nodiscard]] HRESULT InheritCursor(const til::point coordCursor) noexcept;
         [[nodiscard]] HRESULT WriteTerminalUtf8(const std::string_view str) noexcept;
+        [[nodiscard]] HRESULT QueueTerminalUtf8(const std::string_view str) noexcept;
+        [[nodiscard]] HRESULT QueueTerminalW(const std::wstring_view str) noexcept;
+        OutputCounters GetOutputCounters() const noexcept;
         [[nodiscard]] virtual HRESULT WriteTerminalW(const std::wstring_view str) noexcept = 0;
         void SetTerminalOwner(Microsoft::Console::VirtualTerminal::VtIo* const terminalOwner);
         void BeginResizeRequest();
         void EndResizeRequest();
         void SetResizeQuirk(const bool resizeQuirk);
         void SetPassthroughMode(const bool passthrough) noexcept;
+        void SetMinimalDiffMode(const bool minimalDiff) noexcept;
         void SetLookingForDSRCallback(std::function<void(bool)> pfnLooking) noexcept;
         void SetTerminalCursorTextPosition(const til::point coordCursor) noexcept;
         [[nodiscard]] virtual HRESULT ManuallyClearScrollback() noexcept;
@@ -141,9 +159,45 @@ namespace Microsoft::Console::Render
         bool _passthrough{ false };
         std::optional<TextColor> _newBottomLineBG{ std::nullopt };
 
+        // A copy of what we believe the connected terminal currently displays,
+        // one entry per cell of the viewport. It's used to skip cells that the
+        // host invalidated, but which wouldn't actually change on the terminal.
+        struct ShadowCell
+        {
+            wchar_t ch;
+            TextAttribute attr;
+        };
+        static constexpr wchar_t SHADOW_UNKNOWN = L'\0';
+        static constexpr wchar_t SHADOW_TRAILING = L'\xFFFF';
+        bool _minimalDiff{ false };
+        std::vector<ShadowCell> _shadowFrame;
+        til::size _shadowSize;
+
+        // The output pipe is written to by a separate thread, so that a terminal
+        // which reads slowly doesn't stall the render thread. _buffer is filled
+        // with the next frame while the writer thread writes the previous one.
+        struct PipeWriter
+        {
+            mutable std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable drained;
+            std::thread thread;
+            std::string pending;
+            size_t inflight = 0;
+            bool exit = false;
+            HRESULT result = S_OK;
+            OutputCounters counters;
+        };
+        PipeWriter _writer;
+        bool _teardown{ false };
+
         [[nodiscard]] HRESULT _WriteFill(const size_t n, const char c) noexcept;
         [[nodiscard]] HRESULT _Write(std::string_view const str) noexcept;
         [[nodiscard]] HRESULT _Flush() noexcept;
+        [[nodiscard]] HRESULT _HandOffToWriter() noexcept;
+        void _WaitForWriter(std::unique_lock<std::mutex>& lock, const size_t limit) noexcept;
+        void _WriterThread() noexcept;
+        void _StopWriter() noexcept;
 
         template<typename S, typename... Args>
         [[nodiscard]] HRESULT _WriteFormatted(S&& format, Args&&... args)
@@ -167,6 +221,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _DeleteLine(const til::CoordType sLines) noexcept;
         [[nodiscard]] HRESULT _InsertLine(const til::CoordType sLines) noexcept;
         [[nodiscard]] HRESULT _CursorForward(const til::CoordType chars) noexcept;
+        [[nodiscard]] HRESULT _RepeatCharacter(const til::CoordType count) noexcept;
         [[nodiscard]] HRESULT _EraseCharacter(const til::CoordType chars) noexcept;
         [[nodiscard]] HRESULT _CursorPosition(const til::point coord) noexcept;
         [[nodiscard]] HRESULT _CursorHome() noexcept;
@@ -213,6 +268,13 @@ namespace Microsoft::Console::Render
 
         bool _WillWriteSingleChar() const;
 
+        bool _UsingShadowFrame() const noexcept;
+        void _InvalidateShadowFrame() noexcept;
+        void _ScrollShadowFrame(const til::CoordType dy) noexcept;
+        std::span<ShadowCell> _GetShadowRow(const til::CoordType y) noexcept;
+        bool _ShadowMatches(const std::span<const ShadowCell> row, const til::CoordType x, const Cluster& cluster) const noexcept;
+        void _UpdateShadowFrame(const std::span<const Cluster> clusters, const til::point coord, const size_t cchWritten, const bool erasedSpaces) noexcept;
+
         // buffer space for these two functions to build their lines
         // so they don't have to alloc/free in a tight loop
         std::wstring _bufferLine;
@@ -220,10 +282,15 @@ namespace Microsoft::Console::Render
                                                    const til::point coord,
                                                    const bool lineWrapped) noexcept;
 
+        [[nodiscard]] HRESULT _PaintUtf8BufferRun(const std::span<const Cluster> clusters,
+                                                  const til::point coord,
+                                                  const bool lineWrapped) noexcept;
+
         [[nodiscard]] HRESULT _PaintAsciiBufferLine(const std::span<const Cluster> clusters,
                                                     const til::point coord) noexcept;
 
         [[nodiscard]] HRESULT _WriteTerminalUtf8(const std::wstring_view str) noexcept;
+        [[nodiscard]] HRESULT _WriteTerminalUtf8Repeated(const std::wstring_view str, const std::span<const Cluster> clusters) noexcept;
         [[nodiscard]] HRESULT _WriteTerminalAscii(const std::wstring_view str) noexcept;
         [[nodiscard]] HRESULT _WriteTerminalDrcs(const std::wstring_view str) noexcept;
 
@@ -152,23 +152,23 @@
 
     std::unique_ptr<IWaitRoutine> waiter;
     HRESULT hr;
-    std::deque<std::unique_ptr<IInputEvent>> outEvents;
-    const auto eventsToRead = cRecords;
+    const std::span<INPUT_RECORD> outRecords{ rgRecords, cRecords };
+    size_t eventsRead = 0;
     if (a->Unicode)
     {
         if (fIsPeek)
         {
             hr = m->_pApiRoutines->PeekConsoleInputWImpl(*pInputBuffer,
-                                                         outEvents,
-                                                         eventsToRead,
+                                                         outRecords,
+                                                         eventsRead,
                                                          *pInputReadHandleData,
                                                          waiter);
         }
         else
         {
             hr = m->_pApiRoutines->ReadConsoleInputWImpl(*pInputBuffer,
-                                                         outEvents,
-                                                         eventsToRead,
+                                                         outRecords,
+                                                         eventsRead,
                                                          *pInputReadHandleData,
                                                          waiter);
         }
@@ -178,16 +178,16 @@
         if (fIsPeek)
         {
             hr = m->_pApiRoutines->PeekConsoleInputAImpl(*pInputBuffer,
-                                                         outEvents,
-                                                         eventsToRead,
+                                                         outRecords,
+                                                         eventsRead,
                                                          *pInputReadHandleData,
                                                          waiter);
         }
         else
         {
             hr = m->_pApiRoutines->ReadConsoleInputAImpl(*pInputBuffer,
-                                                         outEvents,
-                                                         eventsToRead,
+                                                         outRecords,
+                                                         eventsRead,
                                                          *pInputReadHandleData,
                                                          waiter);
         }
@@ -195,10 +195,10 @@
 
     // We must return the number of records in the message payload (to alert the client)
     // as well as in the message headers (below in SetReplyInformation) to alert the driver.
-    LOG_IF_FAILED(SizeTToULong(outEvents.size(), &a->NumRecords));
+    LOG_IF_FAILED(SizeTToULong(eventsRead, &a->NumRecords));
 
     size_t cbWritten;
-    LOG_IF_FAILED(SizeTMult(outEvents.size(), sizeof(INPUT_RECORD), &cbWritten));
+    LOG_IF_FAILED(SizeTMult(eventsRead, sizeof(INPUT_RECORD), &cbWritten));
 
     if (nullptr != waiter.get())
     {
@@ -226,22 +226,6 @@
             hr = S_OK;
         }
     }
-    else
-    {
-        try
-        {
-            for (size_t i = 0; i < cRecords; ++i)
-            {
-                if (outEvents.empty())
-                {
-                    break;
-                }
-                rgRecords[i] = outEvents.front()->ToInputRecord();
-                outEvents.pop_front();
-            }
-        }
-        CATCH_RETURN();
-    }
 
     if (SUCCEEDED(hr))
     {
@@ -135,7 +135,7 @@ bool ConsoleWaitBlock::Notify(const WaitTerminationReason TerminationReason)
     DWORD dwControlKeyState;
     auto fIsUnicode = true;
 
-    std::deque<std::unique_ptr<IInputEvent>> outEvents;
+    std::span<INPUT_RECORD> outRecords;
     // TODO: MSFT 14104228 - get rid of this void* and get the data
     // out of the read wait object properly.
     void* pOutputData = nullptr;
@@ -148,7 +148,17 @@ bool ConsoleWaitBlock::Notify(const WaitTerminationReason TerminationReason)
     {
         auto a = &(_WaitReplyMessage.u.consoleMsgL1.GetConsoleInput);
         fIsUnicode = !!a->Unicode;
-        pOutputData = &outEvents;
+
+        // The records are read straight into the client's buffer.
+        void* buffer;
+        ULONG cbBuffer;
+        if (FAILED(_WaitReplyMessage.GetOutputBuffer(&buffer, &cbBuffer)))
+        {
+            return false;
+        }
+
+        outRecords = { static_cast<INPUT_RECORD*>(buffer), cbBuffer / sizeof(INPUT_RECORD) };
+        pOutputData = &outRecords;
         break;
     }
     case API_NUMBER_READCONSOLE:
@@ -183,25 +193,7 @@ bool ConsoleWaitBlock::Notify(const WaitTerminationReason TerminationReason)
             // information with the number of records, not number of
             // bytes.
             auto a = &(_WaitReplyMessage.u.consoleMsgL1.GetConsoleInput);
-
-            void* buffer;
-            ULONG cbBuffer;
-            if (FAILED(_WaitReplyMessage.GetOutputBuffer(&buffer, &cbBuffer)))
-            {
-                return false;
-            }
-
-            const auto pRecordBuffer = static_cast<INPUT_RECORD* const>(buffer);
-            a->NumRecords = static_cast<ULONG>(outEvents.size());
-            for (size_t i = 0; i < a->NumRecords; ++i)
-            {
-                if (outEvents.empty())
-                {
-                    break;
-                }
-                pRecordBuffer[i] = outEvents.front()->ToInputRecord();
-                outEvents.pop_front();
-            }
+            a->NumRecords = static_cast<ULONG>(NumBytes / sizeof(INPUT_RECORD));
         }
         else if (API_NUMBER_READCONSOLE == _WaitReplyMessage.msgHeader.ApiNumber)
         {
@@ -23,7 +23,9 @@ namespace Microsoft::Console::VirtualTerminal
 class Microsoft::Console::VirtualTerminal::ITermDispatch
 {
 public:
-    using StringHandler = std::function<bool(const wchar_t)>;
+    // String handlers receive the data string in chunks, the end of which is
+    // signaled with a lone ESC. Returning false ignores the rest of the string.
+    using StringHandler = std::function<bool(const std::wstring_view)>;
 
 #pragma warning(push)
 #pragma warning(disable : 26432) // suppress rule of 5 violation on interface because tampering with this is fraught with peril
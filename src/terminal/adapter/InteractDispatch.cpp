@@ -72,22 +72,38 @@ bool InteractDispatch::WriteString(const std::wstring_view string)
     if (!string.empty())
     {
         const auto codepage = _api.GetConsoleOutputCP();
-        std::deque<std::unique_ptr<IInputEvent>> keyEvents;
+        std::vector<INPUT_RECORD> records;
+        records.reserve(string.size() * 2);
 
         for (const auto& wch : string)
         {
-            auto convertedEvents = CharToKeyEvents(wch, codepage);
-
-            std::move(convertedEvents.begin(),
-                      convertedEvents.end(),
-                      std::back_inserter(keyEvents));
+            for (const auto& keyEvent : CharToKeyEvents(wch, codepage))
+            {
+                records.emplace_back(keyEvent->ToInputRecord());
+            }
         }
 
-        WriteInput(keyEvents);
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        gci.GetActiveInputBuffer()->Write(records);
     }
     return true;
 }
 
+// Method Description:
+// - Writes a string of input to the host as it is, without converting it to
+//      keystrokes first. This is only meaningful for clients in VT input mode,
+//      which would receive the same string if it was typed.
+// Arguments:
+// - string : a string to write to the console.
+// Return Value:
+// - True.
+bool InteractDispatch::WriteVtInput(const std::wstring_view string)
+{
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    gci.GetActiveInputBuffer()->WriteVtInput(string);
+    return true;
+}
+
 //Method Description:
 // Window Manipulation - Performs a variety of actions relating to the window,
 //      such as moving the window position, resizing the window, querying
@@ -28,6 +28,7 @@ namespace Microsoft::Console::VirtualTerminal
         bool WriteInput(std::deque<std::unique_ptr<IInputEvent>>& inputEvents) override;
         bool WriteCtrlKey(const KeyEvent& event) override;
         bool WriteString(const std::wstring_view string) override;
+        bool WriteVtInput(const std::wstring_view string) override;
         bool WindowManipulation(const DispatchTypes::WindowManipulationType function,
                                 const VTParameter parameter1,
                                 const VTParameter parameter2) override; // DTTERM_WindowManipulation
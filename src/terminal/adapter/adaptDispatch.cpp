@@ -3135,36 +3135,39 @@ ITermDispatch::StringHandler AdaptDispatch::DownloadDRCS(const VTInt fontNumber,
     // set translation is correctly handled on the host side.
     const auto conptyPassthrough = _api.IsConsolePty() ? _CreateDrcsPassthroughHandler(charsetSize) : nullptr;
 
-    return [=](const auto ch) {
+    return [=](const std::wstring_view str) {
         if (conptyPassthrough)
         {
-            conptyPassthrough(ch);
+            conptyPassthrough(str);
         }
         // We pass the data string straight through to the font buffer class
         // until we receive an ESC, indicating the end of the string. At that
         // point we can finalize the buffer, and if valid, update the renderer
         // with the constructed bit pattern.
-        if (ch != AsciiChars::ESC)
+        for (const auto ch : str)
         {
-            _fontBuffer->AddSixelData(ch);
-        }
-        else if (_fontBuffer->FinalizeSixelData())
-        {
-            // We also need to inform the character set mapper of the ID that
-            // will map to this font (we only support one font buffer so there
-            // will only ever be one active dynamic character set).
-            if (charsetSize == DispatchTypes::DrcsCharsetSize::Size96)
+            if (ch != AsciiChars::ESC)
             {
-                _termOutput.SetDrcs96Designation(_fontBuffer->GetDesignation());
+                _fontBuffer->AddSixelData(ch);
             }
-            else
+            else if (_fontBuffer->FinalizeSixelData())
             {
-                _termOutput.SetDrcs94Designation(_fontBuffer->GetDesignation());
+                // We also need to inform the character set mapper of the ID that
+                // will map to this font (we only support one font buffer so there
+                // will only ever be one active dynamic character set).
+                if (charsetSize == DispatchTypes::DrcsCharsetSize::Size96)
+                {
+                    _termOutput.SetDrcs96Designation(_fontBuffer->GetDesignation());
+                }
+                else
+                {
+                    _termOutput.SetDrcs94Designation(_fontBuffer->GetDesignation());
+                }
+                const auto bitPattern = _fontBuffer->GetBitPattern();
+                const auto cellSize = _fontBuffer->GetCellSize();
+                const auto centeringHint = _fontBuffer->GetTextCenteringHint();
+                _renderer.UpdateSoftFont(bitPattern, cellSize, centeringHint);
             }
-            const auto bitPattern = _fontBuffer->GetBitPattern();
-            const auto cellSize = _fontBuffer->GetCellSize();
-            const auto centeringHint = _fontBuffer->GetTextCenteringHint();
-            _renderer.UpdateSoftFont(bitPattern, cellSize, centeringHint);
         }
         return true;
     };
@@ -3184,20 +3187,30 @@ ITermDispatch::StringHandler AdaptDispatch::_CreateDrcsPassthroughHandler(const
     if (defaultPassthrough)
     {
         auto& engine = _api.GetStateMachine().Engine();
-        return [=, &engine, gotId = false](const auto ch) mutable {
+        return [=, &engine, gotId = false](std::wstring_view str) mutable {
             // The character set ID is contained in the first characters of the
             // sequence, so we just ignore that initial content until we receive
             // a "final" character (i.e. in range 30 to 7E). At that point we
-            // pass through a hard-coded ID of "@".
+            // pass through a hard-coded ID of "@", followed by whatever is left
+            // of the data we were given.
             if (!gotId)
             {
-                if (ch >= 0x30 && ch <= 0x7E)
+                const auto idEnd = std::find_if(str.begin(), str.end(), [](const auto ch) {
+                    return ch >= 0x30 && ch <= 0x7E;
+                });
+                if (idEnd == str.end())
+                {
+                    return true;
+                }
+                gotId = true;
+                defaultPassthrough(L"@");
+                str = str.substr(idEnd - str.begin() + 1);
+                if (str.empty())
                 {
-                    gotId = true;
-                    defaultPassthrough('@');
+                    return true;
                 }
             }
-            else if (!defaultPassthrough(ch))
+            if (!defaultPassthrough(str))
             {
                 // Once the DECDLD sequence is finished, we also output an SCS
                 // sequence to map the character set into the G1 table.
@@ -3230,8 +3243,15 @@ ITermDispatch::StringHandler AdaptDispatch::DefineMacro(const VTInt macroId,
 
     if (_macroBuffer->InitParser(macroId, deleteControl, encoding))
     {
-        return [&](const auto ch) {
-            return _macroBuffer->ParseDefinition(ch);
+        return [&](const std::wstring_view str) {
+            for (const auto ch : str)
+            {
+                if (!_macroBuffer->ParseDefinition(ch))
+                {
+                    return false;
+                }
+            }
+            return true;
         };
     }
 
@@ -3302,45 +3322,52 @@ ITermDispatch::StringHandler AdaptDispatch::_RestoreColorTable()
         return _CreatePassthroughHandler();
     }
 
-    return [this, parameter = VTInt{}, parameters = std::vector<VTParameter>{}](const auto ch) mutable {
-        if (ch >= L'0' && ch <= L'9')
-        {
-            parameter *= 10;
-            parameter += (ch - L'0');
-            parameter = std::min(parameter, MAX_PARAMETER_VALUE);
-        }
-        else if (ch == L';')
+    return [this, parameter = VTInt{}, parameters = std::vector<VTParameter>{}](const std::wstring_view str) mutable {
+        for (const auto ch : str)
         {
-            if (parameters.size() < 5)
+            if (ch >= L'0' && ch <= L'9')
             {
-                parameters.push_back(parameter);
+                parameter *= 10;
+                parameter += (ch - L'0');
+                parameter = std::min(parameter, MAX_PARAMETER_VALUE);
             }
-            parameter = 0;
-        }
-        else if (ch == L'/' || ch == AsciiChars::ESC)
-        {
-            parameters.push_back(parameter);
-            const auto colorParameters = VTParameters{ parameters.data(), parameters.size() };
-            const auto colorNumber = colorParameters.at(0).value_or(0);
-            if (colorNumber < TextColor::TABLE_SIZE)
+            else if (ch == L';')
             {
-                const auto colorModel = DispatchTypes::ColorModel{ colorParameters.at(1) };
-                const auto x = colorParameters.at(2).value_or(0);
-                const auto y = colorParameters.at(3).value_or(0);
-                const auto z = colorParameters.at(4).value_or(0);
-                if (colorModel == DispatchTypes::ColorModel::HLS)
+                if (parameters.size() < 5)
                 {
-                    SetColorTableEntry(colorNumber, Utils::ColorFromHLS(x, y, z));
+                    parameters.push_back(parameter);
                 }
-                else if (colorModel == DispatchTypes::ColorModel::RGB)
+                parameter = 0;
+            }
+            else if (ch == L'/' || ch == AsciiChars::ESC)
+            {
+                parameters.push_back(parameter);
+                const auto colorParameters = VTParameters{ parameters.data(), parameters.size() };
+                const auto colorNumber = colorParameters.at(0).value_or(0);
+                if (colorNumber < TextColor::TABLE_SIZE)
                 {
-                    SetColorTableEntry(colorNumber, Utils::ColorFromRGB100(x, y, z));
+                    const auto colorModel = DispatchTypes::ColorModel{ colorParameters.at(1) };
+                    const auto x = colorParameters.at(2).value_or(0);
+                    const auto y = colorParameters.at(3).value_or(0);
+                    const auto z = colorParameters.at(4).value_or(0);
+                    if (colorModel == DispatchTypes::ColorModel::HLS)
+                    {
+                        SetColorTableEntry(colorNumber, Utils::ColorFromHLS(x, y, z));
+                    }
+                    else if (colorModel == DispatchTypes::ColorModel::RGB)
+                    {
+                        SetColorTableEntry(colorNumber, Utils::ColorFromRGB100(x, y, z));
+                    }
                 }
+                parameters.clear();
+                parameter = 0;
+            }
+            if (ch == AsciiChars::ESC)
+            {
+                return false;
             }
-            parameters.clear();
-            parameter = 0;
         }
-        return (ch != AsciiChars::ESC);
+        return true;
     };
 }
 
@@ -3361,38 +3388,38 @@ ITermDispatch::StringHandler AdaptDispatch::RequestSetting()
     // say that 0 is for a valid response, and 1 is for an error. The correct
     // interpretation is documented in the DEC STD 070 reference.
     const auto idBuilder = std::make_shared<VTIDBuilder>();
-    return [=](const auto ch) {
-        if (ch >= '\x40' && ch <= '\x7e')
+    return [=](const std::wstring_view str) {
+        for (const auto ch : str)
         {
-            const auto id = idBuilder->Finalize(ch);
-            switch (id)
+            if (ch >= '\x40' && ch <= '\x7e')
             {
-            case VTID("m"):
-                _ReportSGRSetting();
-                break;
-            case VTID("r"):
-                _ReportDECSTBMSetting();
-                break;
-            case VTID("\"q"):
-                _ReportDECSCASetting();
-                break;
-            case VTID("*x"):
-                _ReportDECSACESetting();
-                break;
-            default:
-                _api.ReturnResponse(L"\033P0$r\033\\");
-                break;
+                const auto id = idBuilder->Finalize(ch);
+                switch (id)
+                {
+                case VTID("m"):
+                    _ReportSGRSetting();
+                    break;
+                case VTID("r"):
+                    _ReportDECSTBMSetting();
+                    break;
+                case VTID("\"q"):
+                    _ReportDECSCASetting();
+                    break;
+                case VTID("*x"):
+                    _ReportDECSACESetting();
+                    break;
+                default:
+                    _api.ReturnResponse(L"\033P0$r\033\\");
+                    break;
+                }
+                return false;
             }
-            return false;
-        }
-        else
-        {
-            if (ch >= '\x20' && ch <= '\x2f')
+            else if (ch >= '\x20' && ch <= '\x2f')
             {
                 idBuilder->AddIntermediate(ch);
             }
-            return true;
         }
+        return true;
     };
 }
 
@@ -3585,13 +3612,13 @@ ITermDispatch::StringHandler AdaptDispatch::_CreatePassthroughHandler()
         // And finally we create a StringHandler to receive the rest of the
         // sequence data, and pass it through to the connected terminal.
         auto& engine = stateMachine.Engine();
-        return [&, buffer = std::wstring{}](const auto ch) mutable {
+        return [&, buffer = std::wstring{}](const std::wstring_view str) mutable {
             // To make things more efficient, we buffer the string data before
             // passing it through, only flushing if the buffer gets too large,
-            // or we're dealing with the last character in the current output
-            // fragment, or we've reached the end of the string.
-            const auto endOfString = ch == AsciiChars::ESC;
-            buffer += ch;
+            // or we've been given the last of the current output fragment, or
+            // we've reached the end of the string.
+            const auto endOfString = !str.empty() && str.back() == AsciiChars::ESC;
+            buffer += str;
             if (buffer.length() >= 4096 || stateMachine.IsProcessingLastCharacter() || endOfString)
             {
                 // The end of the string is signaled with an escape, but for it
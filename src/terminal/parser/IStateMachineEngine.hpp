@@ -20,7 +20,9 @@ namespace Microsoft::Console::VirtualTerminal
     class IStateMachineEngine
     {
     public:
-        using StringHandler = std::function<bool(const wchar_t)>;
+        // String handlers receive the data string in chunks, the end of which is
+        // signaled with a lone ESC. Returning false ignores the rest of the string.
+        using StringHandler = std::function<bool(const std::wstring_view)>;
 
         virtual ~IStateMachineEngine() = 0;
         IStateMachineEngine(const IStateMachineEngine&) = default;
@@ -47,6 +49,7 @@ namespace Microsoft::Console::VirtualTerminal
         virtual bool ActionOscDispatch(const wchar_t wch,
                                        const size_t parameter,
                                        const std::wstring_view string) = 0;
+        virtual StringHandler ActionOscStringStart(const size_t parameter) = 0;
 
         virtual bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) = 0;
 
@@ -260,6 +260,13 @@ bool InputStateMachineEngine::ActionPrintString(const std::wstring_view string)
     {
         return true;
     }
+
+    // Pasted text doesn't need to be turned into keystrokes for clients in VT input mode,
+    // since they'd just be turned back into the same text. Hand it over in one piece instead.
+    if (_inBracketedPaste && _pDispatch->IsVtInputEnabled())
+    {
+        return _pDispatch->WriteVtInput(string);
+    }
     return _pDispatch->WriteString(string);
 }
 
@@ -274,16 +281,10 @@ bool InputStateMachineEngine::ActionPassThroughString(const std::wstring_view st
 {
     if (_pDispatch->IsVtInputEnabled())
     {
-        // Synthesize string into key events that we'll write to the buffer
-        // similar to TerminalInput::_SendInputSequence
+        // Write the string as key events similar to TerminalInput::_SendInputSequence
         if (!string.empty())
         {
-            std::deque<std::unique_ptr<IInputEvent>> inputEvents;
-            for (const auto& wch : string)
-            {
-                inputEvents.push_back(std::make_unique<KeyEvent>(true, 1ui16, 0ui16, 0ui16, wch, 0));
-            }
-            return _pDispatch->WriteInput(inputEvents);
+            return _pDispatch->WriteVtInput(string);
         }
     }
     return ActionPrintString(string);
@@ -357,6 +358,21 @@ bool InputStateMachineEngine::ActionVt52EscDispatch(const VTID /*id*/, const VTP
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
 {
+    // Keep track of whether we're inside a bracketed paste, so that its
+    // contents can be written in bulk. See ActionPrintString.
+    if (id == CsiActionCodes::Generic)
+    {
+        const GenericKeyIdentifiers identifier = parameters.at(0);
+        if (identifier == GenericKeyIdentifiers::BracketedPasteStart)
+        {
+            _inBracketedPaste = true;
+        }
+        else if (identifier == GenericKeyIdentifiers::BracketedPasteEnd)
+        {
+            _inBracketedPaste = false;
+        }
+    }
+
     // GH#4999 - If the client was in VT input mode, but we received a
     // win32-input-mode sequence, then _don't_ passthrough the sequence to the
     // client. It's impossibly unlikely that the client actually wanted
@@ -470,6 +486,19 @@ IStateMachineEngine::StringHandler InputStateMachineEngine::ActionDcsDispatch(co
     return nullptr;
 }
 
+// Routine Description:
+// - Triggers the OscStringStart action, which allows the listener to process
+//      an OSC string as it arrives, instead of after it has been collected.
+// Arguments:
+// - parameter - identifier of the OSC action to perform
+// Return Value:
+// - the string handler function or nullptr if the string should be collected
+IStateMachineEngine::StringHandler InputStateMachineEngine::ActionOscStringStart(const size_t /*parameter*/) noexcept
+{
+    // OSC strings are never long enough to be worth streaming in the input state machine.
+    return nullptr;
+}
+
 // Routine Description:
 // - Triggers the Ss3Dispatch action to indicate that the listener should handle
 //      a control sequence. These sequences perform various API-type commands
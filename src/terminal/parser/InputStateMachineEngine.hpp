@@ -110,6 +110,8 @@ namespace Microsoft::Console::VirtualTerminal
         F10 = 21,
         F11 = 23,
         F12 = 24,
+        BracketedPasteStart = 200,
+        BracketedPasteEnd = 201,
     };
 
     enum class Ss3ActionCodes : wchar_t
@@ -152,6 +154,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         StringHandler ActionDcsDispatch(const VTID id, const VTParameters parameters) noexcept override;
 
+        StringHandler ActionOscStringStart(const size_t parameter) noexcept override;
+
         bool ActionClear() noexcept override;
 
         bool ActionIgnore() noexcept override;
@@ -173,6 +177,7 @@ namespace Microsoft::Console::VirtualTerminal
         std::optional<til::point> _lastMouseClickPos{};
         std::optional<std::chrono::steady_clock::time_point> _lastMouseClickTime{};
         std::optional<size_t> _lastMouseClickButton{};
+        bool _inBracketedPaste{ false };
 
         DWORD _GetCursorKeysModifierState(const VTParameters parameters, const VTID id) noexcept;
         DWORD _GetGenericKeysModifierState(const VTParameters parameters) noexcept;
@@ -18,7 +18,8 @@ OutputStateMachineEngine::OutputStateMachineEngine(std::unique_ptr<ITermDispatch
     _dispatch(std::move(pDispatch)),
     _pfnFlushToTerminal(nullptr),
     _pTtyConnection(nullptr),
-    _lastPrintedChar(AsciiChars::NUL)
+    _lastPrintedChar(AsciiChars::NUL),
+    _maxClipboardSize(MAX_CLIPBOARD_SIZE)
 {
     THROW_HR_IF_NULL(E_INVALIDARG, _dispatch.get());
 }
@@ -940,6 +941,74 @@ bool OutputStateMachineEngine::ActionOscDispatch(const wchar_t /*wch*/,
     return success;
 }
 
+// Routine Description:
+// - Triggers the OscStringStart action, which allows the listener to process
+//      an OSC string as it arrives, instead of after it has been collected.
+//      We use this to decode the base64 data of clipboard requests as it
+//      streams in, so it never needs to be buffered in full, and oversized
+//      requests are rejected as soon as they exceed the size limit.
+// Arguments:
+// - parameter - identifier of the OSC action to perform
+// Return Value:
+// - the string handler function or nullptr if the string should be collected
+IStateMachineEngine::StringHandler OutputStateMachineEngine::ActionOscStringStart(const size_t parameter)
+{
+    // If there's a TTY attached to us, clipboard requests need to be collected
+    // as usual, so they can be flushed to the terminal as a whole.
+    if (parameter != OscActionCodes::SetClipboard || _pfnFlushToTerminal != nullptr)
+    {
+        return nullptr;
+    }
+
+    return [this, decoder = Base64::Decoder{ _maxClipboardSize }, gotSelection = false, gotData = false, discard = false](std::wstring_view str) mutable {
+        const auto endOfString = !str.empty() && str.back() == AsciiChars::ESC;
+        if (endOfString)
+        {
+            str.remove_suffix(1);
+        }
+
+        // Once we know that the content won't be used, the rest of the string is
+        // discarded. The handler needs to stay alive until the string is terminated
+        // though, because that's when the sequence is considered dispatched.
+        if (!discard)
+        {
+            // The string has the format `Pc;Pd`, where the first parameter `Pc`
+            // is ignored, and the second parameter `Pd` is the base64 content.
+            if (!gotSelection)
+            {
+                const auto pos = str.find(L';');
+                gotSelection = pos != std::wstring_view::npos;
+                str = gotSelection ? str.substr(pos + 1) : std::wstring_view{};
+            }
+
+            // A `Pd` of `?` is a query for the clipboard content, which we don't
+            // support, so there's no need to look at the rest of the string.
+            if (!gotData && !str.empty())
+            {
+                gotData = true;
+                discard = str.front() == L'?';
+            }
+
+            if (!discard)
+            {
+                discard = FAILED(LOG_IF_FAILED(decoder.Append(str)));
+            }
+        }
+
+        if (endOfString)
+        {
+            std::wstring content;
+            if (!discard && gotSelection && SUCCEEDED_LOG(decoder.Finish(content)))
+            {
+                _dispatch->SetClipboard(content);
+            }
+            TermTelemetry::Instance().Log(TermTelemetry::Codes::OSCSCB);
+            _ClearLastChar();
+        }
+        return !endOfString;
+    };
+}
+
 // Routine Description:
 // - Triggers the Ss3Dispatch action to indicate that the listener should handle
 //      a control sequence. These sequences perform various API-type commands
@@ -1127,6 +1196,18 @@ void OutputStateMachineEngine::SetTerminalConnection(Render::VtEngine* const pTt
     this->_pfnFlushToTerminal = pfnFlushToTerminal;
 }
 
+// Routine Description:
+// - Sets the maximum size of the content that OSC 52 clipboard requests may
+//   carry. Requests with more data than that are ignored.
+// Arguments:
+// - maxSize - The maximum size of the decoded content in bytes (UTF-8).
+// Return Value:
+// - <none>
+void OutputStateMachineEngine::SetClipboardSizeLimit(const size_t maxSize) noexcept
+{
+    _maxClipboardSize = maxSize;
+}
+
 // Routine Description:
 // - Parse OscSetClipboard parameters with the format `Pc;Pd`. Currently the first parameter `Pc` is
 // ignored. The second parameter `Pd` should be a valid base64 string or character `?`.
@@ -27,6 +27,7 @@ namespace Microsoft::Console::VirtualTerminal
     {
     public:
         static constexpr size_t MAX_URL_LENGTH = 2 * 1048576; // 2MB, like iTerm2
+        static constexpr size_t MAX_CLIPBOARD_SIZE = 16 * 1048576; // 16MB of decoded OSC 52 data
 
         OutputStateMachineEngine(std::unique_ptr<ITermDispatch> pDispatch);
 
@@ -55,11 +56,15 @@ namespace Microsoft::Console::VirtualTerminal
                                const size_t parameter,
                                const std::wstring_view string) override;
 
+        StringHandler ActionOscStringStart(const size_t parameter) override;
+
         bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) noexcept override;
 
         void SetTerminalConnection(Microsoft::Console::Render::VtEngine* const pTtyConnection,
                                    std::function<bool()> pfnFlushToTerminal);
 
+        void SetClipboardSizeLimit(const size_t maxSize) noexcept;
+
         const ITermDispatch& Dispatch() const noexcept;
         ITermDispatch& Dispatch() noexcept;
 
@@ -68,6 +73,7 @@ namespace Microsoft::Console::VirtualTerminal
         Microsoft::Console::Render::VtEngine* _pTtyConnection;
         std::function<bool()> _pfnFlushToTerminal;
         wchar_t _lastPrintedChar;
+        size_t _maxClipboardSize;
 
         enum EscActionCodes : uint64_t
         {
@@ -26,6 +26,17 @@ static constexpr uint8_t decodeTable[128] = {
 };
 // clang-format on
 
+// Capturing r/error by reference produces less optimal assembly.
+static constexpr auto accumulate = [](auto& r, auto& error, auto ch) {
+    // n will be in the range [0, 0x3f] for valid ch
+    // and exactly 0xff for invalid ch.
+    const auto n = decodeTable[ch & 0x7f];
+    // Both ch > 0x7f, as well as n > 0x7f are invalid values and count as an error.
+    // We can add the error state by checking if any bits ~0x7f are set (which is 0xff80).
+    error |= (ch | n) & 0xff80;
+    r = r << 6 | n;
+};
+
 // Decodes an UTF8 string encoded with RFC 4648 (Base64) and returns it as UTF16 in dst.
 // It supports both variants of the RFC (base64 and base64url), but
 // throws an error for non-alphabet characters, including newlines.
@@ -74,17 +85,6 @@ HRESULT Base64::Decode(const std::wstring_view& src, std::wstring& dst) noexcept
     // error is treated as a boolean. If it's not 0 we had an invalid input character.
     uint_fast16_t error = 0;
 
-    // Capturing r/error by reference produces less optimal assembly.
-    static constexpr auto accumulate = [](auto& r, auto& error, auto ch) {
-        // n will be in the range [0, 0x3f] for valid ch
-        // and exactly 0xff for invalid ch.
-        const auto n = decodeTable[ch & 0x7f];
-        // Both ch > 0x7f, as well as n > 0x7f are invalid values and count as an error.
-        // We can add the error state by checking if any bits ~0x7f are set (which is 0xff80).
-        error |= (ch | n) & 0xff80;
-        r = r << 6 | n;
-    };
-
     // If src.empty() then `in == inEndBatched == nullptr` and this is skipped.
     while (in < inEndBatched)
     {
@@ -156,3 +156,204 @@ HRESULT Base64::Decode(const std::wstring_view& src, std::wstring& dst) noexcept
     result.resize(out - outBeg);
     return til::u8u16(result, dst);
 }
+
+Base64::Decoder::Decoder(const size_t maxSize) noexcept :
+    _maxSize{ maxSize }
+{
+}
+
+// Decodes the next piece of a base64 string and appends it to the result.
+// The pieces may be split anywhere, even in the middle of a group of 4 characters.
+// * Returns ERROR_INVALID_DATA for invalid base64 inputs. Unlike Decode(),
+//   "=" is only accepted at the very end of the string.
+// * Returns ERROR_BUFFER_OVERFLOW once the decoded result exceeds maxSize bytes,
+//   so that callers can give up on oversized strings before they've been received in full.
+// Once an error has been returned, all further calls fail with that same error.
+HRESULT Base64::Decoder::Append(const std::wstring_view& src) noexcept
+{
+    if (FAILED(_hr))
+    {
+        return _hr;
+    }
+
+    // Every group of 4 characters, including the ones left over from the previous piece, results in 3 bytes.
+    const auto previousSize = _result.size();
+    _result.resize(previousSize + (_ri + src.size()) / 4 * 3);
+
+#pragma warning(suppress : 26429) // Symbol 'in' is never tested for nullness, it can be marked as not_null (f.23).
+    auto in = src.data();
+    const auto inEnd = in + src.size();
+    const auto outBeg = _result.data() + previousSize;
+#pragma warning(suppress : 26429) // Symbol 'out' is never tested for nullness, it can be marked as not_null (f.23).
+    auto out = outBeg;
+    auto r = _r;
+    auto ri = _ri;
+    uint_fast16_t error = 0;
+
+    while (in < inEnd)
+    {
+        // As long as we're at the start of a group and haven't seen any padding,
+        // we can decode entire groups at once. Anything else, like a group that
+        // was split across two pieces, the trailing "=", or an invalid character,
+        // is dealt with one character at a time below.
+        if (ri == 0 && !_padding)
+        {
+#if _M_AMD64
+#pragma warning(push)
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+            // SSE2 lacks the byte shuffles that most vectorized base64 decoders are built on,
+            // but we can still validate and translate 16 characters at a time using range
+            // comparisons, and then merge their 6-bit values into 24-bit groups:
+            // _mm_madd_epi16 turns pairs of values into 12 bits (a << 6 | b) and
+            // the 64-bit shifts turn pairs of those into 24 bits (c << 12 | d).
+            // The characters are narrowed to bytes first. Anything outside of the
+            // Latin-1 range saturates to 0x00 or 0xff, neither of which is valid.
+            const auto upperFirst = _mm_set1_epi8('A' - 1);
+            const auto upperLast = _mm_set1_epi8('Z' + 1);
+            const auto lowerFirst = _mm_set1_epi8('a' - 1);
+            const auto lowerLast = _mm_set1_epi8('z' + 1);
+            const auto digitFirst = _mm_set1_epi8('0' - 1);
+            const auto digitLast = _mm_set1_epi8('9' + 1);
+            const auto zero = _mm_setzero_si128();
+            const auto multipliers = _mm_set1_epi32(0x00010040);
+            for (; inEnd - in >= 16; in += 16)
+            {
+                const auto chars = _mm_packus_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8)));
+                const auto upper = _mm_and_si128(_mm_cmpgt_epi8(chars, upperFirst), _mm_cmplt_epi8(chars, upperLast));
+                const auto lower = _mm_and_si128(_mm_cmpgt_epi8(chars, lowerFirst), _mm_cmplt_epi8(chars, lowerLast));
+                const auto digit = _mm_and_si128(_mm_cmpgt_epi8(chars, digitFirst), _mm_cmplt_epi8(chars, digitLast));
+                const auto plus = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('+')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('-')));
+                const auto slash = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('/')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('_')));
+                const auto valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash);
+                if (_mm_movemask_epi8(valid) != 0xffff)
+                {
+                    break;
+                }
+
+                auto values = _mm_and_si128(upper, _mm_sub_epi8(chars, _mm_set1_epi8('A')));
+                values = _mm_or_si128(values, _mm_and_si128(lower, _mm_sub_epi8(chars, _mm_set1_epi8('a' - 26))));
+                values = _mm_or_si128(values, _mm_and_si128(digit, _mm_add_epi8(chars, _mm_set1_epi8(52 - '0'))));
+                values = _mm_or_si128(values, _mm_and_si128(plus, _mm_set1_epi8(62)));
+                values = _mm_or_si128(values, _mm_and_si128(slash, _mm_set1_epi8(63)));
+
+                for (const auto half : { _mm_unpacklo_epi8(values, zero), _mm_unpackhi_epi8(values, zero) })
+                {
+                    const auto pairs = _mm_madd_epi16(half, multipliers);
+                    const auto groups = _mm_or_si128(_mm_slli_epi64(pairs, 12), _mm_srli_epi64(pairs, 32));
+                    const auto group0 = static_cast<uint32_t>(_mm_cvtsi128_si32(groups));
+                    const auto group1 = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(groups, 8)));
+                    // The 6 bytes are stored big-endian, which a byte swap of both groups gives us in one go.
+                    const auto bytes = _byteswap_uint64((uint64_t{ group0 } << 40) | (uint64_t{ group1 } << 16));
+                    memcpy(out, &bytes, 6);
+                    out += 6;
+                }
+            }
+#pragma warning(pop)
+#endif
+
+            for (; inEnd - in >= 4; in += 4)
+            {
+                uint_fast32_t group = 0;
+                uint_fast16_t groupError = 0;
+                accumulate(group, groupError, in[0]);
+                accumulate(group, groupError, in[1]);
+                accumulate(group, groupError, in[2]);
+                accumulate(group, groupError, in[3]);
+                if (groupError)
+                {
+                    break;
+                }
+
+                *out++ = gsl::narrow_cast<char>(group >> 16);
+                *out++ = gsl::narrow_cast<char>(group >> 8);
+                *out++ = gsl::narrow_cast<char>(group >> 0);
+            }
+
+            if (in == inEnd)
+            {
+                break;
+            }
+        }
+
+        const auto ch = *in++;
+        if (ch == '=')
+        {
+            _padding = true;
+            continue;
+        }
+        if (_padding)
+        {
+            error = 1;
+            break;
+        }
+
+        accumulate(r, error, ch);
+        if (error)
+        {
+            break;
+        }
+        if (++ri == 4)
+        {
+            *out++ = gsl::narrow_cast<char>(r >> 16);
+            *out++ = gsl::narrow_cast<char>(r >> 8);
+            *out++ = gsl::narrow_cast<char>(r >> 0);
+            r = 0;
+            ri = 0;
+        }
+    }
+
+    _result.resize(previousSize + (out - outBeg));
+    _r = r;
+    _ri = ri;
+
+    if (error)
+    {
+        _hr = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+    else if (_result.size() > _maxSize)
+    {
+        _hr = HRESULT_FROM_WIN32(ERROR_BUFFER_OVERFLOW);
+    }
+
+    if (FAILED(_hr))
+    {
+        // There's no point in holding on to any of it anymore.
+        _result = {};
+    }
+    return _hr;
+}
+
+// Decodes whatever is left over from the previous pieces and returns the result as UTF16 in dst.
+// See Append() for the errors this may return.
+HRESULT Base64::Decoder::Finish(std::wstring& dst) noexcept
+{
+    if (SUCCEEDED(_hr))
+    {
+        switch (_ri)
+        {
+        case 0:
+            break;
+        case 2:
+            _result.push_back(gsl::narrow_cast<char>(_r >> 4));
+            break;
+        case 3:
+            _result.push_back(gsl::narrow_cast<char>(_r >> 10));
+            _result.push_back(gsl::narrow_cast<char>(_r >> 2));
+            break;
+        default:
+            _hr = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+            break;
+        }
+    }
+
+    if (SUCCEEDED(_hr) && _result.size() > _maxSize)
+    {
+        _hr = HRESULT_FROM_WIN32(ERROR_BUFFER_OVERFLOW);
+    }
+
+    if (FAILED(_hr))
+    {
+        return _hr;
+    }
+    return til::u8u16(_result, dst);
+}
@@ -7,6 +7,7 @@ Module Name:
 
 Abstract:
 - This declares standard base64 encoding and decoding, with paddings when needed.
+- Decoder decodes base64 incrementally, for payloads that arrive in pieces.
 */
 
 #pragma once
@@ -17,5 +18,22 @@ namespace Microsoft::Console::VirtualTerminal
     {
     public:
         static HRESULT Decode(const std::wstring_view& src, std::wstring& dst) noexcept;
+
+        class Decoder
+        {
+        public:
+            explicit Decoder(const size_t maxSize) noexcept;
+
+            HRESULT Append(const std::wstring_view& src) noexcept;
+            HRESULT Finish(std::wstring& dst) noexcept;
+
+        private:
+            std::string _result;
+            size_t _maxSize;
+            uint_fast32_t _r = 0;
+            uint_fast8_t _ri = 0;
+            bool _padding = false;
+            HRESULT _hr = S_OK;
+        };
     };
 }
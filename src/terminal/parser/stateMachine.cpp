@@ -18,6 +18,7 @@ StateMachine::StateMachine(std::unique_ptr<IStateMachineEngine> engine, const bo
     _parameters{},
     _parameterLimitReached(false),
     _oscString{},
+    _oscStringStreamed(false),
     _cachedSequence{ std::nullopt },
     _processingIndividually(false)
 {
@@ -563,6 +564,8 @@ void StateMachine::_ActionClear()
 
     _oscString.clear();
     _oscParameter = 0;
+    _oscStringHandler = nullptr;
+    _oscStringStreamed = false;
 
     _dcsStringHandler = nullptr;
 
@@ -594,7 +597,8 @@ void StateMachine::_ActionInterrupt()
     if (_state == VTStates::DcsPassThrough)
     {
         // The ESC signals the end of the data string.
-        _dcsStringHandler(AsciiChars::ESC);
+        static constexpr wchar_t esc = AsciiChars::ESC;
+        _dcsStringHandler({ &esc, 1 });
         _dcsStringHandler = nullptr;
     }
 }
@@ -619,10 +623,51 @@ void StateMachine::_ActionOscParam(const wchar_t wch) noexcept
 // Return Value:
 // - <none>
 void StateMachine::_ActionOscPut(const wchar_t wch)
+{
+    _ActionOscPutString({ &wch, 1 });
+}
+
+// Routine Description:
+// - Triggers the OscPut action for a whole run of characters at once. If the
+//   engine asked for the OSC string to be streamed, the characters are handed
+//   to its string handler, instead of being collected.
+// Arguments:
+// - string - The characters to add to the OSC string.
+// Return Value:
+// - <none>
+void StateMachine::_ActionOscPutString(const std::wstring_view string)
 {
     _trace.TraceOnAction(L"OscPut");
 
-    _oscString.push_back(wch);
+    if (!_oscStringStreamed)
+    {
+        _oscString.append(string);
+    }
+    else if (_oscStringHandler && !_oscStringHandler(string))
+    {
+        // The handler doesn't want any more of the string, so the rest is ignored.
+        _oscStringHandler = nullptr;
+    }
+}
+
+// Routine Description:
+// - Triggers the OscStringStart action, which gives the engine the opportunity
+//   to process the OSC string while it arrives, instead of having it collected
+//   in full and passed to ActionOscDispatch at the end. That way large strings,
+//   like the base64 data of a clipboard request, don't need to be buffered.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void StateMachine::_ActionOscStringStart()
+{
+    _trace.TraceOnAction(L"OscStringStart");
+
+    _SafeExecute([=]() {
+        _oscStringHandler = _engine->ActionOscStringStart(_oscParameter);
+        return true;
+    });
+    _oscStringStreamed = _oscStringHandler != nullptr;
 }
 
 // Routine Description:
@@ -635,6 +680,21 @@ void StateMachine::_ActionOscPut(const wchar_t wch)
 void StateMachine::_ActionOscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"OscDispatch");
+
+    // A streamed string has already been handed to its handler in full, so
+    // all that's left to do is to let it know that the string has ended.
+    if (_oscStringStreamed)
+    {
+        if (_oscStringHandler)
+        {
+            static constexpr wchar_t esc = AsciiChars::ESC;
+            _oscStringHandler({ &esc, 1 });
+        }
+        _oscStringHandler = nullptr;
+        _oscStringStreamed = false;
+        _trace.DispatchSequenceTrace(true);
+        return;
+    }
     _trace.DispatchSequenceTrace(_SafeExecuteWithLog(wch, [=]() {
         return _engine->ActionOscDispatch(wch, _oscParameter, _oscString);
     }));
@@ -1310,7 +1370,7 @@ void StateMachine::_EventCsiParam(const wchar_t wch)
 // - wch - Character that triggered the event
 // Return Value:
 // - <none>
-void StateMachine::_EventOscParam(const wchar_t wch) noexcept
+void StateMachine::_EventOscParam(const wchar_t wch)
 {
     _trace.TraceOnEvent(L"OscParam");
     if (_isOscTerminator(wch))
@@ -1323,6 +1383,7 @@ void StateMachine::_EventOscParam(const wchar_t wch) noexcept
     }
     else if (_isOscDelimiter(wch))
     {
+        _ActionOscStringStart();
         _EnterOscString();
     }
     else
@@ -1663,7 +1724,7 @@ void StateMachine::_EventDcsPassThrough(const wchar_t wch)
     _trace.TraceOnEvent(L"DcsPassThrough");
     if (_isC0Code(wch) || _isDcsPassThroughValid(wch))
     {
-        if (!_dcsStringHandler(wch))
+        if (!_dcsStringHandler({ &wch, 1 }))
         {
             _EnterDcsIgnore();
         }
@@ -1821,6 +1882,72 @@ bool StateMachine::FlushToTerminal()
     return success;
 }
 
+// Routine Description:
+// - Consumes the leading data characters of a control string in bulk. In the
+//   OscString, DcsPassThrough, DcsIgnore, and SosPmApcString states, every
+//   character up to the next control character is either collected, passed
+//   through, or ignored without changing state. Handing those runs over in one
+//   go saves us a trip through the state machine (and in the case of DCS, a
+//   call to the string handler) for every single character of the payload.
+// Arguments:
+// - string - The remaining characters of the string being processed.
+// Return Value:
+// - The number of characters consumed. This will be 0 if we aren't in one of
+//   the string states, or if the first character needs to be processed
+//   individually, in which case ProcessCharacter should handle it.
+size_t StateMachine::_ProcessStringData(const std::wstring_view string)
+{
+    const auto runLength = [&](auto&& isData) noexcept {
+        const auto it = std::find_if_not(string.begin(), string.end(), isData);
+        return gsl::narrow_cast<size_t>(it - string.begin());
+    };
+    const auto isStringData = [](const wchar_t wch) noexcept {
+        return wch >= AsciiChars::SPC && !_isC1ControlCharacter(wch);
+    };
+
+    switch (_state)
+    {
+    case VTStates::OscString:
+    {
+        const auto length = runLength(isStringData);
+        if (length > 0)
+        {
+            _trace.TraceOnEvent(L"OscString");
+            _ActionOscPutString(string.substr(0, length));
+        }
+        return length;
+    }
+    case VTStates::DcsPassThrough:
+    {
+        const auto length = runLength(_isDcsPassThroughValid);
+        if (length > 0)
+        {
+            _trace.TraceOnEvent(L"DcsPassThrough");
+            // Handlers may want to know whether they've been given the last
+            // of the available data, so they can flush anything buffered.
+            _processingLastCharacter = length >= string.size();
+            if (!_dcsStringHandler(string.substr(0, length)))
+            {
+                _EnterDcsIgnore();
+            }
+        }
+        return length;
+    }
+    case VTStates::DcsIgnore:
+    case VTStates::SosPmApcString:
+    {
+        const auto length = runLength(isStringData);
+        if (length > 0)
+        {
+            _ActionIgnore();
+        }
+        return length;
+    }
+    default:
+        return 0;
+    }
+}
+
 // Routine Description:
 // - Helper for entry to the state machine. Will take an array of characters
 //     and print as many as it can without encountering a character indicating
@@ -1849,6 +1976,15 @@ void StateMachine::ProcessString(const std::wstring_view string)
 
         if (_processingIndividually)
         {
+            // The data of OSC, DCS, and other control strings doesn't need to go
+            // through the state machine one character at a time, so we try to
+            // consume as much of it as possible in one go first.
+            if (const auto consumed = _ProcessStringData(string.substr(current)))
+            {
+                current += consumed;
+                continue;
+            }
+
             // Note whether we're dealing with the last character in the buffer.
             _processingLastCharacter = (current + 1 >= string.size());
             // If we're processing characters individually, send it to the state machine.
@@ -1968,13 +2104,14 @@ void StateMachine::ProcessString(const std::wstring_view string)
             // after dispatching the characters
             _EnterGround();
         }
-        else if (_state != VTStates::SosPmApcString && _state != VTStates::DcsPassThrough && _state != VTStates::DcsIgnore)
+        else if (_state != VTStates::SosPmApcString && _state != VTStates::DcsPassThrough && _state != VTStates::DcsIgnore && !_oscStringStreamed)
         {
             // If the engine doesn't require flushing at the end of the string, we
             // want to cache the partial sequence in case we have to flush the whole
             // thing to the terminal later. There is no need to do this if we've
             // reached one of the string processing states, though, since that data
-            // will be dealt with as soon as it is received.
+            // will be dealt with as soon as it is received. The same goes for OSC
+            // strings that are being streamed to the engine.
             if (!_cachedSequence)
             {
                 _cachedSequence.emplace(std::wstring{});
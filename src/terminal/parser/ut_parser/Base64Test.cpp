@@ -116,4 +116,116 @@ class Microsoft::Console::VirtualTerminal::Base64Test
         Base64::Decode(L"8J+RjfCfkY3wn4+78J+RjfCfj7zwn5GN8J+PvfCfkY3wn4++8J+RjfCfj78=", result);
         VERIFY_ARE_EQUAL(L"👍👍🏻👍🏼👍🏽👍🏾👍🏿", result);
     }
+
+    TEST_METHOD(DecoderFuzz)
+    {
+        // NOTE: Modify testRounds to get the feeling of running a fuzz test on Base64::Decoder.
+        static constexpr auto testRounds = 64;
+        pcg_engines::oneseq_dxsm_64_32 rng{ til::gen_random<uint64_t>() };
+
+        std::string reference;
+        std::wstring encoded;
+        std::wstring decoded;
+
+        for (auto i = 0; i < testRounds; ++i)
+        {
+            // Long enough for the vectorized code paths, with a tail that isn't.
+            reference.resize(rng(300));
+            for (auto& ch : reference)
+            {
+                ch = static_cast<char>(rng(0x80));
+            }
+
+            if (reference.empty())
+            {
+                encoded.clear();
+            }
+            else
+            {
+                const auto data = reinterpret_cast<const BYTE*>(reference.data());
+                const auto length = gsl::narrow_cast<DWORD>(reference.size());
+                DWORD encodedLen;
+                THROW_IF_WIN32_BOOL_FALSE(CryptBinaryToStringW(data, length, CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF, nullptr, &encodedLen));
+                encoded.resize(encodedLen - 1);
+                THROW_IF_WIN32_BOOL_FALSE(CryptBinaryToStringW(data, length, CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF, encoded.data(), &encodedLen));
+            }
+
+            if (rng(2))
+            {
+                while (!encoded.empty() && encoded.back() == '=')
+                {
+                    encoded.pop_back();
+                }
+            }
+
+            // Feed the encoded string to the decoder in pieces of random length.
+            Base64::Decoder decoder{ reference.size() };
+            const std::wstring_view remaining{ encoded };
+            for (size_t offset = 0; offset < remaining.size();)
+            {
+                const auto piece = remaining.substr(offset, rng(40));
+                VERIFY_SUCCEEDED(decoder.Append(piece));
+                offset += piece.size();
+            }
+            VERIFY_SUCCEEDED(decoder.Finish(decoded));
+            VERIFY_ARE_EQUAL(std::wstring(reference.begin(), reference.end()), decoded);
+        }
+    }
+
+    TEST_METHOD(DecoderRejectsInvalidData)
+    {
+        std::wstring result;
+
+        {
+            Base64::Decoder decoder{ 100 };
+            VERIFY_SUCCEEDED(decoder.Append(L"Zm9vYmFy"));
+            VERIFY_FAILED(decoder.Append(L"Zm9v?mFy"));
+            // Once failed, the decoder stays failed.
+            VERIFY_FAILED(decoder.Append(L"Zm9v"));
+            VERIFY_FAILED(decoder.Finish(result));
+        }
+        {
+            // Characters outside of ASCII are invalid, even in the vectorized code path.
+            Base64::Decoder decoder{ 100 };
+            VERIFY_FAILED(decoder.Append(L"Zm9vYmFyZm9vYmFy\u0141m9vYmFyZm9vYmFy"));
+        }
+        {
+            // Padding is only allowed at the end.
+            Base64::Decoder decoder{ 100 };
+            VERIFY_SUCCEEDED(decoder.Append(L"YQ=="));
+            VERIFY_FAILED(decoder.Append(L"YQ=="));
+        }
+        {
+            // A single character left over at the end can't be decoded.
+            Base64::Decoder decoder{ 100 };
+            VERIFY_SUCCEEDED(decoder.Append(L"Zm9vY"));
+            VERIFY_FAILED(decoder.Finish(result));
+        }
+    }
+
+    TEST_METHOD(DecoderSizeLimit)
+    {
+        std::wstring result;
+
+        {
+            Base64::Decoder decoder{ 8 };
+            VERIFY_SUCCEEDED(decoder.Append(L"Zm9vYm"));
+            VERIFY_SUCCEEDED(decoder.Append(L"FyYmE="));
+            VERIFY_SUCCEEDED(decoder.Finish(result));
+            VERIFY_ARE_EQUAL(L"foobarba", result);
+        }
+        {
+            // The limit is enforced as soon as it's exceeded, not just at the end.
+            Base64::Decoder decoder{ 8 };
+            VERIFY_SUCCEEDED(decoder.Append(L"Zm9vYm"));
+            VERIFY_ARE_EQUAL(HRESULT_FROM_WIN32(ERROR_BUFFER_OVERFLOW), decoder.Append(L"FyYmF6"));
+            VERIFY_ARE_EQUAL(HRESULT_FROM_WIN32(ERROR_BUFFER_OVERFLOW), decoder.Finish(result));
+        }
+        {
+            // Including for the trailing bytes that are only decoded at the end.
+            Base64::Decoder decoder{ 7 };
+            VERIFY_SUCCEEDED(decoder.Append(L"Zm9vYmFyYmE"));
+            VERIFY_ARE_EQUAL(HRESULT_FROM_WIN32(ERROR_BUFFER_OVERFLOW), decoder.Finish(result));
+        }
+    }
 };
@@ -327,6 +327,7 @@ public:
                                     const VTParameter parameter1,
                                     const VTParameter parameter2) override; // DTTERM_WindowManipulation
     virtual bool WriteString(const std::wstring_view string) override;
+    virtual bool WriteVtInput(const std::wstring_view string) override;
 
     virtual bool MoveCursor(const VTInt row,
                             const VTInt col) override;
@@ -389,6 +390,18 @@ bool TestInteractDispatch::WriteString(const std::wstring_view string)
     return WriteInput(keyEvents);
 }
 
+bool TestInteractDispatch::WriteVtInput(const std::wstring_view string)
+{
+    std::deque<std::unique_ptr<IInputEvent>> keyEvents;
+
+    for (const auto& wch : string)
+    {
+        keyEvents.push_back(std::make_unique<KeyEvent>(true, 1ui16, 0ui16, 0ui16, wch, 0));
+    }
+
+    return WriteInput(keyEvents);
+}
+
 bool TestInteractDispatch::MoveCursor(const VTInt row, const VTInt col)
 {
     VERIFY_IS_TRUE(_testState->_expectCursorPosition);
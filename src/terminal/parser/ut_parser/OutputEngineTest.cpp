@@ -3014,6 +3014,88 @@ class StateMachineExternalTest final
         pDispatch->ClearState();
     }
 
+    TEST_METHOD(TestSetClipboardSplitAcrossWrites)
+    {
+        auto dispatch = std::make_unique<StatefulDispatch>();
+        auto pDispatch = dispatch.get();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        auto pEngine = engine.get();
+        StateMachine mach(std::move(engine));
+
+        // The content is decoded as it arrives, even if a write ends in the middle of a base64 group.
+        mach.ProcessString(L"\x1b]52;s");
+        mach.ProcessString(L"0;Zm9vDQ");
+        mach.ProcessString(L"piYX");
+        mach.ProcessString(L"I=\x1b");
+        mach.ProcessString(L"\\");
+        VERIFY_ARE_EQUAL(L"foo\r\nbar", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+
+        // Content of exactly the maximum size is accepted.
+        pEngine->SetClipboardSizeLimit(6);
+        mach.ProcessString(L"\x1b]52;;Zm9v");
+        mach.ProcessString(L"YmFy\x07");
+        VERIFY_ARE_EQUAL(L"foobar", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+
+        pDispatch->_copyContent = L"UNCHANGED";
+        // Content that exceeds the maximum size is rejected, and the rest of it ignored.
+        mach.ProcessString(L"\x1b]52;;Zm9v");
+        mach.ProcessString(L"YmFyYmF6");
+        mach.ProcessString(L"Zm9v\x07");
+        VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+
+        pDispatch->_copyContent = L"UNCHANGED";
+        // A sequence that's cancelled before it's terminated doesn't change the content.
+        mach.ProcessString(L"\x1b]52;;Zm9v\x18");
+        VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+
+        pDispatch->ClearState();
+    }
+
+    TEST_METHOD(TestSetClipboardClearsLastCharOnEveryPath)
+    {
+        auto dispatch = std::make_unique<StatefulDispatch>();
+        auto pDispatch = dispatch.get();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        auto pEngine = engine.get();
+        StateMachine mach(std::move(engine));
+
+        Log::Comment(L"A clipboard query is ignored, but REP must not repeat the character printed before it.");
+        pDispatch->_copyContent = L"UNCHANGED";
+        mach.ProcessString(L"A");
+        mach.ProcessString(L"\x1b]52;;?");
+        mach.ProcessString(L"\x1b\\");
+        mach.ProcessString(L"\x1b[3b");
+        VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+        VERIFY_ARE_EQUAL(L"A", pDispatch->_printString);
+
+        pDispatch->ClearState();
+
+        Log::Comment(L"Neither may REP after content that exceeds the maximum size.");
+        pEngine->SetClipboardSizeLimit(3);
+        pDispatch->_copyContent = L"UNCHANGED";
+        mach.ProcessString(L"B");
+        mach.ProcessString(L"\x1b]52;;Zm9v");
+        mach.ProcessString(L"YmFy");
+        mach.ProcessString(L"\x07\x1b[3b");
+        VERIFY_ARE_EQUAL(L"UNCHANGED", pDispatch->_copyContent);
+        VERIFY_ARE_EQUAL(L"B", pDispatch->_printString);
+
+        pDispatch->ClearState();
+
+        Log::Comment(L"REP after a successful request doesn't repeat anything either.");
+        mach.ProcessString(L"C\x1b]52;;Zm9v\x07\x1b[3b");
+        VERIFY_ARE_EQUAL(L"foo", pDispatch->_copyContent);
+        VERIFY_ARE_EQUAL(L"C", pDispatch->_printString);
+
+        pDispatch->ClearState();
+    }
+
     TEST_METHOD(TestAddHyperlink)
     {
         auto dispatch = std::make_unique<StatefulDispatch>();
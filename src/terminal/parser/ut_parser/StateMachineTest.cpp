@@ -38,6 +38,8 @@ public:
         dcsId = 0;
         dcsParams.clear();
         dcsDataString.clear();
+        dcsChunkCount = 0;
+        oscString.clear();
     }
 
     bool ActionExecute(const wchar_t wch) override
@@ -70,8 +72,9 @@ public:
 
     bool ActionOscDispatch(const wchar_t /* wch */,
                            const size_t /* parameter */,
-                           const std::wstring_view /* string */) override
+                           const std::wstring_view string) override
     {
+        oscString = string;
         if (pfnFlushToTerminal)
         {
             pfnFlushToTerminal();
@@ -80,6 +83,8 @@ public:
         return true;
     };
 
+    IStateMachineEngine::StringHandler ActionOscStringStart(const size_t /* parameter */) override { return nullptr; };
+
     bool ActionSs3Dispatch(const wchar_t /* wch */, const VTParameters /* parameters */) override { return true; };
 
     // ActionCsiDispatch is the only method that's actually implemented.
@@ -110,7 +115,8 @@ public:
             dcsParams.push_back(parameters.at(i).value_or(0));
         }
         dcsDataString.clear();
-        return [=](const auto ch) { dcsDataString += ch; return true; };
+        dcsChunkCount = 0;
+        return [=](const auto str) { dcsDataString += str; dcsChunkCount++; return true; };
     }
 
     // These will only be populated if ActionCsiDispatch is called.
@@ -133,6 +139,10 @@ public:
     uint64_t dcsId = 0;
     std::vector<size_t> dcsParams;
     std::wstring dcsDataString;
+    size_t dcsChunkCount = 0;
+
+    // This will only be populated if ActionOscDispatch is called.
+    std::wstring oscString;
 };
 
 class Microsoft::Console::VirtualTerminal::StateMachineTest
@@ -157,6 +167,7 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
 
     TEST_METHOD(DcsDataStringsReceivedByHandler);
+    TEST_METHOD(StringDataReceivedInChunks);
 };
 
 void StateMachineTest::TwoStateMachinesDoNotInterfereWithEachOther()
@@ -337,3 +348,34 @@ void StateMachineTest::DcsDataStringsReceivedByHandler()
     // Verify the control characters were executed (if expected).
     VERIFY_ARE_EQUAL(expectedExecuted, engine.executed);
 }
+
+void StateMachineTest::StringDataReceivedInChunks()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    Log::Comment(L"DCS data is passed to the handler a run at a time, split on writes and control characters");
+    machine.ProcessString(L"\033P1|abc");
+    machine.ProcessString(L"def\r\nghi");
+    machine.ProcessString(L"\033\\");
+    VERIFY_ARE_EQUAL(L"abcdef\r\nghi\033", engine.dcsDataString);
+    // "abc", "def", "\r", "\n", "ghi", and the terminating ESC.
+    VERIFY_ARE_EQUAL(6u, engine.dcsChunkCount);
+
+    Log::Comment(L"Characters that aren't valid in a DCS data string are dropped");
+    machine.ProcessString(L"\033P1|ab\x7f" L"\x00e9" L"cd\033\\");
+    VERIFY_ARE_EQUAL(L"abcd\033", engine.dcsDataString);
+
+    Log::Comment(L"OSC data is collected across writes, with invalid controls ignored");
+    machine.ProcessString(L"\033]52;c;QUJD");
+    machine.ProcessString(L"RE\x01VG");
+    machine.ProcessString(L"\033\\");
+    VERIFY_ARE_EQUAL(L"c;QUJDREVG", engine.oscString);
+
+    Log::Comment(L"Text following the strings is still printed");
+    machine.ProcessString(L"\033]2;title\007printed text");
+    VERIFY_ARE_EQUAL(L"title", engine.oscString);
+    VERIFY_ARE_EQUAL(L"printed text", engine.printed);
+}
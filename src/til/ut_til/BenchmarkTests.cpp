@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "til/bitmap.h"
+#include "til/rle.h"
+
+#include <random>
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+// These aren't tests, but measure the typical ways the buffer and the renderers use the til
+// containers, with the sizes they commonly have. The results are only logged and the class is
+// ignored by default. Run it with: te til.unit.tests.dll /select:@IsPerfTest=true /runIgnoredTests
+class BenchmarkTests
+{
+    BEGIN_TEST_CLASS(BenchmarkTests)
+        TEST_CLASS_PROPERTY(L"IsPerfTest", L"true")
+        TEST_CLASS_PROPERTY(L"Ignore", L"true")
+    END_TEST_CLASS()
+
+    // Runs func, which returns the number of operations it performed, and logs the time per operation.
+    template<typename Func>
+    static void _measure(const wchar_t* name, Func&& func)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const size_t operations = func();
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        Log::Comment(NoThrowString().Format(L"%-40s %8.1f ns/op", name, elapsed / operations));
+    }
+
+    // The ways ROW modifies its attributes, using the same type and a common row width.
+    TEST_METHOD(RunLengthEncodingReplace)
+    {
+        using row_rle = til::small_rle<uint32_t, uint16_t, 1>;
+        static constexpr uint16_t width = 120;
+
+        std::mt19937 rng{ 42 };
+
+        // Every cell or two get a random color, like lolcat or a heat map.
+        _measure(L"short ranges, random colors", [&]() {
+            row_rle rle(width, 0);
+            size_t operations = 0;
+            for (; operations < 200000; ++operations)
+            {
+                const auto beg = static_cast<uint16_t>(rng() % width);
+                const auto end = std::min<uint16_t>(width, static_cast<uint16_t>(beg + 1 + rng() % 2));
+                rle.replace(beg, end, static_cast<uint16_t>(rng() % 256));
+            }
+            return operations;
+        });
+
+        // Text is written at the cursor, which moves left to right, followed by an erase
+        // to the end of the line, like a shell prompt or syntax highlighted output would do.
+        _measure(L"writes at the cursor, erase to the end", [&]() {
+            row_rle rle(width, 0);
+            size_t operations = 0;
+            while (operations < 200000)
+            {
+                for (uint16_t x = 0; x < width; x += 4)
+                {
+                    const auto end = static_cast<uint16_t>(x + 4);
+                    rle.replace(x, end, static_cast<uint16_t>(rng() % 8));
+                    ++operations;
+
+                    // There's nothing left to erase once the cursor reached the end of the row.
+                    if (end < width)
+                    {
+                        rle.replace(end, width, 0);
+                        ++operations;
+                    }
+                }
+            }
+            return operations;
+        });
+
+        // Wide ranges of a handful of colors, like selections or search highlights.
+        _measure(L"wide ranges, few colors", [&]() {
+            row_rle rle(width, 0);
+            size_t operations = 0;
+            for (; operations < 200000; ++operations)
+            {
+                const auto a = static_cast<uint16_t>(rng() % width);
+                const auto b = static_cast<uint16_t>(rng() % width);
+                rle.replace(std::min(a, b), std::max(a, b), static_cast<uint16_t>(rng() % 4));
+            }
+            return operations;
+        });
+
+        // Random lookups in a row where every cell has a different color.
+        _measure(L"at() with one run per cell", [&]() {
+            row_rle rle(width, 0);
+            for (uint16_t x = 0; x < width; ++x)
+            {
+                rle.replace(x, static_cast<uint16_t>(x + 1), x);
+            }
+            size_t operations = 0;
+            size_t sum = 0;
+            for (; operations < 200000; ++operations)
+            {
+                sum += rle.at(static_cast<uint16_t>(rng() % width));
+            }
+            VERIFY_ARE_NOT_EQUAL(0u, sum);
+            return operations;
+        });
+    }
+
+    // A typical viewport, invalidated the way the renderers usually see it.
+    TEST_METHOD(BitmapRuns)
+    {
+        const til::size sz{ 120, 30 };
+
+        std::mt19937 rng{ 42 };
+
+        // Everything is dirty after a resize or a clear screen.
+        _measure(L"full invalidation", [&]() {
+            til::bitmap map{ sz };
+            size_t operations = 0;
+            for (; operations < 20000; ++operations)
+            {
+                map.set_all();
+                (void)map.runs();
+            }
+            return operations;
+        });
+
+        // Text being written at the cursor dirties a single line at a time.
+        _measure(L"cursor line", [&]() {
+            til::bitmap map{ sz };
+            size_t operations = 0;
+            for (; operations < 20000; ++operations)
+            {
+                const auto y = static_cast<til::CoordType>(operations % 30);
+                map.reset_all();
+                map.set(til::rect{ 0, y, 120, y + 1 });
+                (void)map.runs();
+            }
+            return operations;
+        });
+
+        // Things like a blinking cursor or a progress indicator dirty a few scattered cells.
+        _measure(L"scattered cells", [&]() {
+            til::bitmap map{ sz };
+            size_t operations = 0;
+            for (; operations < 20000; ++operations)
+            {
+                map.reset_all();
+                for (auto i = 0; i < 32; ++i)
+                {
+                    map.set(til::point{ static_cast<til::CoordType>(rng() % 120), static_cast<til::CoordType>(rng() % 30) });
+                }
+                (void)map.runs();
+            }
+            return operations;
+        });
+
+        // Scrolling moves the existing invalidation and fills in the uncovered line.
+        _measure(L"scroll by one line", [&]() {
+            til::bitmap map{ sz };
+            size_t operations = 0;
+            for (; operations < 20000; ++operations)
+            {
+                map.translate(til::point{ 0, -1 }, true);
+            }
+            return operations;
+        });
+
+        _measure(L"diagonal translation", [&]() {
+            til::bitmap map{ sz };
+            size_t operations = 0;
+            for (; operations < 20000; ++operations)
+            {
+                map.set(til::point{ 5, 5 });
+                map.translate(til::point{ 1, -1 }, true);
+            }
+            return operations;
+        });
+    }
+};
@@ -32,7 +32,7 @@ class BitmapTests
             const auto expected = std::any_of(bitsOn.cbegin(), bitsOn.cend(), [&pt](auto bitRect) { return bitRect.contains(pt); });
 
             // Get the actual bit out of the map.
-            const auto actual = map._bits[map._rc.index_of(pt)];
+            const auto actual = map._test(pt);
 
             // Do it this way and not with equality so you can see it in output.
             if (expected)
@@ -57,7 +57,7 @@ class BitmapTests
 
         // The find will go from begin to end in the bits looking for a "true".
         // It should miss so the result should be "cend" and turn out true here.
-        VERIFY_IS_TRUE(bitmap._bits.none());
+        VERIFY_IS_TRUE(bitmap.none());
     }
 
     TEST_METHOD(SizeConstruct)
@@ -67,11 +67,12 @@ class BitmapTests
         const til::bitmap bitmap{ expectedSize };
         VERIFY_ARE_EQUAL(expectedSize, bitmap._sz);
         VERIFY_ARE_EQUAL(expectedRect, bitmap._rc);
-        VERIFY_ARE_EQUAL(50u, bitmap._bits.size());
+        // Every row starts on a new word, so 10 rows of 5 bits take 10 words.
+        VERIFY_ARE_EQUAL(10u, bitmap._bits.size());
 
         // The find will go from begin to end in the bits looking for a "true".
         // It should miss so the result should be "cend" and turn out true here.
-        VERIFY_IS_TRUE(bitmap._bits.none());
+        VERIFY_IS_TRUE(bitmap.none());
     }
 
     TEST_METHOD(SizeConstructWithFill)
@@ -88,15 +89,16 @@ class BitmapTests
         const til::bitmap bitmap{ expectedSize, fill };
         VERIFY_ARE_EQUAL(expectedSize, bitmap._sz);
         VERIFY_ARE_EQUAL(expectedRect, bitmap._rc);
-        VERIFY_ARE_EQUAL(50u, bitmap._bits.size());
+        // Every row starts on a new word, so 10 rows of 5 bits take 10 words.
+        VERIFY_ARE_EQUAL(10u, bitmap._bits.size());
 
         if (!fill)
         {
-            VERIFY_IS_TRUE(bitmap._bits.none());
+            VERIFY_IS_TRUE(bitmap.none());
         }
         else
         {
-            VERIFY_IS_TRUE(bitmap._bits.all());
+            VERIFY_IS_TRUE(bitmap.all());
         }
     }
 
@@ -587,7 +589,7 @@ class BitmapTests
 
         // Every bit should be false.
         Log::Comment(L"All bits false on creation.");
-        VERIFY_IS_TRUE(bitmap._bits.none());
+        VERIFY_IS_TRUE(bitmap.none());
 
         const til::point point{ 2, 2 };
         bitmap.set(point);
@@ -1099,4 +1101,45 @@ class BitmapTests
         }
         VERIFY_ARE_EQUAL(expected, actual);
     }
+
+    TEST_METHOD(RunsAcrossWords)
+    {
+        // Rows wider than 64 bits span multiple words. Runs and translations
+        // need to carry across word boundaries, but never across rows.
+        til::bitmap map{ til::size{ 130, 3 } };
+        map.set(til::rect{ 60, 0, 70, 1 });
+
+        const auto verifyRuns = [&](const std::vector<til::rect>& expected) {
+            const auto actual = map.runs();
+            VERIFY_ARE_EQUAL(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                VERIFY_ARE_EQUAL(expected[i], actual[i]);
+            }
+            _checkBits(expected, map);
+        };
+
+        verifyRuns({ til::rect{ 60, 0, 70, 1 } });
+
+        Log::Comment(L"Translate right, so that the run gets clipped by the right edge.");
+        map.translate(til::point{ 65, 1 });
+        verifyRuns({ til::rect{ 125, 1, 130, 2 } });
+
+        Log::Comment(L"Translate left with fill, which uncovers the right side of every row.");
+        map.translate(til::point{ -100, 0 }, true);
+        verifyRuns({
+            til::rect{ 30, 0, 130, 1 },
+            til::rect{ 25, 1, 130, 2 },
+            til::rect{ 30, 2, 130, 3 },
+        });
+        VERIFY_IS_FALSE(map.all());
+
+        Log::Comment(L"Translate down with fill, which uncovers the first row.");
+        map.translate(til::point{ 0, 1 }, true);
+        verifyRuns({
+            til::rect{ 0, 0, 130, 1 },
+            til::rect{ 30, 1, 130, 2 },
+            til::rect{ 25, 2, 130, 3 },
+        });
+    }
 };
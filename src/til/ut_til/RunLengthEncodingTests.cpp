@@ -6,6 +6,8 @@
 #include "til/rle.h"
 #include "consoletaeftemplates.hpp"
 
+#include <random>
+
 using namespace std::literals;
 using namespace WEX::Common;
 using namespace WEX::Logging;
@@ -601,4 +603,42 @@ class RunLengthEncodingTests
             VERIFY_ARE_EQUAL(-static_cast<difference_type>(1), lower - upper);
         }
     }
+
+    TEST_METHOD(ReplaceRandomized)
+    {
+        // Runs are looked up from whichever end of the vector is closer to the replaced range.
+        // Random replacements, slices and lookups ensure that both directions agree with a plain string.
+        std::mt19937 rng{ 42 };
+
+        for (auto iteration = 0; iteration < 1000; ++iteration)
+        {
+            const auto width = static_cast<size_type>(1 + rng() % 40);
+            rle_vector actual(width, 0);
+            basic_container expected(width, 0);
+
+            for (auto i = 0; i < 20; ++i)
+            {
+                const auto a = static_cast<size_type>(rng() % width);
+                const auto b = static_cast<size_type>(rng() % width + 1);
+                const auto start_index = std::min(a, b);
+                const auto end_index = std::max(std::max(a, b), static_cast<size_type>(start_index + 1));
+                const auto value = static_cast<value_type>(rng() % 4);
+
+                actual.replace(start_index, end_index, value);
+                std::fill(expected.begin() + start_index, expected.begin() + end_index, value);
+            }
+
+            VERIFY_ARE_EQUAL(rle_vector{ rle_encode(expected) }, actual);
+
+            const auto a = static_cast<size_type>(rng() % width);
+            const auto b = static_cast<size_type>(rng() % width + 1);
+            const auto slice = actual.slice(std::min(a, b), std::max(a, b));
+            VERIFY_ARE_EQUAL(rle_vector{ rle_encode(basic_container_view{ expected }.substr(std::min(a, b), std::max(a, b) - std::min(a, b))) }, slice);
+
+            for (size_type i = 0; i < width; ++i)
+            {
+                VERIFY_ARE_EQUAL(expected[i], actual.at(i));
+            }
+        }
+    }
 };
@@ -0,0 +1,185 @@
+// TEST TOOL ConsoleBench
+// Throughput tests for the console host. ConsoleBench acts as a synthetic console
+// client: it hammers a console API with a known workload and reports how fast the
+// host (and, under ConPTY, the connected terminal) is able to keep up.
+//
+// Usage: ConsoleBench.exe [scenario...] [-m megabytes]
+//   Runs all scenarios if none is given. Run it inside the console configuration
+//   under test, for instance inside Windows Terminal to measure the ConPTY path.
+
+#define NOMINMAX
+#include <Windows.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        size_t megabytes = 64;
+    };
+
+    struct Result
+    {
+        size_t bytes = 0;
+        size_t calls = 0;
+        double seconds = 0;
+    };
+
+    using Scenario = Result (*)(const Options& options);
+
+    // A rough imitation of the output of `git log --graph --color`: short lines
+    // with a handful of SGR sequences each. That's the sort of output for which
+    // the per-call overhead of the host matters most.
+    std::string makeColoredText(const size_t minimumSize)
+    {
+        static constexpr std::string_view colors[]{ "31", "32", "33", "34", "35", "36" };
+        std::string text;
+        text.reserve(minimumSize + 256);
+
+        for (size_t line = 0; text.size() < minimumSize; ++line)
+        {
+            const auto color = colors[line % std::size(colors)];
+            text.append("\x1b[");
+            text.append(color);
+            text.append("m* \x1b[33mcommit ");
+            for (auto i = 0; i < 40; ++i)
+            {
+                text.push_back("0123456789abcdef"[(line * 7 + i * 13) % 16]);
+            }
+            text.append("\x1b[m (\x1b[1;36mHEAD\x1b[m) Fix the thing that broke the other thing\r\n");
+        }
+
+        return text;
+    }
+
+    template<typename Func>
+    double measure(Func&& func)
+    {
+        const auto beg = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(end - beg).count();
+    }
+
+    // Writes a large amount of colored UTF-8 text with VT processing enabled, in chunks
+    // of the size that a typical CLI application's stdout buffer would flush.
+    Result vtOutput(const Options& options)
+    {
+        static constexpr size_t chunkSize = 4096;
+
+        const auto out = GetStdHandle(STD_OUTPUT_HANDLE);
+        const auto text = makeColoredText(1024 * 1024);
+        const auto total = options.megabytes * 1024 * 1024;
+        Result result;
+
+        DWORD mode = 0;
+        GetConsoleMode(out, &mode);
+        SetConsoleMode(out, mode | ENABLE_PROCESSED_OUTPUT | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+        SetConsoleOutputCP(CP_UTF8);
+
+        result.seconds = measure([&]() {
+            size_t offset = 0;
+            while (result.bytes < total)
+            {
+                const auto count = std::min(chunkSize, text.size() - offset);
+                DWORD written = 0;
+                if (!WriteConsoleA(out, text.data() + offset, static_cast<DWORD>(count), &written, nullptr))
+                {
+                    break;
+                }
+                result.bytes += written;
+                result.calls++;
+                offset = (offset + written) % text.size();
+            }
+        });
+
+        WriteConsoleA(out, "\x1b[m\r\n", 5, nullptr, nullptr);
+        SetConsoleMode(out, mode);
+        return result;
+    }
+
+    struct ScenarioInfo
+    {
+        const char* name;
+        const char* description;
+        Scenario func;
+    };
+
+    constexpr ScenarioInfo scenarios[]{
+        { "vt-output", "WriteConsoleA of colored UTF-8 text in 4 KiB chunks", vtOutput },
+    };
+
+    void printResult(const ScenarioInfo& scenario, const Result& result)
+    {
+        const auto mb = static_cast<double>(result.bytes) / (1024.0 * 1024.0);
+        const auto us = result.calls ? result.seconds * 1e6 / static_cast<double>(result.calls) : 0.0;
+        fprintf(stderr, "%-16s %10.2f MB %10zu calls %10.3f s %10.2f MB/s %10.2f us/call\n", scenario.name, mb, result.calls, result.seconds, mb / result.seconds, us);
+    }
+
+    void printUsage()
+    {
+        fprintf(stderr, "usage: ConsoleBench [scenario...] [-m megabytes]\n\nscenarios:\n");
+        for (const auto& scenario : scenarios)
+        {
+            fprintf(stderr, "  %-16s %s\n", scenario.name, scenario.description);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    std::vector<const ScenarioInfo*> selected;
+
+    for (auto i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{ argv[i] };
+
+        if (arg == "-m" && i + 1 < argc)
+        {
+            options.megabytes = std::max<size_t>(1, strtoul(argv[++i], nullptr, 10));
+            continue;
+        }
+
+        const ScenarioInfo* match = nullptr;
+        for (const auto& scenario : scenarios)
+        {
+            if (arg == scenario.name)
+            {
+                match = &scenario;
+            }
+        }
+
+        if (!match)
+        {
+            printUsage();
+            return 1;
+        }
+
+        selected.emplace_back(match);
+    }
+
+    if (selected.empty())
+    {
+        for (const auto& scenario : scenarios)
+        {
+            selected.emplace_back(&scenario);
+        }
+    }
+
+    // The results go to stderr, so that stdout can be redirected
+    // to compare the throughput of a console against that of a file.
+    for (const auto scenario : selected)
+    {
+        printResult(*scenario, scenario->func(options));
+    }
+
+    return 0;
+}
@@ -12,6 +12,7 @@
 #include <sstream>
 
 #include "U8U16Test.hpp"
+#include "../../types/inc/GlyphWidth.hpp"
 
 typedef NTSTATUS(WINAPI* t_RtlUTF8ToUnicodeN)(PWSTR, ULONG, PULONG, PCCH, ULONG);
 typedef NTSTATUS(WINAPI* t_RtlUnicodeToUTF8N)(PCHAR, ULONG, PULONG, PCWSTR, ULONG);
@@ -442,6 +443,47 @@ void CompNaturalLang_Chunks(const std::string& fileName)
     std::cout << " u16u8_ptr           length " << lenTotalU16U8 << " elapsed " << durTotalU16U8 << std::endl;
 }
 
+void GlyphWidths_NaturalLang(const std::string& fileName)
+{
+    std::string head{ __func__ };
+    head += " - " + fileName;
+    PrintHeader(head.c_str());
+
+    std::ostringstream u8Ss{};
+    std::ostringstream buf{};
+    buf << std::ifstream{ fileName }.rdbuf();
+    std::fill_n(std::ostream_iterator<const char*>{ u8Ss }, 30000u, buf.str().c_str());
+    std::wstring u16Str{};
+    if (FAILED(u8u16_ptr(u8Ss.str(), u16Str)))
+    {
+        return;
+    }
+
+    // glyph by glyph, the way OutputCellIterator measures text
+    GetDuration();
+    size_t columns{};
+    for (size_t idx = 0u; idx < u16Str.length();)
+    {
+        const size_t len = IS_HIGH_SURROGATE(u16Str[idx]) && idx + 1 < u16Str.length() ? 2u : 1u;
+        columns += IsGlyphFullWidth(std::wstring_view{ u16Str.data() + idx, len }) ? 2u : 1u;
+        idx += len;
+    }
+    double duration = GetDuration();
+    std::cout << " IsGlyphFullWidth    columns " << columns << " elapsed " << duration << std::endl;
+
+    // line by line, skipping the glyph by glyph measurement for lines that are entirely narrow
+    GetDuration();
+    size_t narrowLines{};
+    for (size_t idx = 0u; idx < u16Str.length();)
+    {
+        const auto eol = std::min(u16Str.find(L'\n', idx), u16Str.length());
+        narrowLines += IsNarrowRun(std::wstring_view{ u16Str.data() + idx, eol - idx }) ? 1u : 0u;
+        idx = eol + 1;
+    }
+    duration = GetDuration();
+    std::cout << " IsNarrowRun         lines   " << narrowLines << " elapsed " << duration << std::endl;
+}
+
 int main()
 {
     // UTF-16 string length
@@ -519,6 +561,12 @@ int main()
     CompNaturalLang_Chunks("ru.txt");
     CompNaturalLang_Chunks("zh.txt");
 
+    std::cout << "\n\n### Glyph Widths ###" << std::endl;
+
+    GlyphWidths_NaturalLang("en.txt");
+    GlyphWidths_NaturalLang("ru.txt");
+    GlyphWidths_NaturalLang("zh.txt");
+
     FreeLibrary(ntdll);
     return 0;
 }
@@ -25,6 +25,15 @@ bool IsGlyphFullWidth(const wchar_t wch) noexcept
     return wch < 0x80 ? false : IsGlyphFullWidth({ &wch, 1 });
 }
 
+// Function Description:
+// - determines if all characters of the given text are narrow, which allows
+//      callers to skip measuring it glyph by glyph.
+//      See CodepointWidthDetector::IsNarrowRun
+bool IsNarrowRun(const std::wstring_view& text) noexcept
+{
+    return CodepointWidthDetector::IsNarrowRun(text);
+}
+
 // Function Description:
 // - Sets a function that should be used by the global CodepointWidthDetector
 //      as the fallback mechanism for determining a particular glyph's width,
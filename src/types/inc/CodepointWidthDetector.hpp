@@ -21,6 +21,7 @@ class CodepointWidthDetector final
 public:
     CodepointWidth GetWidth(const std::wstring_view& glyph) noexcept;
     bool IsWide(const std::wstring_view& glyph) noexcept;
+    static bool IsNarrowRun(const std::wstring_view& text) noexcept;
     void SetFallbackMethod(std::function<bool(const std::wstring_view&)> pfnFallback) noexcept;
     void NotifyFontChanged() noexcept;
 
@@ -17,5 +17,6 @@ Abstract:
 
 bool IsGlyphFullWidth(const std::wstring_view& glyph) noexcept;
 bool IsGlyphFullWidth(const wchar_t wch) noexcept;
+bool IsNarrowRun(const std::wstring_view& text) noexcept;
 void SetGlyphWidthFallback(std::function<bool(const std::wstring_view&)> pfnFallback) noexcept;
 void NotifyGlyphWidthFontChanged() noexcept;
@@ -7,7 +7,10 @@
 ################################################################################
 # This script generates the an array suitable for replacing the body of
 # src/types/CodepointWidthDetector.cpp from a Unicode UCD XML document[1]
-# compliant with UAX#42[2].
+# compliant with UAX#42[2]. It's followed by the same data as a two-level
+# lookup table, which is what CodepointWidthDetector uses for its lookups.
+# The table is emitted as literal data, because computing it at compile time
+# exceeds the constexpr evaluation limits of our compilers.
 #
 # This script supports a quasi-mandatory "overrides" file, overrides.xml.
 # If you do not have overrides, supply the -NoOverrides parameter. This was
@@ -274,3 +277,55 @@ ForEach($_ in $ranges) {
 "        UnicodeRange{{ 0x{0:x}, 0x{1:x}, {2} }},{3}" -f $_.Start, $_.End, [int]$isAmbiguous, $comment
 }
 "    };"
+
+# Two-level lookup table {{{
+# The codepoint space is split into blocks of 256 codepoints. Each block stores 2 bits per
+# codepoint (0 = narrow, 1 = wide, 2 = ambiguous) in 8 64-bit words. s_widthIndex maps each
+# block to one of the unique blocks in s_widthBlocks, in the order they first appear.
+$blockShift = 8
+$blockSize = 1 -shl $blockShift
+$blockCount = 0x110000 -shr $blockShift
+
+$widthClasses = [byte[]]::new(0x110000)
+ForEach($_ in $ranges) {
+    $class = $_.Width -eq [CodepointWidth]::Ambiguous ? 2 : 1
+    For($cp = $_.Start; $cp -le $_.End; $cp++) {
+        $widthClasses[$cp] = $class
+    }
+}
+
+$blocks = [System.Collections.Generic.List[string]]::New()
+$blockIndices = @{}
+$index = [int[]]::new($blockCount)
+For($b = 0; $b -lt $blockCount; $b++) {
+    $words = [uint64[]]::new($blockSize * 2 / 64)
+    For($i = 0; $i -lt $blockSize; $i++) {
+        $words[$i -shr 5] = $words[$i -shr 5] -bor ([uint64]$widthClasses[($b -shl $blockShift) + $i] -shl (($i % 32) * 2))
+    }
+
+    $block = ($words | ForEach-Object { "0x{0:x16}" -f $_ }) -join ", "
+    $unique = $blockIndices[$block]
+    If ($null -eq $unique) {
+        $unique = $blocks.Count
+        $blockIndices[$block] = $unique
+        $blocks.Add($block)
+    }
+    $index[$b] = $unique
+}
+
+If ($blocks.Count -gt 256) {
+    throw "s_widthIndex can't address more than 256 unique blocks"
+}
+
+"    // s_wideAndAmbiguousTable as a two-level lookup table, see getWidthClass()."
+"    static constexpr std::array<uint8_t, {0}> s_widthIndex{{" -f $blockCount
+For($i = 0; $i -lt $blockCount; $i += 32) {
+"        {0}" -f (($index[$i..($i + 31)] | ForEach-Object { "{0,2}," -f $_ }) -join " ")
+}
+"    };"
+"    static constexpr std::array<std::array<uint64_t, 8>, {0}> s_widthBlocks{{ {{" -f $blocks.Count
+ForEach($_ in $blocks) {
+"        {{ {0} }}," -f $_
+}
+"    } };"
+# }}}